@@ -1,22 +1,97 @@
+import hashlib
+import json
+import os
+
 import dash
 from dash import dcc
 from dash import html
+from dash.exceptions import PreventUpdate
 import plotly.express as px
 import pandas as pd
 import flask
 from flask import request, redirect, url_for
 
+import datastore
+import downsample
+import ingest
+import rollup
+
 
 
 
 #Comment
 server = flask.Flask(__name__)
 
-df = pd.read_csv('weather.csv')
-df = df.drop(['Pressure3pm', 'Pressure9am'], axis=1)
+# Numeric columns are mapped from weather.arrow, converted from weather.csv
+# on first use (see datastore.py); with --preload the workers inherit df
+df = datastore.load_frame('weather.csv', drop=('Pressure3pm', 'Pressure9am'))
 pd.options.plotting.backend = "plotly"
 external_stylesheets = ['https://codepen.io/chriddyp/pen/bWLwgP.css']
 
+TIME_OPTIONS = ['9am', '3pm']
+
+# Points drawn per series at most: about one per pixel of a full-width
+# graph. Longer series are downsampled (see downsample.py), so the figure
+# stays the same size however long the history is.
+GRAPH_WIDTH_PX = int(os.environ.get('GRAPH_WIDTH_PX', 1200))
+
+
+def series_x(index):
+    # Where the points of a series lie, for downsampling: the times or
+    # numbers of the index, or else just the positions
+    if isinstance(index, pd.DatetimeIndex):
+        return index.asi8
+    if pd.api.types.is_numeric_dtype(index):
+        return index.to_numpy(dtype=float)
+    return None
+
+
+def build_figure(data, value):
+    # Columns measured at the selected time, without the (text) wind direction
+    data_filtered = data.filter(regex='{}$'.format(value), axis=1)
+    data_filtered = data_filtered.drop(['WindDir{}'.format(value)], axis=1)
+    # Long form, one downsampled piece per series; the same traces and
+    # labels as px.line of the wide frame
+    index = data_filtered.index
+    x_name = index.name or 'index'
+    x = series_x(index)
+    pieces = []
+    for column in data_filtered.columns:
+        values = data_filtered[column].to_numpy(dtype=float)
+        rows = downsample.fit(values, GRAPH_WIDTH_PX, x)
+        pieces.append(pd.DataFrame({x_name: index[rows], 'value': values[rows], 'variable': column}))
+    fig = px.line(pd.concat(pieces, ignore_index=True), x=x_name, y='value', color='variable')
+    fig.update_layout()
+    return fig
+
+
+# Figures of every dropdown value, built once per version of the data.
+# Entries hold the figure in its JSON form (plain lists instead of numpy
+# arrays), so the callback is a dict lookup and Dash encodes it quickly.
+figure_cache = {}
+data_version = None
+
+
+def figure_key(version, value):
+    return 'figure:{}:{}'.format(version, value)
+
+
+def refresh_figures(data):
+    """Rebuild the cached figures; call this whenever df changes."""
+    global data_version
+    version = hashlib.sha1(pd.util.hash_pandas_object(data, index=True).values).hexdigest()[:12]
+    figures = {figure_key(version, value): json.loads(build_figure(data, value).to_json())
+               for value in TIME_OPTIONS}
+    # New entries go in before the version moves, so a callback running
+    # meanwhile always finds the figures of one version or the other
+    figure_cache.update(figures)
+    data_version = version
+    for key in [key for key in figure_cache if key not in figures]:
+        del figure_cache[key]
+
+
+refresh_figures(df)
+
 app = dash.Dash(__name__, external_stylesheets=external_stylesheets, server=server)
 
 
@@ -24,7 +99,7 @@ layout_page_1 = html.Div([
     html.H2('Weather App prototype Joachim test'),
     dcc.Dropdown(
         id='dropdown-time',
-        options=[{'label': i, 'value': i} for i in ['9am', '3pm']],
+        options=[{'label': i, 'value': i} for i in TIME_OPTIONS],
         value='9am'
     ),
     dcc.Graph(id='display-value')
@@ -48,6 +123,50 @@ def post():
     return "post gets here"
 
 
+# Batched samples of many devices per request, see ingest.py. Answers once
+# the samples are on disk.
+ingest_log = ingest.IngestLog(os.environ.get('INGEST_DIR', 'ingest_log'))
+
+
+@server.route('/ingest', methods=['POST'])
+def ingest_samples():
+    try:
+        batch = ingest.parse_body(request.content_type, request.get_data())
+    except ValueError as error:
+        return {'error': str(error)}, 400
+    ingest_log.append(batch)
+    rollups.follow_every(ingest_log.directory, ROLLUP_FOLLOW_S)
+    return {'accepted': len(batch)}
+
+
+# Min, max, mean, variance and count per metric in 1 minute, 1 hour and 1
+# day buckets, kept up to date from the ingest log of all workers by a
+# background thread, and by every query
+rollups = rollup.Rollup()
+ROLLUP_FOLLOW_S = 1.0
+RESOLUTIONS = {'minute': rollup.MINUTE, 'hour': rollup.HOUR, 'day': rollup.DAY}
+
+
+@server.route('/rollup')
+def rollup_query():
+    # /rollup?metric=Temp9am&start=<us>&end=<us>[&resolution=hour]
+    try:
+        metric = request.args['metric']
+        if metric not in ingest.METRIC_IDS:
+            raise ValueError('unknown metric {!r}'.format(metric))
+        start, end = int(request.args['start']), int(request.args['end'])
+        resolution = request.args.get('resolution')
+        if resolution is not None and resolution not in RESOLUTIONS:
+            raise ValueError('resolution is one of {}'.format(', '.join(RESOLUTIONS)))
+    except (KeyError, ValueError) as error:
+        return {'error': str(error)}, 400
+    rollups.follow_every(ingest_log.directory, ROLLUP_FOLLOW_S)
+    rollups.follow(ingest_log.directory)
+    if resolution is not None:
+        return {'buckets': rollups.series(metric, RESOLUTIONS[resolution], start, end)}
+    return rollups.query(metric, start, end)
+
+
 if __name__ == '__main__':
    app.run(debug = True)
 
@@ -58,12 +177,12 @@ if __name__ == '__main__':
 @app.callback(dash.dependencies.Output('display-value', 'figure'),
                 [dash.dependencies.Input('dropdown-time', 'value')])
 def display_value(value):
-    # Next 2 lines are for data filtering, next 2 are for updating the graph
-    df_filtered = df.filter(regex='{}$'.format(value), axis=1)
-    df_filtered = df_filtered.drop(['WindDir{}'.format(value)], axis=1)
-    fig = px.line(df_filtered)
-    fig.update_layout()
-    return fig
+    # The figures are prebuilt by refresh_figures(); an unknown value
+    # leaves the graph as it is
+    figure = figure_cache.get(figure_key(data_version, value))
+    if figure is None:
+        raise PreventUpdate
+    return figure
 
 
 if __name__ == '__main__':
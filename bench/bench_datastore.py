@@ -0,0 +1,90 @@
+"""Cold-start time and per-worker memory of loading the weather data, from
+the CSV with pandas and from the memory-mapped Arrow copy (datastore.py).
+
+weather.csv is repeated up to each row count. Every load runs in a fresh
+interpreter, like the gunicorn master loading the app with --preload, or a
+worker loading it without; the page cache stays warm, as on a restart.
+Memory is split as Linux reports it: private (RssAnon) and file-backed
+(RssFile), which includes the interpreter and its libraries. Workers forked
+with --preload share the master's private pages copy-on-write as well.
+
+    python bench/bench_datastore.py [--rows 366,10000,100000,1000000,10000000]
+"""
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+sys.path.insert(0, ROOT)
+
+import datastore  # noqa: E402
+
+DROP = ('Pressure3pm', 'Pressure9am')
+
+# Run in a child interpreter: load the data, then report time and memory
+LOADER = r'''
+import json, sys, time
+start = time.perf_counter()
+sys.path.insert(0, {root!r})
+mode, path, drop = sys.argv[1], sys.argv[2], tuple(sys.argv[3].split(','))
+if mode == 'csv':
+    import pandas as pd
+    df = pd.read_csv(path).drop(list(drop), axis=1)
+else:
+    import datastore
+    df = datastore.load_frame(path, drop=drop)
+elapsed = time.perf_counter() - start
+status = dict(line.split(':', 1) for line in open('/proc/self/status'))
+kb = lambda key: int(status.get(key, '0 kB').split()[0])
+print(json.dumps({{'rows': len(df), 'seconds': elapsed,
+                   'anon_mb': kb('RssAnon') / 1024, 'file_mb': kb('RssFile') / 1024}}))
+'''
+
+
+def make_csv(path, rows, source=os.path.join(ROOT, 'weather.csv')):
+    with open(source) as file:
+        header = file.readline()
+        lines = file.readlines()
+    with open(path, 'w') as file:
+        file.write(header)
+        for start in range(0, rows, len(lines)):
+            file.writelines(lines[:min(len(lines), rows - start)])
+
+
+def load(mode, path):
+    output = subprocess.run([sys.executable, '-c', LOADER.format(root=ROOT), mode, path, ','.join(DROP)],
+                            check=True, capture_output=True, text=True).stdout
+    return json.loads(output)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--rows', default='366,10000,100000,1000000,10000000',
+                        help='comma-separated row counts')
+    args = parser.parse_args()
+
+    print('{:>10} {:>8} {:>10} {:>10} {:>10} {:>12}'.format(
+        'rows', 'source', 'start s', 'private MB', 'shared MB', 'convert s'))
+    with tempfile.TemporaryDirectory() as tmp:
+        for rows in [int(count) for count in args.rows.split(',')]:
+            csv_path = os.path.join(tmp, 'weather_{}.csv'.format(rows))
+            make_csv(csv_path, rows)
+            start = time.perf_counter()
+            datastore.convert(csv_path)
+            convert_s = time.perf_counter() - start
+
+            for mode in ('csv', 'arrow'):
+                result = load(mode, csv_path)
+                print('{:>10} {:>8} {:>10.3f} {:>10.1f} {:>10.1f} {:>12}'.format(
+                    result['rows'], mode, result['seconds'], result['anon_mb'], result['file_mb'],
+                    '{:.3f}'.format(convert_s) if mode == 'arrow' else ''))
+            os.unlink(csv_path)
+            os.unlink(datastore.arrow_path(csv_path))
+
+
+if __name__ == '__main__':
+    main()
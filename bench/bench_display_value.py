@@ -0,0 +1,58 @@
+"""Latency of the display_value callback, before and after the figure cache.
+
+"before" builds the figure on every call, as display_value did; "after" is
+the cached lookup. Both include the JSON encoding Dash applies to the
+callback output. Run from the repository root:
+
+    python bench/bench_display_value.py [--calls 200]
+"""
+import argparse
+import os
+import statistics
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+
+from plotly.io.json import to_json_plotly  # noqa: E402
+
+import app  # noqa: E402
+
+
+def measure(callback, calls):
+    samples = []
+    for i in range(calls):
+        value = app.TIME_OPTIONS[i % len(app.TIME_OPTIONS)]
+        start = time.perf_counter()
+        to_json_plotly(callback(value))
+        samples.append((time.perf_counter() - start) * 1e3)
+    samples.sort()
+    return {
+        'mean': statistics.mean(samples),
+        'p50': samples[len(samples) // 2],
+        'p99': samples[min(len(samples) - 1, int(len(samples) * 0.99))],
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--calls', type=int, default=200)
+    args = parser.parse_args()
+
+    start = time.perf_counter()
+    app.refresh_figures(app.df)
+    print('refresh_figures: {:.1f} ms for {} figures'.format(
+        (time.perf_counter() - start) * 1e3, len(app.TIME_OPTIONS)))
+
+    results = {
+        'before': measure(lambda value: app.build_figure(app.df, value), args.calls),
+        # The function under the Dash callback decorator
+        'after': measure(app.display_value.__wrapped__, args.calls),
+    }
+    for name, result in results.items():
+        print('{:6s} mean {mean:8.3f} ms  p50 {p50:8.3f} ms  p99 {p99:8.3f} ms'.format(name, **result))
+    print('speed-up (mean): {:.0f}x'.format(results['before']['mean'] / results['after']['mean']))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,68 @@
+"""Time of downsampling one long series to the graph width (downsample.py)
+and the size and encoding time of the figure sent to the browser, against
+sending every point.
+
+The series is a random walk with noise and spikes, like sensor data. The
+full figure is only built up to --raw-limit points; at 100M points its
+JSON would take gigabytes.
+
+    python bench/bench_downsample.py [--points 1000000,100000000] [--width 1200]
+"""
+import argparse
+import os
+import sys
+import time
+
+import numpy as np
+import plotly.graph_objects as go
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+sys.path.insert(0, ROOT)
+
+import downsample  # noqa: E402
+
+
+def make_series(points, rng):
+    y = np.cumsum(rng.normal(0.0, 0.01, points))
+    y += rng.normal(0.0, 0.1, points)
+    spikes = rng.integers(0, points, max(1, points // 100000))
+    y[spikes] += rng.choice([-5.0, 5.0], len(spikes))
+    return y
+
+
+def figure_json(x, y):
+    """Seconds to encode a one-trace figure, and its size in bytes."""
+    start = time.perf_counter()
+    size = len(go.Figure(go.Scattergl(x=x, y=y, mode='lines')).to_json())
+    return time.perf_counter() - start, size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--points', default='1000000,100000000', help='comma-separated series lengths')
+    parser.add_argument('--width', type=int, default=1200, help='graph width in pixels')
+    parser.add_argument('--raw-limit', type=int, default=1000000,
+                        help='longest series also sent whole, for comparison')
+    args = parser.parse_args()
+
+    rng = np.random.default_rng(0)
+    print('{:>12} {:>8} {:>8} {:>12} {:>12} {:>12}'.format(
+        'points', 'method', 'kept', 'downsample s', 'encode s', 'JSON bytes'))
+    for points in [int(count) for count in args.points.split(',')]:
+        y = make_series(points, rng)
+        if points <= args.raw_limit:
+            encode_s, size = figure_json(np.arange(points), y)
+            print('{:>12,} {:>8} {:>8,} {:>12} {:>12.3f} {:>12,}'.format(
+                points, 'none', points, '', encode_s, size))
+        for method in ('lttb', 'minmax'):
+            start = time.perf_counter()
+            rows = downsample.fit(y, args.width, method=method)
+            downsample_s = time.perf_counter() - start
+            encode_s, size = figure_json(rows, y[rows])
+            print('{:>12,} {:>8} {:>8,} {:>12.3f} {:>12.3f} {:>12,}'.format(
+                points, method, len(rows), downsample_s, encode_s, size))
+        del y
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,75 @@
+"""Ingest throughput of the rolling aggregates (rollup.py) and the time of a
+one-day query as history grows, against scanning the raw samples with
+pandas.
+
+Samples are random values of all metrics, spread evenly over the history;
+they are held in memory, about 50 bytes each with the pandas copy.
+
+    python bench/bench_rollup.py [--days 1,3,7] [--rate 100]
+"""
+import argparse
+import os
+import sys
+import time
+
+import numpy as np
+import pandas as pd
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+sys.path.insert(0, ROOT)
+
+import ingest  # noqa: E402
+import rollup  # noqa: E402
+
+BATCH = 10000
+REPEAT = 1000
+
+
+def timed(function, repeat=REPEAT):
+    start = time.perf_counter()
+    for _ in range(repeat):
+        result = function()
+    return (time.perf_counter() - start) / repeat, result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--days', default='1,3,7', help='comma-separated history lengths')
+    parser.add_argument('--rate', type=float, default=100.0, help='samples per second in total')
+    args = parser.parse_args()
+
+    rng = np.random.default_rng(0)
+    origin = 1600000000 * 1000000
+    print('{:>6} {:>12} {:>14} {:>14} {:>14}'.format(
+        'days', 'samples', 'ingest /s', 'rollup ms', 'pandas ms'))
+    for days in [int(count) for count in args.days.split(',')]:
+        count = int(days * 86400 * args.rate)
+        timestamps = origin + np.arange(count, dtype=np.int64) * int(1e6 / args.rate)
+        metrics = rng.integers(0, len(ingest.METRICS), count, dtype=np.uint16)
+        values = rng.normal(20.0, 5.0, count)
+
+        rollups = rollup.Rollup()
+        start = time.perf_counter()
+        for offset in range(0, count, BATCH):
+            rollups.add(timestamps[offset:offset + BATCH], metrics[offset:offset + BATCH],
+                        values[offset:offset + BATCH])
+        ingest_rate = count / (time.perf_counter() - start)
+
+        # The last day but 90 minutes, as a dashboard would ask for it
+        end = int(timestamps[-1]) - 45 * rollup.MINUTE
+        begin = end - rollup.DAY + 90 * rollup.MINUTE
+        metric = ingest.METRIC_IDS['Temp9am']
+        rollup_s, result = timed(lambda: rollups.query(metric, begin, end))
+
+        frame = pd.DataFrame({'t': timestamps, 'metric': metrics, 'value': values})
+        scan_s, scanned = timed(lambda: frame.loc[
+            (frame['metric'] == metric) & (frame['t'] >= result['start']) & (frame['t'] < result['end']),
+            'value'].agg(['count', 'mean', 'var', 'min', 'max']), repeat=3)
+        assert result['count'] == scanned['count'] and np.isclose(result['variance'], scanned['var'])
+
+        print('{:>6} {:>12,} {:>14,.0f} {:>14.3f} {:>14.3f}'.format(
+            days, count, ingest_rate, rollup_s * 1e3, scan_s * 1e3))
+
+
+if __name__ == '__main__':
+    main()
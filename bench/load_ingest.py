@@ -0,0 +1,155 @@
+"""Load test of the /ingest endpoint: a fleet of devices sampling at a fixed
+rate, whose samples are batched per connection like behind a gateway.
+
+Each connection owns a share of the devices and, every --interval seconds,
+posts one request with all samples its devices produced since its last
+request. A slow server therefore gets larger requests, not fewer samples:
+the offered load stays at devices x rate. Reports the sustained rate of
+acknowledged samples and the request latency percentiles.
+
+    python bench/load_ingest.py --serve --devices 1000 --rate 100
+    python bench/load_ingest.py --url http://host:8000/ingest --format ndjson
+"""
+import argparse
+import http.client
+import json
+import os
+import statistics
+import struct
+import sys
+import threading
+import time
+import urllib.parse
+from array import array
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+sys.path.insert(0, ROOT)
+
+import ingest  # noqa: E402
+
+
+def binary_body(devices, start_us, count, period_us):
+    frames = []
+    timestamps = array('q', range(start_us, start_us + count * period_us, period_us)).tobytes()
+    for device in devices:
+        values = array('d', [20.0 + device % 10] * count).tobytes()
+        payload = ingest.FRAME_HEADER.pack(device, device % len(ingest.METRICS), count) + \
+            timestamps + values
+        frames.append(struct.pack('<I', len(payload)))
+        frames.append(payload)
+    return b''.join(frames), ingest.BINARY_TYPE
+
+
+def ndjson_body(devices, start_us, count, period_us):
+    timestamps = list(range(start_us, start_us + count * period_us, period_us))
+    lines = [json.dumps({'device': device, 'metric': device % len(ingest.METRICS),
+                         't': timestamps, 'v': [20.0 + device % 10] * count})
+             for device in devices]
+    return ('\n'.join(lines) + '\n').encode(), ingest.NDJSON_TYPE
+
+
+class Connection(threading.Thread):
+    def __init__(self, url, devices, args, stop):
+        super().__init__(daemon=True)
+        self.url = url
+        self.devices = devices
+        self.args = args
+        self.stop = stop
+        self.latencies = []
+        self.samples = 0
+        self.errors = 0
+        self.encode = binary_body if args.format == 'binary' else ndjson_body
+
+    def run(self):
+        period_us = int(1e6 / self.args.rate)
+        connection = http.client.HTTPConnection(self.url.hostname, self.url.port or 80, timeout=30)
+        start = time.time()
+        sent_us = int(start * 1e6)
+        deadline = time.monotonic()
+        while not self.stop.is_set():
+            deadline += self.args.interval
+            delay = deadline - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            # All samples due since the last request
+            count = (int(time.time() * 1e6) - sent_us) // period_us
+            if count <= 0 or not self.devices:
+                continue
+            body, content_type = self.encode(self.devices, sent_us, count, period_us)
+            sent_us += count * period_us
+
+            begin = time.perf_counter()
+            try:
+                connection.request('POST', self.url.path or '/ingest', body,
+                                   {'Content-Type': content_type})
+                response = connection.getresponse()
+                reply = response.read()
+            except (OSError, http.client.HTTPException):
+                self.errors += 1
+                connection.close()
+                continue
+            self.latencies.append(time.perf_counter() - begin)
+            if response.status == 200:
+                self.samples += json.loads(reply)['accepted']
+            else:
+                self.errors += 1
+
+
+def serve(url):
+    """Runs the app of app.py in this process, on the port of url."""
+    from werkzeug.serving import make_server
+    import app
+
+    server = make_server(url.hostname, url.port, app.server, threaded=True)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server
+
+
+def percentile(samples, fraction):
+    return samples[min(len(samples) - 1, int(len(samples) * fraction))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--url', default='http://127.0.0.1:8050/ingest')
+    parser.add_argument('--serve', action='store_true', help='start the app in this process first')
+    parser.add_argument('--devices', type=int, default=1000)
+    parser.add_argument('--rate', type=float, default=100.0, help='samples per second per device')
+    parser.add_argument('--interval', type=float, default=0.1, help='seconds between requests')
+    parser.add_argument('--connections', type=int, default=16)
+    parser.add_argument('--duration', type=float, default=10.0)
+    parser.add_argument('--format', choices=('binary', 'ndjson'), default='binary')
+    args = parser.parse_args()
+
+    url = urllib.parse.urlsplit(args.url)
+    if args.serve:
+        serve(url)
+
+    stop = threading.Event()
+    devices = list(range(args.devices))
+    connections = [Connection(url, devices[i::args.connections], args, stop)
+                   for i in range(args.connections)]
+    start = time.monotonic()
+    for connection in connections:
+        connection.start()
+    time.sleep(args.duration)
+    stop.set()
+    for connection in connections:
+        connection.join()
+    elapsed = time.monotonic() - start
+
+    latencies = sorted(latency for connection in connections for latency in connection.latencies)
+    samples = sum(connection.samples for connection in connections)
+    errors = sum(connection.errors for connection in connections)
+    print('offered    {:12,.0f} samples/s ({} devices at {:g} Hz, {} connections, {})'.format(
+        args.devices * args.rate, args.devices, args.rate, args.connections, args.format))
+    print('sustained  {:12,.0f} samples/s over {:.1f} s, {} requests, {} errors'.format(
+        samples / elapsed, elapsed, len(latencies), errors))
+    if latencies:
+        print('latency    p50 {:.1f} ms  p99 {:.1f} ms  max {:.1f} ms  mean {:.1f} ms'.format(
+            percentile(latencies, 0.5) * 1e3, percentile(latencies, 0.99) * 1e3,
+            latencies[-1] * 1e3, statistics.mean(latencies) * 1e3))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,138 @@
+"""Columnar, memory-mapped copy of weather.csv.
+
+The CSV is converted once into an uncompressed Arrow IPC file next to it
+(weather.arrow). A process loading the data maps that file instead of
+parsing the CSV, so start-up no longer parses text. The numeric columns
+are views of the mapped file, clean page-cache pages rather than private
+memory; string columns are converted to Python objects.
+
+pandas copies a column that spans several record batches, or that has a
+null bitmap, so the file holds a single record batch, and numeric columns
+with missing values (Sunshine, WindGustSpeed and WindSpeed9am in
+weather.csv) are stored as float64 with NaN, the dtype pandas.read_csv
+gives them.
+
+With gunicorn --preload (see Procfile) the master loads the frame before
+forking, so the workers share it copy-on-write whatever it was loaded
+from; the mapping shortens that load and keeps the numeric columns out of
+the master's private memory. Processes that load the data on their own,
+like workers without --preload, share the mapped pages through the page
+cache.
+
+The Arrow file footer is the column index: it holds the offset of every
+column buffer, so loading a subset of columns touches only their pages.
+
+Convert ahead of time (e.g. in the release phase, see Procfile):
+
+    python datastore.py weather.csv
+"""
+import os
+import sys
+import tempfile
+
+import pyarrow as pa
+import pyarrow.csv
+import pyarrow.ipc
+
+def arrow_path(csv_path):
+    return os.path.splitext(csv_path)[0] + '.arrow'
+
+
+def write_file(path, schema, batches):
+    """Write record batches as an Arrow IPC file under a temporary name and
+    rename it into place, so a worker never maps a partly written file."""
+    fd, tmp_path = tempfile.mkstemp(dir=os.path.dirname(os.path.abspath(path)), suffix='.tmp')
+    try:
+        with os.fdopen(fd, 'wb') as sink:
+            with pyarrow.ipc.new_file(sink, schema) as writer:
+                for batch in batches:
+                    writer.write_batch(batch)
+        os.replace(tmp_path, path)
+    except BaseException:
+        os.unlink(tmp_path)
+        raise
+
+
+def without_nulls(table, schema):
+    """The table cast to schema, with the nulls of its float columns
+    replaced by NaN."""
+    columns = [column.cast(field.type).fill_null(float('nan'))
+               if pa.types.is_floating(field.type) and column.null_count else
+               column.cast(field.type)
+               for column, field in zip(table.columns, schema)]
+    return pa.Table.from_arrays(columns, schema=schema)
+
+
+def convert(csv_path, path=None):
+    """Write the CSV as an Arrow IPC file of a single record batch.
+
+    The CSV is streamed into a temporary Arrow file one block at a time,
+    then read back and written as one batch, with the numeric columns that
+    have missing values as float64 without nulls; which columns those are
+    is only known once the whole CSV is read. Building the batch holds the
+    columns in memory once, as pandas.read_csv would.
+    """
+    path = path or arrow_path(csv_path)
+    reader = pyarrow.csv.open_csv(csv_path, read_options=pyarrow.csv.ReadOptions(
+        block_size=64 << 20))
+    with_nulls = set()
+
+    def csv_batches():
+        for batch in reader:
+            with_nulls.update(name for name, column in zip(batch.schema.names, batch.columns)
+                              if column.null_count)
+            yield batch
+
+    # Named per call: processes that find the Arrow copy missing convert
+    # it at the same time
+    fd, raw_path = tempfile.mkstemp(dir=os.path.dirname(os.path.abspath(path)), suffix='.raw.tmp')
+    os.close(fd)
+    try:
+        write_file(raw_path, reader.schema, csv_batches())
+        schema = reader.schema
+        for index, field in enumerate(schema):
+            if field.name in with_nulls and (pa.types.is_integer(field.type) or
+                                             pa.types.is_floating(field.type)):
+                schema = schema.set(index, pa.field(field.name, pa.float64()))
+
+        with pa.memory_map(raw_path, 'r') as source:
+            table = without_nulls(pyarrow.ipc.open_file(source).read_all(), schema)
+            write_file(path, schema, table.combine_chunks().to_batches(max_chunksize=None))
+    finally:
+        os.unlink(raw_path)
+    return path
+
+
+def is_current(csv_path, path=None):
+    path = path or arrow_path(csv_path)
+    return os.path.exists(path) and os.path.getmtime(path) >= os.path.getmtime(csv_path)
+
+
+def open_table(csv_path, columns=None):
+    """Memory-map the Arrow copy of csv_path, converting it first if it is
+    missing or older than the CSV. Only the given columns are read."""
+    path = arrow_path(csv_path)
+    if not is_current(csv_path, path):
+        convert(csv_path, path)
+    table = pyarrow.ipc.open_file(pa.memory_map(path, 'r')).read_all()
+    if columns is not None:
+        table = table.select(columns)
+    return table
+
+
+def load_frame(csv_path, drop=()):
+    """DataFrame over the memory-mapped columns of csv_path, without the
+    columns in drop, which are never read.
+
+    split_blocks keeps each column in its own block, so the numeric
+    columns, which convert() stores in one batch without nulls, are views
+    of the mapped file rather than copies.
+    """
+    table = open_table(csv_path)
+    table = table.select([name for name in table.column_names if name not in drop])
+    return table.to_pandas(split_blocks=True)
+
+
+if __name__ == '__main__':
+    for csv in sys.argv[1:] or ['weather.csv']:
+        print('{} -> {}'.format(csv, convert(csv)))
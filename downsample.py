@@ -0,0 +1,93 @@
+"""Downsampling of long series to about as many points as the graph has
+pixels, so the figure sent to the browser stays the same size however
+long the history is.
+
+lttb() is Largest-Triangle-Three-Buckets (Steinarsson, 2013): the points
+between the first and the last are split into equal buckets and from each
+the point forming the largest triangle with the point kept from the
+previous bucket and the mean of the next bucket is kept. It keeps the
+shape of a line, peaks included. The choice in a bucket depends on the one
+before, so buckets are visited in a loop, but all the work inside a bucket
+(and the bucket means) is numpy: the loop runs once per output point, not
+per input point.
+
+minmax() keeps the lowest and the highest point of each bucket; it is
+fully vectorized and shows the exact envelope of noisy data, at twice the
+points.
+
+Both return the indices of the points kept, in order, so the caller takes
+x and y (or any other column) of the same rows.
+"""
+import numpy as np
+
+
+def lttb(y, threshold, x=None):
+    """Indices of the threshold points of y that LTTB keeps; all of them if
+    y is not longer. x defaults to the positions. y must not hold NaN."""
+    n = len(y)
+    if threshold >= n or threshold < 3:
+        return np.arange(n)
+    y = np.asarray(y, dtype=np.float64)
+    # Buckets [edges[i], edges[i + 1]) over the points between the first
+    # and the last; n > threshold keeps them at least one point wide
+    edges = np.linspace(1, n - 1, threshold - 1).astype(np.int64)
+    sizes = np.diff(edges)
+    mean_y = np.add.reduceat(y[:n - 1], edges[:-1]) / sizes
+    if x is None:
+        mean_x = (edges[:-1] + edges[1:] - 1) / 2.0
+    else:
+        x = np.asarray(x, dtype=np.float64)
+        mean_x = np.add.reduceat(x[:n - 1], edges[:-1]) / sizes
+    # The bucket after the last one is the last point
+    mean_x = np.r_[mean_x, n - 1 if x is None else x[n - 1]]
+    mean_y = np.r_[mean_y, y[n - 1]]
+
+    kept = np.empty(threshold, dtype=np.int64)
+    kept[0], kept[-1] = 0, n - 1
+    a = 0
+    for bucket in range(threshold - 2):
+        low, high = edges[bucket], edges[bucket + 1]
+        ax = a if x is None else x[a]
+        bx = np.arange(low, high) if x is None else x[low:high]
+        cx, cy = mean_x[bucket + 1], mean_y[bucket + 1]
+        # Twice the triangle area; the factor does not change the argmax
+        area = np.abs((ax - cx) * (y[low:high] - y[a]) - (ax - bx) * (cy - y[a]))
+        a = low + int(np.argmax(area))
+        kept[bucket + 1] = a
+    return kept
+
+
+def minmax(y, buckets):
+    """Indices of the lowest and highest point of each of about buckets
+    equal buckets of y, in order; all of them if y has no more than
+    2 * buckets points. y must not hold NaN."""
+    n = len(y)
+    if n <= 2 * buckets or buckets < 1:
+        return np.arange(n)
+    y = np.asarray(y)
+    size = n // buckets
+    whole = y[:size * buckets].reshape(buckets, size)
+    starts = np.arange(buckets) * size
+    kept = [starts + whole.argmin(axis=1), starts + whole.argmax(axis=1)]
+    if size * buckets < n:
+        tail = y[size * buckets:]
+        kept.append(size * buckets + np.array([tail.argmin(), tail.argmax()]))
+    return np.unique(np.concatenate(kept))
+
+
+def fit(y, width, x=None, method='lttb'):
+    """Indices of the points of y to draw on width pixels. NaN points are
+    left out once the series is downsampled; a series that fits is kept
+    whole, gaps included."""
+    y = np.asarray(y, dtype=np.float64)
+    limit = width if method == 'lttb' else 2 * width
+    if len(y) <= limit:
+        return np.arange(len(y))
+    valid = np.flatnonzero(~np.isnan(y))
+    if len(valid) < len(y):
+        y = y[valid]
+        x = valid if x is None else np.asarray(x)[valid]
+    else:
+        valid = None
+    kept = lttb(y, width, x) if method == 'lttb' else minmax(y, width)
+    return kept if valid is None else valid[kept]
@@ -0,0 +1,311 @@
+"""Batched ingest of timestamped samples into an append-only columnar log.
+
+A request carries many samples, either as binary frames or as
+newline-delimited JSON (see parse_frames and parse_ndjson). Samples are
+appended to the log in blocks; each block stores its samples column by
+column (timestamps, devices, metrics, values) behind a header with a
+CRC32, so a block torn by a crash is detected and the log is read up to it.
+
+Writes use group commit: requests hand their samples to one writer thread
+and wait. The writer takes everything that arrived while the previous
+fsync ran, writes it as one block and fsyncs once, then releases all of
+those requests. Under load a single fsync covers many requests; an idle
+log commits a lone request right away.
+
+Each process writes its own segment files, so gunicorn workers never
+share a file; read_log merges all segments of a directory. After a failed
+write the torn block is truncated away, and after a failed fsync the
+writer moves on to a new segment, so the blocks of later commits never sit
+behind a torn one, where readers would not reach them.
+"""
+import json
+import os
+import struct
+import sys
+import threading
+import time
+import zlib
+from array import array
+
+# Numeric columns of weather.csv; a sample's metric is its index here
+METRICS = ['MinTemp', 'MaxTemp', 'Rainfall', 'Evaporation', 'Sunshine', 'WindGustSpeed',
+           'WindSpeed9am', 'WindSpeed3pm', 'Humidity9am', 'Humidity3pm', 'Cloud9am', 'Cloud3pm',
+           'Temp9am', 'Temp3pm']
+METRIC_IDS = {name: index for index, name in enumerate(METRICS)}
+
+# Binary frame: uint32 payload length, then the payload: uint32 device,
+# uint16 metric, uint32 count, int64 timestamps[count] (microseconds since
+# the epoch), float64 values[count]. All little-endian.
+FRAME_LENGTH = struct.Struct('<I')
+FRAME_HEADER = struct.Struct('<IHI')
+BINARY_TYPE = 'application/octet-stream'
+NDJSON_TYPE = 'application/x-ndjson'
+
+# Log block: magic, sample count, payload bytes, CRC32 of the payload
+BLOCK_HEADER = struct.Struct('<4sIII')
+BLOCK_MAGIC = b'SMPL'
+
+# Array type codes of the columns, in their order in a block
+COLUMNS = (('timestamps', 'q'), ('devices', 'I'), ('metrics', 'H'), ('values', 'd'))
+if array('I').itemsize != 4:
+    raise ImportError('ingest needs a platform with 32-bit unsigned int arrays')
+
+SEGMENT_BYTES = 64 << 20
+
+
+def _column(typecode, data=b''):
+    column = array(typecode)
+    column.frombytes(data)
+    if sys.byteorder != 'little':
+        column.byteswap()
+    return column
+
+
+def _column_bytes(column):
+    if sys.byteorder != 'little':
+        column = array(column.typecode, column)
+        column.byteswap()
+    return column.tobytes()
+
+
+class Batch:
+    """Samples of one request, column by column."""
+
+    def __init__(self):
+        self.timestamps = array('q')
+        self.devices = array('I')
+        self.metrics = array('H')
+        self.values = array('d')
+
+    def __len__(self):
+        return len(self.timestamps)
+
+    def add(self, device, metric, timestamps, values):
+        if len(timestamps) != len(values):
+            raise ValueError('{} timestamps for {} values'.format(len(timestamps), len(values)))
+        if not 0 <= metric < len(METRICS):
+            raise ValueError('unknown metric {}'.format(metric))
+        self.timestamps.extend(timestamps)
+        self.devices.extend([device] * len(values))
+        self.metrics.extend([metric] * len(values))
+        self.values.extend(values)
+
+
+def parse_frames(body):
+    batch = Batch()
+    view = memoryview(body)
+    offset = 0
+    while offset < len(view):
+        if offset + FRAME_LENGTH.size > len(view):
+            raise ValueError('truncated frame length at byte {}'.format(offset))
+        (length,) = FRAME_LENGTH.unpack_from(view, offset)
+        offset += FRAME_LENGTH.size
+        if length < FRAME_HEADER.size or offset + length > len(view):
+            raise ValueError('bad frame length {} at byte {}'.format(length, offset))
+        device, metric, count = FRAME_HEADER.unpack_from(view, offset)
+        if length != FRAME_HEADER.size + count * 16:
+            raise ValueError('frame of {} bytes holds {} samples'.format(length, count))
+        start = offset + FRAME_HEADER.size
+        batch.add(device, metric,
+                  _column('q', view[start:start + count * 8]),
+                  _column('d', view[start + count * 8:offset + length]))
+        offset += length
+    return batch
+
+
+def parse_ndjson(body):
+    """One object per line: {"device": 7, "metric": "Temp9am" or 12,
+    "t": microseconds or [...], "v": value or [...]}."""
+    batch = Batch()
+    for number, line in enumerate(body.splitlines(), 1):
+        if not line.strip():
+            continue
+        try:
+            record = json.loads(line)
+            metric = record['metric']
+            metric = METRIC_IDS[metric] if isinstance(metric, str) else int(metric)
+            timestamps, values = record['t'], record['v']
+            if not isinstance(values, list):
+                timestamps, values = [timestamps], [values]
+            batch.add(int(record['device']), metric, [int(t) for t in timestamps],
+                      [float(v) for v in values])
+        except (KeyError, TypeError, ValueError, OverflowError) as error:
+            # OverflowError: a device or timestamp out of its column's range
+            raise ValueError('line {}: {}'.format(number, error)) from None
+    return batch
+
+
+def parse_body(content_type, body):
+    content_type = (content_type or '').split(';')[0].strip()
+    if content_type == BINARY_TYPE:
+        return parse_frames(body)
+    if content_type == NDJSON_TYPE:
+        return parse_ndjson(body)
+    raise ValueError('unsupported content type {!r}'.format(content_type))
+
+
+class IngestLog:
+    """Append-only log of sample blocks with group-commit fsync."""
+
+    def __init__(self, directory, segment_bytes=SEGMENT_BYTES):
+        self.directory = directory
+        self.segment_bytes = segment_bytes
+        self._lock = threading.Lock()
+        self._wake = threading.Condition(self._lock)
+        self._done = threading.Condition(self._lock)
+        self._pid = None
+        self.commits = 0
+        self.samples = 0
+
+    def _start(self):
+        # Per process: with gunicorn --preload the log is created before the
+        # workers fork, and threads do not survive a fork
+        self._pid = os.getpid()
+        self._pending = []
+        self._next = 1          # Commit the pending batches go into
+        self._committed = 0     # Last durable commit
+        self._errors = {}
+        self._fd = None         # Segment being written
+        self._size = 0          # End of its last durable block
+        self._torn = False      # A block is being written behind it
+        os.makedirs(self.directory, exist_ok=True)
+        threading.Thread(target=self._writer, name='ingest-writer', daemon=True).start()
+
+    def append(self, batch):
+        """Returns once the batch is on disk; raises OSError if the write
+        or the fsync failed."""
+        if not len(batch):
+            return
+        with self._lock:
+            if self._pid != os.getpid():
+                self._start()
+            self._pending.append(batch)
+            commit = self._next
+            self._wake.notify()
+            while self._committed < commit:
+                self._done.wait()
+            error = self._errors.get(commit)
+        if error is not None:
+            raise error
+
+    def _open_segment(self):
+        self._close_segment()
+        name = 'segment-{}-{}.log'.format(self._pid, time.time_ns())
+        self._fd = os.open(os.path.join(self.directory, name),
+                           os.O_WRONLY | os.O_CREAT | os.O_APPEND, 0o644)
+        self._size = 0
+        # The new entry of the directory must be durable too, before the
+        # first commit of the segment is acknowledged
+        directory = os.open(self.directory, os.O_RDONLY)
+        try:
+            os.fsync(directory)
+        finally:
+            os.close(directory)
+
+    def _close_segment(self):
+        if self._fd is not None:
+            fd, self._fd = self._fd, None
+            try:
+                os.close(fd)
+            except OSError:
+                pass
+
+    def _discard_partial(self):
+        # Readers stop at a torn block, so no later commit may follow one.
+        # A torn write is cut off. A complete block whose fsync failed may
+        # already have been read by rollup.follow, so it stays, and the
+        # next commit starts a new segment, as it does when the cut fails.
+        if self._fd is None:
+            return
+        if self._torn:
+            try:
+                os.ftruncate(self._fd, self._size)
+                os.fdatasync(self._fd)
+                return
+            except OSError:
+                pass
+        self._close_segment()
+
+    def _writer(self):
+        while True:
+            with self._lock:
+                while not self._pending:
+                    self._wake.wait()
+                batches, self._pending = self._pending, []
+                commit = self._next
+                self._next += 1
+            error = None
+            try:
+                self._write(batches)
+            except OSError as exc:
+                error = exc
+                self._discard_partial()
+            with self._lock:
+                if error is not None:
+                    # Every request of the commit sees the error; a few
+                    # recent ones are kept for waiters that wake late
+                    self._errors[commit] = error
+                    for old in [old for old in self._errors if old < commit - 64]:
+                        del self._errors[old]
+                else:
+                    self.commits += 1
+                    self.samples += sum(len(batch) for batch in batches)
+                self._committed = commit
+                self._done.notify_all()
+
+    def _write(self, batches):
+        payload = b''.join(_column_bytes(_concat(code, [getattr(batch, name) for batch in batches]))
+                           for name, code in COLUMNS)
+        count = sum(len(batch) for batch in batches)
+        block = BLOCK_HEADER.pack(BLOCK_MAGIC, count, len(payload), zlib.crc32(payload)) + payload
+        if self._fd is None or self._size + len(block) > self.segment_bytes:
+            self._open_segment()
+        self._torn = True
+        view = memoryview(block)
+        while view:
+            view = view[os.write(self._fd, view):]
+        self._torn = False
+        os.fdatasync(self._fd)
+        self._size += len(block)
+
+
+def _concat(typecode, columns):
+    result = array(typecode)
+    for column in columns:
+        result.extend(column)
+    return result
+
+
+def read_blocks(data, offset=0):
+    """Yields (block, end offset) for each intact block of data from offset
+    on, a block being a dict of columns; stops at a torn or partly written
+    block."""
+    while offset + BLOCK_HEADER.size <= len(data):
+        magic, count, size, crc = BLOCK_HEADER.unpack_from(data, offset)
+        payload = data[offset + BLOCK_HEADER.size:offset + BLOCK_HEADER.size + size]
+        if magic != BLOCK_MAGIC or len(payload) != size or zlib.crc32(payload) != crc:
+            return
+        block = {}
+        start = 0
+        for name, code in COLUMNS:
+            end = start + count * array(code).itemsize
+            block[name] = _column(code, payload[start:end])
+            start = end
+        offset += BLOCK_HEADER.size + size
+        yield block, offset
+
+
+def read_segment(path):
+    """Yields a dict of columns per intact block; stops at a torn block."""
+    with open(path, 'rb') as file:
+        data = file.read()
+    for block, _ in read_blocks(data):
+        yield block
+
+
+def read_log(directory):
+    """Yields the blocks of all segments of a directory, oldest segment of
+    each process first."""
+    names = sorted(name for name in os.listdir(directory) if name.endswith('.log'))
+    for name in names:
+        yield from read_segment(os.path.join(directory, name))
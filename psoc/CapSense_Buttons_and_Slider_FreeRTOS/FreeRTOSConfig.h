@@ -54,6 +54,9 @@
  */
 #include "cycfg_system.h"
 
+/* Application build options (APP_LOW_POWER, APP_RTOS_TRACE) */
+#include "app_config.h"
+
 
 #define configUSE_PREEMPTION                    1
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
@@ -87,11 +90,50 @@
 #define configUSE_MALLOC_FAILED_HOOK            1
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
-/* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+/* Run time and task stats gathering related definitions. With
+ * APP_RUNTIME_STATS the kernel counts task run time in CPU cycles
+ * (runtime_stats.c).
+ */
+#define configGENERATE_RUN_TIME_STATS           APP_RUNTIME_STATS
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
+#if APP_RUNTIME_STATS
+extern void runtime_stats_timer_init( void );
+extern uint32_t runtime_stats_counter( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    runtime_stats_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()            runtime_stats_counter()
+#endif
+
+/* Kernel trace hooks. With APP_RTOS_TRACE task switches, queue and timer
+ * daemon activity are recorded for a timeline view (rtos_trace.c).
+ */
+#if APP_RTOS_TRACE
+extern void rtos_trace_task_create( void *task );
+extern void rtos_trace_task_switched_in( void *task );
+extern void rtos_trace_task_switched_out( void *task );
+extern void rtos_trace_queue_create( void *queue );
+extern void rtos_trace_queue_name( void *queue, const char *name );
+extern void rtos_trace_queue_send( void *queue, uint32_t from_isr );
+extern void rtos_trace_queue_receive( void *queue, uint32_t from_isr );
+extern void rtos_trace_timer_create( void *timer );
+extern void rtos_trace_timer_command( void *timer, int32_t command );
+extern void rtos_trace_timer_expired( void *timer );
+#define traceTASK_CREATE( pxNewTCB )                rtos_trace_task_create( pxNewTCB )
+#define traceTASK_SWITCHED_IN()                     rtos_trace_task_switched_in( pxCurrentTCB )
+#define traceTASK_SWITCHED_OUT()                    rtos_trace_task_switched_out( pxCurrentTCB )
+#define traceQUEUE_CREATE( pxNewQueue )             rtos_trace_queue_create( pxNewQueue )
+#define traceQUEUE_REGISTRY_ADD( xQueue, pcName )   rtos_trace_queue_name( xQueue, pcName )
+#define traceQUEUE_SEND( pxQueue )                  rtos_trace_queue_send( pxQueue, 0u )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )         rtos_trace_queue_send( pxQueue, 1u )
+#define traceQUEUE_RECEIVE( pxQueue )               rtos_trace_queue_receive( pxQueue, 0u )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )      rtos_trace_queue_receive( pxQueue, 1u )
+#define traceTIMER_CREATE( pxNewTimer )             rtos_trace_timer_create( pxNewTimer )
+#define traceTIMER_COMMAND_RECEIVED( pxTimer, xMessageID, xMessageValue ) \
+                                                    rtos_trace_timer_command( pxTimer, ( int32_t ) xMessageID )
+#define traceTIMER_EXPIRED( pxTimer )               rtos_trace_timer_expired( pxTimer )
+#endif
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         1
@@ -158,8 +200,9 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
-#define INCLUDE_uxTaskGetStackHighWaterMark     0
-#define INCLUDE_xTaskGetIdleTaskHandle          0
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_xTimerGetTimerDaemonTaskHandle  1
 #define INCLUDE_eTaskGetState                   0
 #define INCLUDE_xEventGroupSetBitFromISR        1
 #define INCLUDE_xTimerPendFunctionCall          1
@@ -193,10 +236,13 @@ standard names - or at least those used in the unmodified vector table. */
 
 /* Check if the ModusToolbox Device Configurator Power personality parameter
  * "System Idle Power Mode" is set to either "CPU Sleep" or "System Deep Sleep".
+ * With APP_LOW_POWER, power_mgr.c provides vApplicationSleep and selects the
+ * power mode itself.
  */
-#if defined(CY_CFG_PWR_SYS_IDLE_MODE) && \
-    ((CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_SLEEP) || \
-     (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP))
+#if APP_LOW_POWER || \
+    (defined(CY_CFG_PWR_SYS_IDLE_MODE) && \
+     ((CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_SLEEP) || \
+      (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP)))
 
 /* Enable low power tickless functionality. The RTOS abstraction library
  * provides the compatible implementation of the vApplicationSleep hook:
@@ -0,0 +1,164 @@
+/******************************************************************************
+* File Name: app_config.h
+*
+* Description: Build options of the application. Each option can be
+*              overridden from the Makefile, e.g. DEFINES+=APP_LATENCY_TRACE=0.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_APP_CONFIG_H_
+#define SOURCE_APP_CONFIG_H_
+
+
+/*******************************************************************************
+* Build options
+*******************************************************************************/
+/* Timestamp every stage of a touch event from the scan timer to the PWM
+ * update and publish latency histograms over EzI2C (latency_trace.c).
+ */
+#ifndef APP_LATENCY_TRACE
+#define APP_LATENCY_TRACE               (1u)
+#endif
+
+/* Signal CAPSENSE_SCAN and CAPSENSE_PROCESS to task_capsense with task
+ * notification bits instead of the CapSense command ring.
+ */
+#ifndef APP_CAPSENSE_TASK_NOTIFY
+#define APP_CAPSENSE_TASK_NOTIFY        (0u)
+#endif
+
+/* Measure the cycles spent signalling task_capsense per scan cycle and
+ * publish them over EzI2C. Used by the "bench" target of the host simulation.
+ */
+#ifndef APP_SIGNAL_BENCH
+#define APP_SIGNAL_BENCH                (0u)
+#endif
+
+/* Sleep between scans with tickless idle, entering System Deep Sleep when
+ * the idle window allows it (power_mgr.c).
+ */
+#ifndef APP_LOW_POWER
+#define APP_LOW_POWER                   (1u)
+#endif
+
+/* Publish the raw counts, baselines and diff counts of every scan in a
+ * record ring over EzI2C (telemetry.c).
+ */
+#ifndef APP_TELEMETRY
+#define APP_TELEMETRY                   (1u)
+#endif
+
+/* Scan the widgets one by one and process each widget while the next one is
+ * scanned, instead of scanning all widgets before processing any.
+ */
+#ifndef APP_CAPSENSE_PIPELINE
+#define APP_CAPSENSE_PIPELINE           (1u)
+#endif
+
+/* Create the application tasks from static buffers instead of the heap, so
+ * that no memory is allocated on the boot path.
+ */
+#ifndef APP_STATIC_ALLOCATION
+#define APP_STATIC_ALLOCATION           (1u)
+#endif
+
+/* Account the run time of every task and of the application interrupts with
+ * the cycle counter and publish CPU load per task over EzI2C
+ * (runtime_stats.c).
+ */
+#ifndef APP_RUNTIME_STATS
+#define APP_RUNTIME_STATS               (1u)
+#endif
+
+/* Time the CapSense and EzI2C interrupt handlers through wrappers in the
+ * vector table and publish their cost over EzI2C (isr_profile.c).
+ */
+#ifndef APP_ISR_PROFILE
+#define APP_ISR_PROFILE                 (1u)
+#endif
+
+/* Synchronize with the CapSense Tuner from a low-priority task at
+ * TUNER_SYNC_HZ and serve the Tuner a copy of the CapSense data, instead of
+ * running Cy_CapSense_RunTuner() after every frame (tuner_sync.c).
+ */
+#ifndef APP_TUNER_SYNC
+#define APP_TUNER_SYNC                  (1u)
+#endif
+
+/* Hand the LED commands of the touch processing to task_led through a ring
+ * in the memory shared by the CM0+ and CM4 cores, with an IPC doorbell,
+ * instead of the LED command ring (ipc_ring.c). Both ends run on the CM4
+ * here; the producer side needs only the PDL and can move to a CM0+ image.
+ */
+#ifndef APP_IPC_TOUCH_RING
+#define APP_IPC_TOUCH_RING              (0u)
+#endif
+
+/* Drive the LED through a gamma-corrected level table, with brightness
+ * changes written to the TCPWM compare register and fades played by DMA,
+ * instead of HAL duty-cycle updates (led_effect.c).
+ */
+#ifndef APP_LED_EFFECTS
+#define APP_LED_EFFECTS                 (1u)
+#endif
+
+/* Publish the touch results of each scan once on an event bus that task_led
+ * and further subscribers read in place, each through its own cursor, and
+ * that the host reads through the diagnostics map (event_bus.c). task_led
+ * takes its commands from the LED command ring instead when this is 0, and
+ * from the IPC ring when APP_IPC_TOUCH_RING is set.
+ */
+#ifndef APP_EVENT_BUS
+#define APP_EVENT_BUS                   (1u)
+#endif
+
+/* Record the time from main() to the first processed CapSense frame, phase
+ * by phase, in the diagnostics map (boot_profile.c).
+ */
+#ifndef APP_BOOT_PROFILE
+#define APP_BOOT_PROFILE                (1u)
+#endif
+
+/* Start the first scan as soon as CapSense is enabled instead of one scan
+ * period later, and restore the baselines saved before a reset instead of
+ * those of the single scan of Cy_CapSense_Enable() (baseline_store.c).
+ */
+#ifndef APP_FAST_START
+#define APP_FAST_START                  (1u)
+#endif
+
+/* With APP_FAST_START, also keep the baselines in a flash row, so that they
+ * survive power cycles. Costs a RAM buffer of one flash row (512 bytes).
+ */
+#ifndef APP_BASELINE_FLASH
+#define APP_BASELINE_FLASH              (0u)
+#endif
+
+/* Record task switches, kernel queue and timer daemon activity, the event
+ * rings and the application interrupts in a trace buffer that converts to a
+ * Chrome trace / Perfetto timeline (rtos_trace.c). The buffer needs about
+ * 2.3 KB, so APP_RAM_BUDGET_BYTES has to be raised with it on the target.
+ */
+#ifndef APP_RTOS_TRACE
+#define APP_RTOS_TRACE                  (0u)
+#endif
+
+/* RAM the application may reserve at build time for task stacks and control
+ * blocks, event rings and the diagnostics map; checked when main.c is
+ * compiled (mem_report.h).
+ */
+#ifndef APP_RAM_BUDGET_BYTES
+#define APP_RAM_BUDGET_BYTES            (8192u)
+#endif
+
+
+#endif /* SOURCE_APP_CONFIG_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,265 @@
+/******************************************************************************
+* File Name: baseline_store.c
+*
+* Description: Saves the CapSense baselines while no widget is touched and
+*              restores them at start-up, so that the first frames after a
+*              reset compare against settled baselines rather than against
+*              the single scan of Cy_CapSense_Enable(), which takes a finger
+*              resting on a sensor for its baseline.
+*
+*              The baselines are kept in a retained RAM section, which
+*              survives resets but not power cycles, and with
+*              APP_BASELINE_FLASH also in a flash row. A saved image is only
+*              used if its check value is intact and it was taken with the
+*              same sensors and the same compensation IDAC values as the
+*              calibration of this boot; raw counts, and so baselines, are
+*              only comparable at equal IDAC values.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "baseline_store.h"
+#include "cybsp.h"
+#include "diag_i2c.h"
+
+
+#if APP_FAST_START
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+/* Not initialized by the start-up code, so that it survives a reset */
+#if APP_BASELINE_FLASH
+CY_NOINIT static union
+{
+    baseline_image_t image;
+    uint32_t row[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
+} baseline_retained;
+
+/* Flash row of the image, in the section the linker scripts reserve for
+ * emulated EEPROM; erased flash reads as an invalid image. The row changes
+ * behind the compiler's back, so it is only read through a volatile pointer:
+ * reads of the const array itself may be folded to its initializer.
+ */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+const uint8_t baseline_flash[CY_FLASH_SIZEOF_ROW] = { 0u };
+static const baseline_image_t *const volatile baseline_flash_image =
+    (const baseline_image_t *)baseline_flash;
+
+#define BASELINE_RETAINED           (baseline_retained.image)
+#define BASELINE_FLASH              (baseline_flash_image)
+
+_Static_assert(sizeof(baseline_image_t) <= CY_FLASH_SIZEOF_ROW, "Baseline image must fit a flash row");
+#else
+CY_NOINIT static baseline_image_t baseline_retained;
+
+#define BASELINE_RETAINED           (baseline_retained)
+#endif
+
+static uint32_t baseline_store_untouched;   /* Untouched frames since the last save */
+
+
+/*******************************************************************************
+* Function Name: baseline_store_check
+********************************************************************************
+* Summary:
+*  Check value of an image: FNV-1a over all fields before check.
+*
+*******************************************************************************/
+static uint32_t baseline_store_check(const baseline_image_t *image)
+{
+    const uint8_t *data = (const uint8_t *)image;
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0u; i < offsetof(baseline_image_t, check); i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+
+/*******************************************************************************
+* Function Name: baseline_store_usable
+********************************************************************************
+* Summary:
+*  Returns true if an image is intact and belongs to the sensors and the
+*  calibration of this boot.
+*
+*******************************************************************************/
+static bool baseline_store_usable(const baseline_image_t *image)
+{
+    if ((BASELINE_STORE_MAGIC != image->magic) ||
+        (CY_CAPSENSE_SENSOR_COUNT != image->sensors) ||
+        (baseline_store_check(image) != image->check))
+    {
+        return false;
+    }
+    for (uint32_t sns = 0u; sns < CY_CAPSENSE_SENSOR_COUNT; sns++)
+    {
+        if (image->sensor[sns].idac_comp != cy_capsense_tuner.sensorContext[sns].idacComp)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+#if APP_BASELINE_FLASH
+/*******************************************************************************
+* Function Name: baseline_store_flash_stale
+********************************************************************************
+* Summary:
+*  Returns true if the flash image is unusable or a baseline has moved by
+*  more than BASELINE_STORE_FLASH_DELTA since it was written.
+*
+*******************************************************************************/
+static bool baseline_store_flash_stale(void)
+{
+    if (!baseline_store_usable(BASELINE_FLASH))
+    {
+        return true;
+    }
+    for (uint32_t sns = 0u; sns < CY_CAPSENSE_SENSOR_COUNT; sns++)
+    {
+        int32_t delta = (int32_t)BASELINE_RETAINED.sensor[sns].bsln -
+                        (int32_t)BASELINE_FLASH->sensor[sns].bsln;
+
+        if ((delta > (int32_t)BASELINE_STORE_FLASH_DELTA) ||
+            (delta < -(int32_t)BASELINE_STORE_FLASH_DELTA))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+
+/*******************************************************************************
+* Function Name: baseline_store_restore
+********************************************************************************
+* Summary:
+*  Replaces the baselines initialized by Cy_CapSense_Enable() with the saved
+*  ones, preferring the retained image, which is the newer one. Called once
+*  after Cy_CapSense_Enable().
+*
+*******************************************************************************/
+void baseline_store_restore(void)
+{
+    baseline_store_stats_t *stats = &diag_i2c_map.baseline_store;
+    const baseline_image_t *image = NULL;
+
+    stats->source = BASELINE_SOURCE_SCAN;
+    if (baseline_store_usable(&BASELINE_RETAINED))
+    {
+        image = &BASELINE_RETAINED;
+        stats->source = BASELINE_SOURCE_RETAINED;
+    }
+    else
+    {
+        if (BASELINE_STORE_MAGIC == BASELINE_RETAINED.magic)
+        {
+            stats->rejected++;
+        }
+#if APP_BASELINE_FLASH
+        if (baseline_store_usable(BASELINE_FLASH))
+        {
+            image = BASELINE_FLASH;
+            stats->source = BASELINE_SOURCE_FLASH;
+        }
+        else if (BASELINE_STORE_MAGIC == BASELINE_FLASH->magic)
+        {
+            stats->rejected++;
+        }
+#endif
+    }
+
+    if (NULL != image)
+    {
+        for (uint32_t sns = 0u; sns < CY_CAPSENSE_SENSOR_COUNT; sns++)
+        {
+            cy_capsense_tuner.sensorContext[sns].bsln = image->sensor[sns].bsln;
+            cy_capsense_tuner.sensorContext[sns].bslnExt = image->sensor[sns].bsln_ext;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: baseline_store_frame
+********************************************************************************
+* Summary:
+*  Saves the baselines to retained RAM every BASELINE_STORE_INTERVAL untouched
+*  frames, and with APP_BASELINE_FLASH to flash once per boot when they have
+*  moved away from the flash copy. Touched frames restart the count, as the
+*  baselines of a touched widget are not updated.
+*
+* Parameters:
+*  bool touched : A widget is active in this frame
+*
+*******************************************************************************/
+void baseline_store_frame(bool touched)
+{
+    baseline_store_stats_t *stats = &diag_i2c_map.baseline_store;
+    baseline_image_t *image = &BASELINE_RETAINED;
+
+    if (touched)
+    {
+        baseline_store_untouched = 0u;
+        return;
+    }
+    if (++baseline_store_untouched < BASELINE_STORE_INTERVAL)
+    {
+        return;
+    }
+    baseline_store_untouched = 0u;
+
+    if (0u == stats->retained_saves)
+    {
+        /* The retained section holds whatever the last boot left there */
+        memset(&baseline_retained, 0, sizeof(baseline_retained));
+    }
+
+    /* A reset during the update leaves an image with a wrong check value */
+    image->magic = BASELINE_STORE_MAGIC;
+    image->sensors = CY_CAPSENSE_SENSOR_COUNT;
+    image->saves++;
+    for (uint32_t sns = 0u; sns < CY_CAPSENSE_SENSOR_COUNT; sns++)
+    {
+        image->sensor[sns].bsln = cy_capsense_tuner.sensorContext[sns].bsln;
+        image->sensor[sns].bsln_ext = cy_capsense_tuner.sensorContext[sns].bslnExt;
+        image->sensor[sns].idac_comp = cy_capsense_tuner.sensorContext[sns].idacComp;
+    }
+    image->check = baseline_store_check(image);
+    stats->retained_saves++;
+
+#if APP_BASELINE_FLASH
+    if ((BASELINE_STORE_FLASH_SAVES == stats->retained_saves) && baseline_store_flash_stale())
+    {
+        /* Blocks for the duration of the row write, once per boot at most */
+        if (CY_FLASH_DRV_SUCCESS == Cy_Flash_WriteRow((uintptr_t)baseline_flash,
+                                                      baseline_retained.row))
+        {
+            stats->flash_writes++;
+        }
+        else
+        {
+            stats->flash_errors++;
+        }
+    }
+#endif
+}
+
+#endif /* APP_FAST_START */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,121 @@
+/******************************************************************************
+* File Name: baseline_store.h
+*
+* Description: This file is the public interface of baseline_store.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_BASELINE_STORE_H_
+#define SOURCE_BASELINE_STORE_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cybsp.h"
+#include "cycfg_capsense.h"
+#include "app_config.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Untouched frames between two saves of the baselines to retained RAM */
+#ifndef BASELINE_STORE_INTERVAL
+#define BASELINE_STORE_INTERVAL     (64u)
+#endif
+
+/* Retained saves before the baselines are compared with the flash copy, and
+ * the change of any baseline, in raw counts, that rewrites it. Flash is
+ * written at most once per boot.
+ */
+#define BASELINE_STORE_FLASH_SAVES  (8u)
+#ifndef BASELINE_STORE_FLASH_DELTA
+#define BASELINE_STORE_FLASH_DELTA  (16u)
+#endif
+
+#define BASELINE_STORE_MAGIC        (0x42534C4Eu)   /* "BSLN" */
+
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+typedef enum
+{
+    BASELINE_SOURCE_SCAN,           /* Initialized by Cy_CapSense_Enable() */
+    BASELINE_SOURCE_RETAINED,       /* Restored from retained RAM */
+    BASELINE_SOURCE_FLASH           /* Restored from flash */
+} baseline_source_t;
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t bsln;
+    uint8_t bsln_ext;
+    uint8_t idac_comp;              /* Calibration the baseline belongs to */
+} baseline_store_sensor_t;
+
+/* Saved baselines. check covers all fields before it. */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t sensors;               /* CY_CAPSENSE_SENSOR_COUNT */
+    uint32_t saves;
+    baseline_store_sensor_t sensor[CY_CAPSENSE_SENSOR_COUNT];
+    uint32_t check;
+} baseline_image_t;
+
+/* Baseline store counters, published in the diagnostics map */
+typedef struct
+{
+    uint32_t source;                /* baseline_source_t of this boot */
+    uint32_t rejected;              /* Saved images not used: damaged, or of
+                                     * another configuration or calibration
+                                     */
+    uint32_t retained_saves;
+    uint32_t flash_writes;
+    uint32_t flash_errors;
+} baseline_store_stats_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_FAST_START
+void baseline_store_restore(void);
+void baseline_store_frame(bool touched);
+
+#define BASELINE_STORE_RESTORE()        baseline_store_restore()
+#define BASELINE_STORE_FRAME(touched)   baseline_store_frame(touched)
+
+/* RAM of the retained image; with APP_BASELINE_FLASH it is a full flash row,
+ * since it is also the source of the flash write
+ */
+#if APP_BASELINE_FLASH
+#define BASELINE_STORE_RAM_BYTES        (CY_FLASH_SIZEOF_ROW)
+#else
+#define BASELINE_STORE_RAM_BYTES        (sizeof(baseline_image_t))
+#endif
+#else
+#define BASELINE_STORE_RESTORE()
+#define BASELINE_STORE_FRAME(touched)
+#define BASELINE_STORE_RAM_BYTES        (0u)
+#endif
+
+
+#endif /* SOURCE_BASELINE_STORE_H_ */
+
+
+/* [] END OF FILE */
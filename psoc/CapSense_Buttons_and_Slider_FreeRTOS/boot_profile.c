@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name: boot_profile.c
+*
+* Description: Timestamps of the start-up path from main() to the first
+*              processed CapSense frame.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "boot_profile.h"
+#include "cybsp.h"
+#include "cycle_counter.h"
+#include "diag_i2c.h"
+
+
+#if APP_BOOT_PROFILE
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static uint32_t boot_profile_origin;
+
+
+/*******************************************************************************
+* Function Name: boot_profile_start
+********************************************************************************
+* Summary:
+*  Starts the cycle counter and records BOOT_PHASE_MAIN. Called first thing
+*  in main().
+*
+*******************************************************************************/
+void boot_profile_start(void)
+{
+    boot_profile_t *profile = &diag_i2c_map.boot;
+
+    cycle_counter_init();
+    boot_profile_origin = cycle_counter_get();
+
+    profile->phases = BOOT_PHASE_COUNT;
+    profile->fast_start = APP_FAST_START;
+    profile->reached = 1u << BOOT_PHASE_MAIN;
+}
+
+
+/*******************************************************************************
+* Function Name: boot_profile_mark
+********************************************************************************
+* Summary:
+*  Records the time a phase is first reached; later calls are ignored, so
+*  the marks of the first scan can sit on the paths of every scan.
+*
+* Parameters:
+*  boot_phase_t phase : Phase reached
+*
+*******************************************************************************/
+void boot_profile_mark(boot_phase_t phase)
+{
+    boot_profile_t *profile = &diag_i2c_map.boot;
+
+    if (0u != (profile->reached & (1u << phase)))
+    {
+        return;
+    }
+    profile->us[phase] = cycle_counter_to_us(cycle_counter_get() - boot_profile_origin);
+    profile->reached |= 1u << phase;
+}
+
+#endif /* APP_BOOT_PROFILE */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,83 @@
+/******************************************************************************
+* File Name: boot_profile.h
+*
+* Description: This file is the public interface of boot_profile.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_BOOT_PROFILE_H_
+#define SOURCE_BOOT_PROFILE_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "app_config.h"
+
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+/* Milestones of the start-up path, in the order they are reached */
+typedef enum
+{
+    BOOT_PHASE_MAIN,                /* main() entered; time 0 */
+    BOOT_PHASE_BSP,                 /* cybsp_init() done */
+    BOOT_PHASE_SCHEDULER,           /* Rings and tasks created */
+    BOOT_PHASE_TASK,                /* task_capsense running */
+    BOOT_PHASE_TUNER,               /* EzI2C up */
+    BOOT_PHASE_CAPSENSE_INIT,       /* Cy_CapSense_Init() done */
+    BOOT_PHASE_CAPSENSE_ENABLE,     /* Calibration and baselines done */
+    BOOT_PHASE_FIRST_SCAN,          /* First frame started */
+    BOOT_PHASE_FIRST_PROCESS,       /* First frame processed */
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Start-up timeline, published in the diagnostics map. Times are counted by
+ * the cycle counter from the entry of main(), so the start-up code and the
+ * boot of the CM0+ before it are not included. The counter stops while the
+ * CPU sleeps; without APP_FAST_START the wait for the first scan tick is
+ * therefore missing from the first scan. cybsp_init() sets up the CPU clock,
+ * so the time of BOOT_PHASE_BSP, converted at the final clock, is only a
+ * lower bound.
+ */
+typedef struct
+{
+    uint32_t phases;                /* BOOT_PHASE_COUNT */
+    uint32_t reached;               /* Bit n is set once phase n is reached */
+    uint32_t fast_start;            /* APP_FAST_START of the build */
+    uint32_t us[BOOT_PHASE_COUNT];  /* Time of each phase */
+} boot_profile_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_BOOT_PROFILE
+void boot_profile_start(void);
+void boot_profile_mark(boot_phase_t phase);
+
+#define BOOT_PROFILE_START()        boot_profile_start()
+#define BOOT_PROFILE_MARK(phase)    boot_profile_mark(phase)
+#else
+#define BOOT_PROFILE_START()
+#define BOOT_PROFILE_MARK(phase)
+#endif
+
+
+#endif /* SOURCE_BOOT_PROFILE_H_ */
+
+
+/* [] END OF FILE */
@@ -50,8 +50,22 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "timers.h"
 #include "led_task.h"
+#include "latency_trace.h"
+#include "diag_i2c.h"
+#include "cycle_counter.h"
+#include "scan_scheduler.h"
+#include "touch_filter.h"
+#include "touch_engine.h"
+#include "telemetry.h"
+#include "mem_report.h"
+#include "scan_planner.h"
+#include "runtime_stats.h"
+#include "isr_profile.h"
+#include "tuner_sync.h"
+#include "boot_profile.h"
+#include "baseline_store.h"
+#include "rtos_trace.h"
 
 
 /*******************************************************************************
@@ -61,7 +75,28 @@
 #define EZI2C_INTERRUPT_PRIORITY    (6u)    /* EZI2C interrupt priority must be
                                              * higher than CapSense interrupt
                                              */
-#define CAPSENSE_SCAN_INTERVAL_MS    (10u)   /* in milliseconds*/
+#define CAPSENSE_COMMAND_BATCH_SIZE  (CAPSENSE_COMMAND_RING_SIZE)
+
+/* SCB interrupts are numbered consecutively; the EzI2C slave uses the one of
+ * the SCB block allocated by the HAL.
+ */
+#define EZI2C_IRQN                  ((IRQn_Type)((uint32_t)scb_0_interrupt_IRQn + \
+                                                 sEzI2C.resource.block_num))
+
+
+/*******************************************************************************
+* Data structure
+*******************************************************************************/
+/* LED command collected by the touch handlers of one scan; the handler of the
+ * highest widget ID wins.
+ */
+typedef struct
+{
+    led_command_data_t data;
+    uint32_t widget_id;
+    touch_event_t event;
+    bool send;
+} touch_led_request_t;
 
 
 /*******************************************************************************
@@ -70,22 +105,87 @@
 static uint32_t capsense_init(void);
 static void tuner_init(void);
 static void process_touch(void);
+static bool touch_publish(const touch_led_request_t *request);
+static void touch_button_led(uint32_t widget_id, const touch_action_t *action,
+                             touch_event_t event, void *context);
+static void touch_slider_led(uint32_t widget_id, const touch_action_t *action,
+                             touch_event_t event, void *context);
 static void capsense_isr(void);
 static void capsense_end_of_scan_callback(cy_stc_active_scan_sns_t* active_scan_sns_ptr);
-static void capsense_timer_callback(TimerHandle_t xTimer);
+static void capsense_scan_tick(void);
+static uint32_t capsense_wait_commands(capsense_command_t *commands);
+static void capsense_signal_received(capsense_command_t command);
+static void capsense_scan_requested(void);
+static void capsense_try_start_frame(void);
+static void capsense_start_frame(void);
+static bool capsense_scan_done(void);
+static void capsense_frame_complete(void);
 void handle_error(void);
 
 
 /******************************************************************************
 * Global variables
 ******************************************************************************/
-QueueHandle_t capsense_command_q;
-TimerHandle_t scan_timer_handle;
+event_ring_t capsense_command_ring;
+event_bus_t touch_bus;
+static TaskHandle_t capsense_task_handle;
+static touch_filter_t slider_filter;
+static touch_engine_t touch_engine;
+#if APP_IPC_TOUCH_RING
+static ipc_ring_t *led_ipc_producer;        /* led_ipc_ring, once attached */
+#endif
+
+/* Frame state, only accessed by task_capsense */
+static bool capsense_frame_active;
+static bool capsense_scan_pending;
+static uint32_t capsense_frame_start;
+static uint64_t capsense_frame_us_sum;
+#if APP_CAPSENSE_PIPELINE
+static uint32_t capsense_frame_widget;      /* Widget whose scan completes next */
+#endif
+
+/* Touch actions, by widget ID */
+static const touch_action_t touch_actions[CY_CAPSENSE_WIDGET_COUNT] =
+{
+    [CY_CAPSENSE_BUTTON0_WDGT_ID] =
+    {
+        .handler    = touch_button_led,
+        .param      = LED_TURN_ON
+    },
+    [CY_CAPSENSE_BUTTON1_WDGT_ID] =
+    {
+        .handler    = touch_button_led,
+        .param      = LED_TURN_OFF
+    },
+    [CY_CAPSENSE_LINEARSLIDER0_WDGT_ID] =
+    {
+        .handler    = touch_slider_led,
+        .flags      = TOUCH_ACTION_CONTINUOUS,
+        .object     = &slider_filter
+    }
+};
 cy_stc_scb_ezi2c_context_t ezi2c_context;
 cyhal_ezi2c_t sEzI2C;
 cyhal_ezi2c_slave_cfg_t sEzI2C_sub_cfg;
+cyhal_ezi2c_slave_cfg_t sEzI2C_diag_cfg;
 cyhal_ezi2c_cfg_t sEzI2C_cfg;
 
+/* Diagnostics buffer exposed on the second EzI2C slave address */
+diag_i2c_map_t diag_i2c_map =
+{
+    .magic      = DIAG_I2C_MAGIC,
+    .version    = DIAG_I2C_VERSION,
+    .size       = sizeof(diag_i2c_map_t)
+};
+
+#if APP_SIGNAL_BENCH
+/* Time each command was signalled, indexed by capsense_command_t */
+static volatile uint32_t capsense_signal_stamp[CAPSENSE_PROCESS + 1u];
+#define CAPSENSE_SIGNAL_STAMP(command)  (capsense_signal_stamp[(command)] = cycle_counter_get())
+#else
+#define CAPSENSE_SIGNAL_STAMP(command)
+#endif
+
 /* SysPm callback params */
 cy_stc_syspm_callback_params_t callback_params =
 {
@@ -138,19 +238,32 @@ void handle_error(void)
 *******************************************************************************/
 void task_capsense(void* param)
 {
-    BaseType_t rtos_api_result;
     cy_status status;
-    capsense_command_t capsense_cmd;
+    capsense_command_t capsense_cmd[CAPSENSE_COMMAND_BATCH_SIZE];
+    uint32_t cmd_count;
 
     /* Remove warning for unused parameter */
     (void)param;
 
-    /* Initialize timer for periodic CapSense scan */
-    scan_timer_handle = xTimerCreate ("Scan Timer", CAPSENSE_SCAN_INTERVAL_MS,
-                                      pdTRUE, NULL, capsense_timer_callback);
+    /* The callbacks notify this task directly with APP_CAPSENSE_TASK_NOTIFY */
+    capsense_task_handle = xTaskGetCurrentTaskHandle();
+    cycle_counter_init();
+    diag_i2c_map.capsense_frame.pipelined = APP_CAPSENSE_PIPELINE;
+#if APP_SIGNAL_BENCH
+    diag_i2c_map.capsense_signal.mode = APP_CAPSENSE_TASK_NOTIFY;
+#endif
+
+#if APP_IPC_TOUCH_RING
+    /* The consumer publishes the ring before the scheduler starts */
+    led_ipc_producer = ipc_ring_attach();
+    CY_ASSERT(NULL != led_ipc_producer);
+#endif
+
+    BOOT_PROFILE_MARK(BOOT_PHASE_TASK);
 
     /* Setup communication between Tuner GUI and PSoC 6 MCU */
     tuner_init();
+    BOOT_PROFILE_MARK(BOOT_PHASE_TUNER);
 
     /* Initialize CapSense block */
     status = capsense_init();
@@ -159,140 +272,455 @@ void task_capsense(void* param)
         CY_ASSERT(0u);
     }
 
-    /* Start the timer */
-    xTimerStart(scan_timer_handle, 0u);
+    /* Serve the Tuner a copy of the initialized data */
+    TUNER_SYNC_START(EZI2C_IRQN);
+
+    /* Time both interrupts that compete with the scan pipeline */
+    ISR_PROFILE_ATTACH(csd_interrupt_IRQn);
+    ISR_PROFILE_ATTACH(EZI2C_IRQN);
+
+    /* Slider positions are scaled with the resolution of the widget */
+    touch_filter_init(&slider_filter,
+                      cy_capsense_context.ptrWdConfig[CY_CAPSENSE_LINEARSLIDER0_WDGT_ID].xResolution,
+                      &diag_i2c_map.touch_filter);
+    touch_engine_init(&touch_engine, touch_actions);
+#if APP_CAPSENSE_PIPELINE
+    scan_planner_init();
+#endif
+
+    /* Initialize the low-power timer that schedules the scans */
+    if(CY_RSLT_SUCCESS != scan_scheduler_init(capsense_scan_tick))
+    {
+        CY_ASSERT(0u);
+    }
+
+    /* Start periodic scanning */
+    scan_scheduler_start();
+#if APP_FAST_START
+    /* Scan at once rather than one scan period from now */
+    capsense_scan_requested();
+    capsense_try_start_frame();
+#endif
 
     /* Repeatedly running part of the task */
     for(;;)
     {
-        /* Block until a CapSense command has been received over queue */
-        rtos_api_result = xQueueReceive(capsense_command_q, &capsense_cmd,
-                                        portMAX_DELAY);
+        /* Block until CapSense commands are pending, then handle all of them
+         * in order.
+         */
+        cmd_count = capsense_wait_commands(capsense_cmd);
 
-        /* Command has been received from capsense_cmd */
-        if(rtos_api_result == pdTRUE)
+        for(uint32_t i = 0u; i < cmd_count; i++)
         {
-            /* Check if CapSense is busy with a previous scan */
-            if(CY_CAPSENSE_NOT_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context))
+            capsense_signal_received(capsense_cmd[i]);
+
+            switch(capsense_cmd[i])
             {
-                switch(capsense_cmd)
+                case CAPSENSE_SCAN:
                 {
-                    case CAPSENSE_SCAN:
-                    { 
-                        /* Start scan */
-                        Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
-                        break;
-                    }
-                    case CAPSENSE_PROCESS:
-                    {
-                        /* Process all widgets */
-                        Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
-                        process_touch();
-
-                        /* Establishes synchronized operation between the CapSense
-                         * middleware and the CapSense Tuner tool.
-                         */
-                        Cy_CapSense_RunTuner(&cy_capsense_context);
-                        break;
-                    }
-                    /* Invalid command */
-                    default:
+                    /* Started below, once the frame in progress is done */
+                    capsense_scan_requested();
+                    break;
+                }
+                case CAPSENSE_PROCESS:
+                {
+                    /* A scan has completed; process it */
+                    if(capsense_scan_done())
                     {
-                        break;
+                        capsense_frame_complete();
                     }
+                    break;
+                }
+                /* Invalid command */
+                default:
+                {
+                    break;
                 }
             }
         }
-        /* Task has timed out and received no data during an interval of
-         * portMAXDELAY ticks.
-         */
-        else
-        {
-            /* Handle timeout here */
-        }
+
+        capsense_try_start_frame();
     }
 }
 
 
 /*******************************************************************************
-* Function Name: process_touch
+* Function Name: capsense_try_start_frame
 ********************************************************************************
 * Summary:
-*  This function processes the touch input and sends command to LED task.
+*  Starts the next frame if a scan tick is pending and the hardware is idle.
 *
 *******************************************************************************/
-static void process_touch(void)
+static void capsense_try_start_frame(void)
+{
+    if(capsense_scan_pending && !capsense_frame_active &&
+       (CY_CAPSENSE_NOT_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context)))
+    {
+        capsense_scan_pending = false;
+        capsense_start_frame();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_scan_requested
+********************************************************************************
+* Summary:
+*  Records a scan tick. Ticks are never dropped silently: one that arrives
+*  during a frame is deferred, one that finds a tick already deferred is
+*  counted as an overrun.
+*
+*******************************************************************************/
+static void capsense_scan_requested(void)
+{
+    capsense_frame_stats_t *stats = &diag_i2c_map.capsense_frame;
+
+    if(capsense_scan_pending)
+    {
+        stats->overruns++;
+    }
+    else if(capsense_frame_active)
+    {
+        stats->deferred_ticks++;
+    }
+    capsense_scan_pending = true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_start_frame
+********************************************************************************
+* Summary:
+*  Starts the scan of all widgets. In pipelined mode the scan planner selects
+*  the widgets of the frame; only the first one is scanned here and
+*  capsense_scan_done() starts the others.
+*
+*******************************************************************************/
+static void capsense_start_frame(void)
+{
+    scan_scheduler_scan_started();
+    LATENCY_TRACE_STAMP(LATENCY_STAGE_SCAN_START);
+    BOOT_PROFILE_MARK(BOOT_PHASE_FIRST_SCAN);
+    capsense_frame_active = true;
+    capsense_frame_start = cycle_counter_get();
+
+    Cy_CapSense_Wakeup(&cy_capsense_context);
+#if APP_CAPSENSE_PIPELINE
+    scan_planner_begin_frame();
+    capsense_frame_widget = scan_planner_next();
+    Cy_CapSense_SetupWidget(capsense_frame_widget, &cy_capsense_context);
+    Cy_CapSense_Scan(&cy_capsense_context);
+#else
+    Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_scan_done
+********************************************************************************
+* Summary:
+*  Processes a completed scan. In pipelined mode the scan of the next widget
+*  is started first, so that the hardware scans it while the CPU processes
+*  the previous one. The two widgets use separate sensor data, which makes
+*  the completed widget's raw counts a stable snapshot during processing.
+*
+* Return:
+*  true if the frame is complete
+*
+*******************************************************************************/
+static bool capsense_scan_done(void)
+{
+    if(!capsense_frame_active)
+    {
+        return false;
+    }
+
+#if APP_CAPSENSE_PIPELINE
+    uint32_t widget = capsense_frame_widget;
+
+    /* The planner hands out the widgets of the frame */
+    capsense_frame_widget = scan_planner_next();
+    if(SCAN_PLANNER_DONE != capsense_frame_widget)
+    {
+        Cy_CapSense_SetupWidget(capsense_frame_widget, &cy_capsense_context);
+        Cy_CapSense_Scan(&cy_capsense_context);
+    }
+    Cy_CapSense_ProcessWidget(widget, &cy_capsense_context);
+    scan_planner_widget_done(widget, 0u != Cy_CapSense_IsWidgetActive(widget, &cy_capsense_context));
+
+    if(SCAN_PLANNER_DONE != capsense_frame_widget)
+    {
+        return false;
+    }
+    scan_planner_end_frame();
+    return true;
+#else
+    Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
+    return true;
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_complete
+********************************************************************************
+* Summary:
+*  Acts on the touch state of a complete frame.
+*
+*******************************************************************************/
+static void capsense_frame_complete(void)
+{
+    capsense_frame_stats_t *stats = &diag_i2c_map.capsense_frame;
+    bool touched = (0u != Cy_CapSense_IsAnyWidgetActive(&cy_capsense_context));
+    uint32_t frame_us;
+
+    process_touch();
+    BOOT_PROFILE_MARK(BOOT_PHASE_FIRST_PROCESS);
+    TELEMETRY_CAPTURE(&cy_capsense_context);
+    BASELINE_STORE_FRAME(touched);
+
+    /* Interrupt load of the period this frame was scanned in */
+    ISR_PROFILE_FRAME(diag_i2c_map.scan_scheduler.interval_ms);
+
+    /* Scan fast while touched, back off when idle */
+    scan_scheduler_update(touched);
+
+    /* Hand the Tuner its snapshot, if it asked for one */
+    TUNER_SYNC_FRAME();
+
+#if !APP_TUNER_SYNC
+    /* Establishes synchronized operation between the CapSense
+     * middleware and the CapSense Tuner tool.
+     */
+    Cy_CapSense_RunTuner(&cy_capsense_context);
+#endif
+
+    /* Refresh the stack high-water marks and the filter cost now and then */
+    if(0u == (stats->frames % MEM_REPORT_INTERVAL))
+    {
+        mem_report_update();
+        touch_filter_publish(&slider_filter);
+    }
+    RUNTIME_STATS_UPDATE();
+
+    frame_us = cycle_counter_to_us(cycle_counter_get() - capsense_frame_start);
+    stats->frames++;
+    capsense_frame_us_sum += frame_us;
+    stats->frame_us_avg = (uint32_t)(capsense_frame_us_sum / stats->frames);
+    if(frame_us > stats->frame_us_max)
+    {
+        stats->frame_us_max = frame_us;
+    }
+    capsense_frame_active = false;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_is_busy
+********************************************************************************
+* Summary:
+*  Returns true while a scan or an EzI2C transaction is in progress, which
+*  must not be interrupted by System Deep Sleep.
+*
+*******************************************************************************/
+bool capsense_is_busy(void)
 {
-    /* Variables used to store touch information */
-    uint32_t button0_status = 0;
-    uint32_t button1_status = 0;
-    uint16_t slider_pos = 0;
-    uint8_t slider_touched = 0;
-    cy_stc_capsense_touch_t *slider_touch;
-
-    /* Variables used to store previous touch information */
-    static uint32_t button0_status_prev = 0;
-    static uint32_t button1_status_prev = 0;
-    static uint16_t slider_pos_perv = 0;
-
-    /* Variables used for storing command and data for LED Task */
-    led_command_data_t led_cmd_data;
-    bool send_led_command = false;
-
-    /* Get button 0 status */
-    button0_status = Cy_CapSense_IsSensorActive(
-        CY_CAPSENSE_BUTTON0_WDGT_ID,
-        CY_CAPSENSE_BUTTON0_SNS0_ID,
-        &cy_capsense_context);
-
-    /* Get button 1 status */
-    button1_status = Cy_CapSense_IsSensorActive(
-        CY_CAPSENSE_BUTTON1_WDGT_ID,
-        CY_CAPSENSE_BUTTON1_SNS0_ID,
-        &cy_capsense_context);
-
-    /* Get slider status */
-    slider_touch = Cy_CapSense_GetTouchInfo(
-        CY_CAPSENSE_LINEARSLIDER0_WDGT_ID,
-        &cy_capsense_context);
-    slider_pos = slider_touch->ptrPosition->x;
-    slider_touched = slider_touch->numPosition;
-
-    /* Detect new touch on Button0 */
-    if((0u != button0_status) && (0u == button0_status_prev))
+    return (CY_CAPSENSE_NOT_BUSY != Cy_CapSense_IsBusy(&cy_capsense_context)) ||
+           (0u != (cyhal_ezi2c_get_activity_status(&sEzI2C) & CYHAL_EZI2C_STATUS_BUSY));
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_wait_commands
+********************************************************************************
+* Summary:
+*  Blocks until at least one command has been signalled to the task.
+*
+* Parameters:
+*  capsense_command_t *commands : Receives up to CAPSENSE_COMMAND_BATCH_SIZE
+*                                 commands, oldest first
+*
+* Return:
+*  Number of commands received
+*
+*******************************************************************************/
+static uint32_t capsense_wait_commands(capsense_command_t *commands)
+{
+#if APP_CAPSENSE_TASK_NOTIFY
+    uint32_t bits = 0u;
+    uint32_t count = 0u;
+
+    xTaskNotifyWait(0u, CAPSENSE_NOTIFY_ALL, &bits, portMAX_DELAY);
+
+    /* A finished scan is processed before the next one is started */
+    if(0u != (bits & CAPSENSE_NOTIFY_PROCESS))
+    {
+        commands[count++] = CAPSENSE_PROCESS;
+    }
+    if(0u != (bits & CAPSENSE_NOTIFY_SCAN))
     {
-        led_cmd_data.command = LED_TURN_ON;
-        send_led_command = true;
+        commands[count++] = CAPSENSE_SCAN;
     }
+    return count;
+#else
+    return event_ring_wait(&capsense_command_ring, commands,
+                           CAPSENSE_COMMAND_BATCH_SIZE);
+#endif
+}
+
 
-    /* Detect new touch on Button1 */
-    if((0u != button1_status) && (0u == button1_status_prev))
+/*******************************************************************************
+* Function Name: capsense_signal_received
+********************************************************************************
+* Summary:
+*  Accounts the hop of a received command for APP_SIGNAL_BENCH. A scan cycle
+*  is complete when its CAPSENSE_PROCESS command arrives.
+*
+*******************************************************************************/
+static void capsense_signal_received(capsense_command_t command)
+{
+#if APP_SIGNAL_BENCH
+    static uint64_t scan_hop_sum;
+    static uint64_t process_hop_sum;
+    static uint32_t scan_hop;
+    capsense_signal_stats_t *stats = &diag_i2c_map.capsense_signal;
+    uint32_t hop = cycle_counter_get() - capsense_signal_stamp[command];
+
+    if(CAPSENSE_SCAN == command)
     {
-        led_cmd_data.command = LED_TURN_OFF;
-        send_led_command = true;
+        scan_hop = hop;
+        return;
     }
 
-    /* Detect new touch on slider */
-    if((0u != slider_touched) && (slider_pos_perv != slider_pos ))
+    scan_hop_sum += scan_hop;
+    process_hop_sum += hop;
+    stats->scan_cycles++;
+    stats->scan_hop_avg = (uint32_t)(scan_hop_sum / stats->scan_cycles);
+    stats->process_hop_avg = (uint32_t)(process_hop_sum / stats->scan_cycles);
+    stats->cycle_avg = stats->scan_hop_avg + stats->process_hop_avg;
+    if((scan_hop + hop) > stats->cycle_max)
     {
-        led_cmd_data.command = LED_UPDATE_BRIGHTNESS;
-      
-        /* brightness in percentage */
-        led_cmd_data.brightness = (slider_pos * 100) 
-                    / cy_capsense_context.ptrWdConfig[CY_CAPSENSE_LINEARSLIDER0_WDGT_ID].xResolution;
-        send_led_command = true;
+        stats->cycle_max = scan_hop + hop;
     }
+#else
+    (void)command;
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: process_touch
+********************************************************************************
+* Summary:
+*  This function processes the touch input and sends command to LED task.
+*
+*******************************************************************************/
+static void process_touch(void)
+{
+    touch_led_request_t led_request = { .send = false };
+
+    LATENCY_TRACE_STAMP(LATENCY_STAGE_PROCESS);
+
+    /* Dispatch the widgets that changed to their actions */
+    touch_engine_process(&touch_engine, &cy_capsense_context, &led_request);
 
     /* Send command to update LED state if required */
-    if(send_led_command)
+    if(led_request.send)
     {
-        xQueueSendToBack(led_command_data_q, &led_cmd_data, 0u);
+        LATENCY_TRACE_STAMP(LATENCY_STAGE_LED_SEND);
+        if(touch_publish(&led_request))
+        {
+            LATENCY_TRACE_COMMIT();
+        }
     }
+}
+
 
-    /* Update previous touch status */
-    button0_status_prev = button0_status;
-    button1_status_prev = button1_status;
-    slider_pos_perv = slider_pos;
+/*******************************************************************************
+* Function Name: touch_publish
+********************************************************************************
+* Summary:
+*  Hands the touch result of a scan to task_led and, with APP_EVENT_BUS, to
+*  the subscribers of touch_bus. The result is written straight into its slot
+*  on the bus.
+*
+* Return:
+*  true if the LED command reached task_led's ring or the bus
+*
+*******************************************************************************/
+static bool touch_publish(const touch_led_request_t *request)
+{
+#if APP_EVENT_BUS
+    event_bus_event_t *event = event_bus_claim(&touch_bus);
+
+    event->widget_id = (uint8_t)request->widget_id;
+    event->touch_event = (uint8_t)request->event;
+    event->led_command = (uint8_t)request->data.command;
+    event->brightness = request->data.brightness;
+    event_bus_publish(&touch_bus, event);
+#endif
+
+#if APP_IPC_TOUCH_RING
+    return ipc_ring_push(led_ipc_producer, &request->data);
+#elif APP_EVENT_BUS
+    return true;
+#else
+    return event_ring_push(&led_command_ring, &request->data);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: touch_button_led
+********************************************************************************
+* Summary:
+*  Touch action of a button: a new touch requests the LED command in
+*  action->param.
+*
+*******************************************************************************/
+static void touch_button_led(uint32_t widget_id, const touch_action_t *action,
+                             touch_event_t event, void *context)
+{
+    touch_led_request_t *led_request = (touch_led_request_t *)context;
+
+    if(TOUCH_EVENT_PRESS == event)
+    {
+        led_request->data.command = (led_command_t)action->param;
+        led_request->widget_id = widget_id;
+        led_request->event = event;
+        led_request->send = true;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: touch_slider_led
+********************************************************************************
+* Summary:
+*  Touch action of a slider: runs the touch_filter_t in action->object and
+*  requests a brightness update when the filter reports one. A flick moves
+*  the brightness to either end.
+*
+*******************************************************************************/
+static void touch_slider_led(uint32_t widget_id, const touch_action_t *action,
+                             touch_event_t event, void *context)
+{
+    touch_led_request_t *led_request = (touch_led_request_t *)context;
+    cy_stc_capsense_touch_t *slider_touch = Cy_CapSense_GetTouchInfo(widget_id,
+                                                                     &cy_capsense_context);
+    bool touched = (TOUCH_EVENT_RELEASE != event) && (0u != slider_touch->numPosition);
+    touch_filter_output_t slider_out;
+
+    if(touch_filter_update((touch_filter_t *)action->object, touched,
+                           slider_touch->ptrPosition->x, &slider_out))
+    {
+        led_request->data.command = LED_UPDATE_BRIGHTNESS;
+        led_request->data.brightness = slider_out.brightness;
+        led_request->widget_id = widget_id;
+        led_request->event = event;
+        led_request->send = true;
+    }
 }
 
 
@@ -322,28 +750,31 @@ static uint32_t capsense_init(void)
         return status;
     }
 
+    BOOT_PROFILE_MARK(BOOT_PHASE_CAPSENSE_INIT);
+
     /* Initialize CapSense interrupt */
+    RTOS_TRACE_NAME(&cy_capsense_context, "CSD ISR");
     Cy_SysInt_Init(&capSense_intr_config, &capsense_isr);
     NVIC_ClearPendingIRQ(capSense_intr_config.intrSrc);
     NVIC_EnableIRQ(capSense_intr_config.intrSrc);
 
-    /* Initialize the CapSense deep sleep callback functions. */
-    Cy_CapSense_Enable(&cy_capsense_context);
-    Cy_SysPm_RegisterCallback(&capsense_deep_sleep_cb);
-    /* Register end of scan callback */
-    status = Cy_CapSense_RegisterCallback(CY_CAPSENSE_END_OF_SCAN_E,
-                                              capsense_end_of_scan_callback, &cy_capsense_context);
-    if (CYRET_SUCCESS != status)
-    {
-        return status;
-    }
-    /* Initialize the CapSense firmware modules. */
+    /* Initialize the CapSense firmware modules: calibration and baselines.
+     * Done once, before the end of scan callback is registered, so that its
+     * scans are not reported to the task.
+     */
     status = Cy_CapSense_Enable(&cy_capsense_context);
     if (CYRET_SUCCESS != status)
     {
         return status;
     }
-    
+    BASELINE_STORE_RESTORE();
+    BOOT_PROFILE_MARK(BOOT_PHASE_CAPSENSE_ENABLE);
+
+    /* Initialize the CapSense deep sleep callback functions. */
+    Cy_SysPm_RegisterCallback(&capsense_deep_sleep_cb);
+    /* Register end of scan callback */
+    status = Cy_CapSense_RegisterCallback(CY_CAPSENSE_END_OF_SCAN_E,
+                                              capsense_end_of_scan_callback, &cy_capsense_context);
     return status;
 }
 
@@ -361,39 +792,49 @@ static uint32_t capsense_init(void)
 *******************************************************************************/
 static void capsense_end_of_scan_callback(cy_stc_active_scan_sns_t* active_scan_sns_ptr)
 {
-    BaseType_t xYieldRequired;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
     (void)active_scan_sns_ptr;
 
+    LATENCY_TRACE_STAMP(LATENCY_STAGE_END_OF_SCAN);
+
     /* Send command to process CapSense data */
+    CAPSENSE_SIGNAL_STAMP(CAPSENSE_PROCESS);
+#if APP_CAPSENSE_TASK_NOTIFY
+    xTaskNotifyFromISR(capsense_task_handle, CAPSENSE_NOTIFY_PROCESS, eSetBits,
+                       &xHigherPriorityTaskWoken);
+#else
     capsense_command_t commmand = CAPSENSE_PROCESS;
-    xYieldRequired = xQueueSendToBackFromISR(capsense_command_q, &commmand, 0u);
-    portYIELD_FROM_ISR(xYieldRequired);
+    event_ring_push_from_isr(&capsense_command_ring, &commmand, &xHigherPriorityTaskWoken);
+#endif
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 
 /*******************************************************************************
-* Function Name: capsense_timer_callback
+* Function Name: capsense_scan_tick
 ********************************************************************************
 * Summary:
-*  CapSense timer callback. This function sends a command to start CapSense
-*  scan.
-*
-* Parameters:
-*  TimerHandle_t xTimer (unused)
+*  Scan scheduler tick, called from the LPTIMER interrupt. This function
+*  sends a command to start CapSense scan.
 *
 *******************************************************************************/
-static void capsense_timer_callback(TimerHandle_t xTimer)
+static void capsense_scan_tick(void)
 {
-    Cy_CapSense_Wakeup(&cy_capsense_context);
-    capsense_command_t command = CAPSENSE_SCAN;
-    BaseType_t xYieldRequired;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-    (void)xTimer;
+    LATENCY_TRACE_STAMP(LATENCY_STAGE_TIMER);
 
     /* Send command to start CapSense scan */
-    xYieldRequired = xQueueSendToBackFromISR(capsense_command_q, &command, 0u);
-    portYIELD_FROM_ISR(xYieldRequired);
+    CAPSENSE_SIGNAL_STAMP(CAPSENSE_SCAN);
+#if APP_CAPSENSE_TASK_NOTIFY
+    xTaskNotifyFromISR(capsense_task_handle, CAPSENSE_NOTIFY_SCAN, eSetBits,
+                       &xHigherPriorityTaskWoken);
+#else
+    capsense_command_t command = CAPSENSE_SCAN;
+    event_ring_push_from_isr(&capsense_command_ring, &command, &xHigherPriorityTaskWoken);
+#endif
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 
@@ -406,7 +847,11 @@ static void capsense_timer_callback(TimerHandle_t xTimer)
 *******************************************************************************/
 static void capsense_isr(void)
 {
+    RUNTIME_STATS_ISR_ENTER();
+    RTOS_TRACE_ISR_ENTER(&cy_capsense_context);
     Cy_CapSense_InterruptHandler(CYBSP_CSD_HW, &cy_capsense_context);
+    RTOS_TRACE_ISR_EXIT(&cy_capsense_context);
+    RUNTIME_STATS_ISR_EXIT();
 }
 
 
@@ -421,7 +866,7 @@ static void tuner_init(void)
 {
     cy_rslt_t result;
     /* Configure Capsense Tuner as EzI2C Slave */
-    sEzI2C_sub_cfg.buf = (uint8 *)&cy_capsense_tuner;
+    sEzI2C_sub_cfg.buf = (uint8 *)TUNER_SYNC_BUFFER();
     sEzI2C_sub_cfg.buf_rw_boundary = sizeof(cy_capsense_tuner);
     sEzI2C_sub_cfg.buf_size = sizeof(cy_capsense_tuner);
     sEzI2C_sub_cfg.slave_address = 8U;
@@ -430,7 +875,14 @@ static void tuner_init(void)
     sEzI2C_cfg.enable_wake_from_sleep = true;
     sEzI2C_cfg.slave1_cfg = sEzI2C_sub_cfg;
     sEzI2C_cfg.sub_address_size = CYHAL_EZI2C_SUB_ADDR16_BITS;
-    sEzI2C_cfg.two_addresses = false;
+
+    /* Expose the read-only diagnostics buffer on the second slave address */
+    sEzI2C_diag_cfg.buf = (uint8 *)&diag_i2c_map;
+    sEzI2C_diag_cfg.buf_rw_boundary = 0u;
+    sEzI2C_diag_cfg.buf_size = sizeof(diag_i2c_map);
+    sEzI2C_diag_cfg.slave_address = DIAG_I2C_SLAVE_ADDRESS;
+    sEzI2C_cfg.slave2_cfg = sEzI2C_diag_cfg;
+    sEzI2C_cfg.two_addresses = true;
     result = cyhal_ezi2c_init( &sEzI2C, CYBSP_I2C_SDA, CYBSP_I2C_SCL, NULL, &sEzI2C_cfg);
     if (result != CY_RSLT_SUCCESS)
     {
@@ -50,9 +50,13 @@
 /*******************************************************************************
  * Header file includes
  ******************************************************************************/
+#include <stdbool.h>
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "event_ring.h"
+#include "event_bus.h"
+#include "app_config.h"
 
 
 /*******************************************************************************
@@ -65,16 +69,63 @@ typedef enum
 } capsense_command_t;
 
 
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Capacity of the CapSense command ring, must be a power of two */
+#define CAPSENSE_COMMAND_RING_SIZE  (8u)
+
+/* Notification bits of the commands with APP_CAPSENSE_TASK_NOTIFY */
+#define CAPSENSE_NOTIFY_SCAN        (1u << CAPSENSE_SCAN)
+#define CAPSENSE_NOTIFY_PROCESS     (1u << CAPSENSE_PROCESS)
+#define CAPSENSE_NOTIFY_ALL         (CAPSENSE_NOTIFY_SCAN | CAPSENSE_NOTIFY_PROCESS)
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Cost of signalling task_capsense, measured with APP_SIGNAL_BENCH. A hop
+ * runs from the sender's signal call until task_capsense has woken up with
+ * the command; all values are in cycle counter ticks.
+ */
+typedef struct
+{
+    uint32_t mode;              /* APP_CAPSENSE_TASK_NOTIFY of the build */
+    uint32_t scan_cycles;       /* Scan cycles measured */
+    uint32_t scan_hop_avg;      /* Scan tick -> task_capsense */
+    uint32_t process_hop_avg;   /* End-of-scan callback -> task_capsense */
+    uint32_t cycle_avg;         /* Both hops of one scan cycle */
+    uint32_t cycle_max;
+} capsense_signal_stats_t;
+
+/* Frame counters, published in the diagnostics map. A frame is one pass over
+ * the widgets planned for a scan tick. A scan tick that arrives while a
+ * frame is in progress is deferred until the frame completes; a further tick
+ * before then is merged into the deferred one and counted as an overrun.
+ */
+typedef struct
+{
+    uint32_t pipelined;         /* APP_CAPSENSE_PIPELINE of the build */
+    uint32_t frames;
+    uint32_t deferred_ticks;
+    uint32_t overruns;
+    uint32_t frame_us_avg;      /* Frame start to the end of processing */
+    uint32_t frame_us_max;
+} capsense_frame_stats_t;
+
+
 /*******************************************************************************
  * Global variable
  ******************************************************************************/
-extern QueueHandle_t capsense_command_q;
+extern event_ring_t capsense_command_ring;
+extern event_bus_t touch_bus;
 
 
 /*******************************************************************************
  * Function prototype
  ******************************************************************************/
 void task_capsense(void* param);
+bool capsense_is_busy(void);
 
 
 #endif /* SOURCE_CAPSENSE_TASK_H_ */
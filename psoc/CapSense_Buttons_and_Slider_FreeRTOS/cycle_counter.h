@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name: cycle_counter.h
+*
+* Description: Free-running cycle counter used for timestamps. On the target
+*              this is the DWT cycle counter of the CM4; in the host
+*              simulation build it is CLOCK_MONOTONIC in nanoseconds.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_CYCLE_COUNTER_H_
+#define SOURCE_CYCLE_COUNTER_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "cybsp.h"
+#if defined(HOST_SIM)
+#include <time.h>
+#endif
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#if defined(HOST_SIM)
+#define CYCLE_COUNTER_HZ    (1000000000u)
+#else
+#define CYCLE_COUNTER_HZ    (SystemCoreClock)
+#endif
+
+
+/*******************************************************************************
+* Function Name: cycle_counter_init
+********************************************************************************
+* Summary:
+*  Enables the cycle counter. Must be called before cycle_counter_get(); may
+*  be called again, as the count is not reset.
+*
+*******************************************************************************/
+static inline void cycle_counter_init(void)
+{
+#if !defined(HOST_SIM)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: cycle_counter_get
+********************************************************************************
+* Summary:
+*  Returns the current counter value. The counter wraps at 32 bits, so only
+*  differences between two readings are meaningful.
+*
+*******************************************************************************/
+static inline uint32_t cycle_counter_get(void)
+{
+#if defined(HOST_SIM)
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: cycle_counter_to_us
+********************************************************************************
+* Summary:
+*  Converts a cycle count difference to microseconds.
+*
+*******************************************************************************/
+static inline uint32_t cycle_counter_to_us(uint32_t cycles)
+{
+    return cycles / (CYCLE_COUNTER_HZ / 1000000u);
+}
+
+
+#endif /* SOURCE_CYCLE_COUNTER_H_ */
+
+
+/* [] END OF FILE */
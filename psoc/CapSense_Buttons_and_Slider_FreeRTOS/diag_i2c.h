@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: diag_i2c.h
+*
+* Description: Layout of the diagnostics buffer exposed on the second EzI2C
+*              slave address. The CapSense Tuner keeps slave address 8; host
+*              tools read this map from DIAG_I2C_SLAVE_ADDRESS with the same
+*              16-bit sub-address.
+*
+*              The layout does not depend on build options: regions of
+*              disabled features stay in place and read as zero. New regions
+*              are only ever appended, and DIAG_I2C_VERSION is bumped.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_DIAG_I2C_H_
+#define SOURCE_DIAG_I2C_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "latency_trace.h"
+#include "event_ring.h"
+#include "capsense_task.h"
+#include "scan_scheduler.h"
+#include "power_mgr.h"
+#include "touch_filter.h"
+#include "telemetry.h"
+#include "mem_report.h"
+#include "scan_planner.h"
+#include "runtime_stats.h"
+#include "isr_profile.h"
+#include "tuner_sync.h"
+#include "ipc_ring.h"
+#include "led_effect.h"
+#include "event_bus.h"
+#include "boot_profile.h"
+#include "baseline_store.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define DIAG_I2C_SLAVE_ADDRESS      (9u)
+#define DIAG_I2C_MAGIC              (0x44494147u)   /* "DIAG" */
+#define DIAG_I2C_VERSION            (19u)
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    latency_report_t latency;
+    event_ring_stats_t capsense_ring;
+    event_ring_stats_t led_ring;
+    uint32_t led_coalesced;     /* Brightness updates superseded in a batch */
+    capsense_signal_stats_t capsense_signal;
+    scan_scheduler_stats_t scan_scheduler;
+    power_mgr_stats_t power;
+    touch_filter_stats_t touch_filter;
+    telemetry_ring_t telemetry;
+    mem_report_t mem;
+    capsense_frame_stats_t capsense_frame;
+    scan_planner_stats_t scan_planner;
+    runtime_stats_t runtime;
+    isr_profile_t isr_profile;
+    tuner_sync_stats_t tuner_sync;
+    ipc_ring_stats_t ipc_ring;
+    led_effect_stats_t led_effect;
+    event_bus_ring_t touch_bus;
+    boot_profile_t boot;
+    baseline_store_stats_t baseline_store;
+} diag_i2c_map_t;
+
+
+/*******************************************************************************
+ * Global variable
+ ******************************************************************************/
+extern diag_i2c_map_t diag_i2c_map;
+
+
+#endif /* SOURCE_DIAG_I2C_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,224 @@
+/******************************************************************************
+* File Name: event_bus.c
+*
+* Description: Publish/subscribe bus of touch events with a single producer
+*              and up to EVENT_BUS_MAX_SUBSCRIBERS subscribers.
+*
+*              The producer writes each event once, into the next slot of a
+*              shared ring, and every subscriber reads it in place through
+*              its own cursor. The producer never waits for subscribers: a
+*              subscriber more than EVENT_BUS_SIZE events behind skips to the
+*              oldest event still on the bus and counts the skipped ones as
+*              overruns. Because a slot may be rewritten while a subscriber
+*              reads it, the producer clears the sequence number of the slot
+*              before rewriting it and sets it when done; the subscriber
+*              checks the sequence number after reading the event, and
+*              discards the event if it changed.
+*
+*              Subscribers with a task are woken through its task
+*              notification value, as for the event rings.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <string.h>
+#include "event_bus.h"
+#include "cybsp.h"
+#include "cycle_counter.h"
+#include "rtos_trace.h"
+
+
+/*******************************************************************************
+* Function Name: event_bus_slot
+********************************************************************************
+* Summary:
+*  Slot of the event with the given sequence number.
+*
+*******************************************************************************/
+static inline event_bus_event_t *event_bus_slot(event_bus_ring_t *ring, uint32_t seq)
+{
+    return &ring->event[seq & (EVENT_BUS_SIZE - 1u)];
+}
+
+
+/*******************************************************************************
+* Function Name: event_bus_init
+********************************************************************************
+* Summary:
+*  Initializes an empty bus without subscribers.
+*
+* Parameters:
+*  event_bus_t *bus       : Bus to initialize
+*  event_bus_ring_t *ring : Events and counters of the bus
+*
+*******************************************************************************/
+void event_bus_init(event_bus_t *bus, event_bus_ring_t *ring)
+{
+    _Static_assert(0u == (EVENT_BUS_SIZE & (EVENT_BUS_SIZE - 1u)),
+                   "EVENT_BUS_SIZE must be a power of two");
+
+    memset(ring, 0, sizeof(*ring));
+    ring->events = EVENT_BUS_SIZE;
+    bus->ring = ring;
+    memset(bus->task, 0, sizeof(bus->task));
+}
+
+
+/*******************************************************************************
+* Function Name: event_bus_subscribe
+********************************************************************************
+* Summary:
+*  Adds a subscriber, which reads the events published from now on. Must be
+*  called before the producer starts.
+*
+* Parameters:
+*  event_bus_t *bus     : Bus to subscribe to
+*  event_bus_sub_t *sub : Read position of the subscriber
+*  TaskHandle_t task    : Task notified on publication, or NULL if the
+*                         subscriber polls
+*
+*******************************************************************************/
+void event_bus_subscribe(event_bus_t *bus, event_bus_sub_t *sub, TaskHandle_t task)
+{
+    event_bus_ring_t *ring = bus->ring;
+    uint32_t index = ring->subscribers;
+
+    CY_ASSERT(index < EVENT_BUS_MAX_SUBSCRIBERS);
+
+    bus->task[index] = task;
+    sub->ring = ring;
+    sub->cursor = ring->head + 1u;
+    sub->stats = &ring->sub[index];
+    ring->subscribers = (uint16_t)(index + 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: event_bus_claim
+********************************************************************************
+* Summary:
+*  Returns the slot of the next event for the producer to fill in. The slot
+*  holds the oldest event on the bus, which becomes invalid here.
+*
+*******************************************************************************/
+event_bus_event_t *event_bus_claim(event_bus_t *bus)
+{
+    event_bus_event_t *event = event_bus_slot(bus->ring, bus->ring->head + 1u);
+
+    event->seq = 0u;
+
+    /* Orders the invalidation before the stores of the new event */
+    __DMB();
+    return event;
+}
+
+
+/*******************************************************************************
+* Function Name: event_bus_publish
+********************************************************************************
+* Summary:
+*  Publishes the event filled in after event_bus_claim() and wakes the
+*  subscribers. Never blocks. Must only be called by the producer.
+*
+*******************************************************************************/
+void event_bus_publish(event_bus_t *bus, event_bus_event_t *event)
+{
+    event_bus_ring_t *ring = bus->ring;
+    uint32_t seq = ring->head + 1u;
+
+    event->timestamp = cycle_counter_get();
+    __DMB();
+    event->seq = seq;
+    ring->head = seq;
+    RTOS_TRACE_OBJECT(RTOS_TRACE_BUS_PUBLISH, ring, seq);
+
+    for (uint32_t i = 0u; i < ring->subscribers; i++)
+    {
+        if (NULL != bus->task[i])
+        {
+            xTaskNotifyGive(bus->task[i]);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: event_bus_peek
+********************************************************************************
+* Summary:
+*  Returns the oldest unread event of a subscriber, in place. The event must
+*  be released with event_bus_release() before it is trusted.
+*
+* Return:
+*  The event, or NULL if the subscriber has read all events
+*
+*******************************************************************************/
+const event_bus_event_t *event_bus_peek(event_bus_sub_t *sub)
+{
+    event_bus_sub_stats_t *stats = sub->stats;
+    uint32_t unread = (sub->ring->head + 1u) - sub->cursor;
+
+    if (0u == unread)
+    {
+        return NULL;
+    }
+    if (unread > EVENT_BUS_SIZE)
+    {
+        /* The oldest unread events are overwritten already */
+        stats->overruns += unread - EVENT_BUS_SIZE;
+        sub->cursor += unread - EVENT_BUS_SIZE;
+        unread = EVENT_BUS_SIZE;
+    }
+
+    stats->lag = unread;
+    if (unread > stats->lag_max)
+    {
+        stats->lag_max = unread;
+    }
+
+    /* Orders the load of head before the loads of the event */
+    __DMB();
+    return event_bus_slot(sub->ring, sub->cursor);
+}
+
+
+/*******************************************************************************
+* Function Name: event_bus_release
+********************************************************************************
+* Summary:
+*  Moves the subscriber past the event returned by event_bus_peek().
+*
+* Return:
+*  true if the event was intact while it was read, false if the producer
+*  rewrote it meanwhile; the event is then lost and counted as an overrun
+*
+*******************************************************************************/
+bool event_bus_release(event_bus_sub_t *sub)
+{
+    const event_bus_event_t *event = event_bus_slot(sub->ring, sub->cursor);
+    bool intact;
+
+    /* Orders the loads of the event before the check of its sequence number */
+    __DMB();
+    intact = (event->seq == sub->cursor);
+    sub->cursor++;
+
+    if (intact)
+    {
+        sub->stats->read++;
+        RTOS_TRACE_OBJECT(RTOS_TRACE_BUS_READ, sub->ring, event->seq);
+    }
+    else
+    {
+        sub->stats->overruns++;
+    }
+    return intact;
+}
+
+
+/* [] END OF FILE */
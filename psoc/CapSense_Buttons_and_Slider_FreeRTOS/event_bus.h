@@ -0,0 +1,120 @@
+/******************************************************************************
+* File Name: event_bus.h
+*
+* Description: This file is the public interface of event_bus.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_EVENT_BUS_H_
+#define SOURCE_EVENT_BUS_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_config.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Events kept on the bus, must be a power of two. A subscriber that falls
+ * further behind loses the oldest events.
+ */
+#ifndef EVENT_BUS_SIZE
+#define EVENT_BUS_SIZE              (16u)
+#endif
+
+/* Subscribers of one bus */
+#define EVENT_BUS_MAX_SUBSCRIBERS   (4u)
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Touch result of one scan. seq is non-zero and equal to the position of the
+ * event on the bus while the event is valid; the producer clears it before it
+ * rewrites the slot.
+ */
+typedef struct
+{
+    volatile uint32_t seq;
+    uint32_t timestamp;         /* Cycle counter at publication */
+    uint8_t widget_id;
+    uint8_t touch_event;        /* touch_event_t */
+    uint8_t led_command;        /* led_command_t requested by the touch action */
+    uint8_t reserved;
+    uint32_t brightness;        /* For LED_UPDATE_BRIGHTNESS */
+} event_bus_event_t;
+
+/* Counters of one subscriber, written by the subscriber only */
+typedef struct
+{
+    uint32_t read;              /* Events read intact */
+    uint32_t lag;               /* Unread events at the last read */
+    uint32_t lag_max;
+    uint32_t overruns;          /* Events overwritten before they were read */
+} event_bus_sub_stats_t;
+
+/* Events and counters of a bus, published in the diagnostics map. head is the
+ * sequence number of the newest event, which is stored in
+ * event[head % EVENT_BUS_SIZE]; a host reads the events in place like any
+ * other subscriber.
+ */
+typedef struct
+{
+    volatile uint32_t head;
+    uint16_t events;            /* EVENT_BUS_SIZE */
+    uint16_t subscribers;
+    event_bus_sub_stats_t sub[EVENT_BUS_MAX_SUBSCRIBERS];
+    event_bus_event_t event[EVENT_BUS_SIZE];
+} event_bus_ring_t;
+
+/* Bus with a single producer. Subscribers are added before the scheduler
+ * starts.
+ */
+typedef struct
+{
+    event_bus_ring_t *ring;
+    TaskHandle_t task[EVENT_BUS_MAX_SUBSCRIBERS];   /* Notified on publication */
+} event_bus_t;
+
+/* Read position of one subscriber, only accessed by the subscriber */
+typedef struct
+{
+    event_bus_ring_t *ring;
+    uint32_t cursor;            /* Sequence number of the next event to read */
+    event_bus_sub_stats_t *stats;
+} event_bus_sub_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void event_bus_init(event_bus_t *bus, event_bus_ring_t *ring);
+void event_bus_subscribe(event_bus_t *bus, event_bus_sub_t *sub, TaskHandle_t task);
+
+/* Producer */
+event_bus_event_t *event_bus_claim(event_bus_t *bus);
+void event_bus_publish(event_bus_t *bus, event_bus_event_t *event);
+
+/* Subscribers */
+const event_bus_event_t *event_bus_peek(event_bus_sub_t *sub);
+bool event_bus_release(event_bus_sub_t *sub);
+
+
+#endif /* SOURCE_EVENT_BUS_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,227 @@
+/******************************************************************************
+* File Name: event_ring.c
+*
+* Description: Lock-free ring of fixed-size events between producers in task
+*              or interrupt context and a single consumer task.
+*
+*              The consumer side never locks: it reads head, copies out every
+*              pending event and publishes the new tail. Events are never
+*              overwritten; a full ring rejects the new event and counts it
+*              as dropped. A ring may have at most one task-context producer,
+*              plus interrupt-context producers that share one interrupt
+*              priority and so cannot pre-empt each other. The task-context
+*              push masks interrupts for the few instructions that reserve
+*              and fill the slot, so the two kinds cannot interleave.
+*
+*              The consumer is woken through its task notification value, so
+*              a producer never blocks and a burst of events costs a single
+*              wake-up.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <string.h>
+#include "event_ring.h"
+#include "cybsp.h"
+#include "rtos_trace.h"
+
+
+/*******************************************************************************
+* Function Name: event_ring_init
+********************************************************************************
+* Summary:
+*  Initializes an empty ring over caller-provided storage.
+*
+* Parameters:
+*  event_ring_t *ring         : Ring to initialize
+*  void *storage              : capacity * item_size bytes
+*  uint32_t item_size         : Size of one event in bytes
+*  uint32_t capacity          : Number of events, must be a power of two
+*  event_ring_stats_t *stats  : Counters of the ring
+*
+*******************************************************************************/
+void event_ring_init(event_ring_t *ring, void *storage, uint32_t item_size,
+                     uint32_t capacity, event_ring_stats_t *stats)
+{
+    CY_ASSERT((0u != capacity) && (0u == (capacity & (capacity - 1u))));
+
+    ring->storage = (uint8_t *)storage;
+    ring->item_size = item_size;
+    ring->capacity = capacity;
+    ring->head = 0u;
+    ring->tail = 0u;
+    ring->consumer = NULL;
+    ring->stats = stats;
+    memset(stats, 0, sizeof(*stats));
+}
+
+
+/*******************************************************************************
+* Function Name: event_ring_set_consumer
+********************************************************************************
+* Summary:
+*  Registers the task that is notified when events are pushed. Events pushed
+*  before a consumer is registered stay in the ring.
+*
+*******************************************************************************/
+void event_ring_set_consumer(event_ring_t *ring, TaskHandle_t consumer)
+{
+    ring->consumer = consumer;
+}
+
+
+/*******************************************************************************
+* Function Name: event_ring_store
+********************************************************************************
+* Summary:
+*  Copies an event into the next free slot and publishes it. The caller
+*  guarantees that no other producer runs concurrently.
+*
+*******************************************************************************/
+static bool event_ring_store(event_ring_t *ring, const void *item)
+{
+    uint32_t head = ring->head;
+    uint32_t used = head - ring->tail;
+
+    if (used >= ring->capacity)
+    {
+        ring->stats->dropped++;
+        RTOS_TRACE_OBJECT(RTOS_TRACE_RING_DROP, ring, ring->capacity);
+        return false;
+    }
+
+    memcpy(&ring->storage[(head & (ring->capacity - 1u)) * ring->item_size],
+           item, ring->item_size);
+    __DMB();
+    ring->head = head + 1u;
+    RTOS_TRACE_OBJECT(RTOS_TRACE_RING_PUSH, ring, used + 1u);
+
+    ring->stats->pushed++;
+    if ((used + 1u) > ring->stats->high_water)
+    {
+        ring->stats->high_water = used + 1u;
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: event_ring_push
+********************************************************************************
+* Summary:
+*  Pushes an event from task context and notifies the consumer. Never blocks.
+*
+* Return:
+*  true if the event was stored, false if the ring was full
+*
+*******************************************************************************/
+bool event_ring_push(event_ring_t *ring, const void *item)
+{
+    bool stored;
+
+    taskENTER_CRITICAL();
+    stored = event_ring_store(ring, item);
+    taskEXIT_CRITICAL();
+
+    if (stored && (NULL != ring->consumer))
+    {
+        xTaskNotifyGive(ring->consumer);
+    }
+    return stored;
+}
+
+
+/*******************************************************************************
+* Function Name: event_ring_push_from_isr
+********************************************************************************
+* Summary:
+*  Pushes an event from interrupt context and notifies the consumer.
+*
+* Return:
+*  true if the event was stored, false if the ring was full
+*
+*******************************************************************************/
+bool event_ring_push_from_isr(event_ring_t *ring, const void *item,
+                              BaseType_t *higher_priority_task_woken)
+{
+    bool stored = event_ring_store(ring, item);
+
+    if (stored && (NULL != ring->consumer))
+    {
+        vTaskNotifyGiveFromISR(ring->consumer, higher_priority_task_woken);
+    }
+    return stored;
+}
+
+
+/*******************************************************************************
+* Function Name: event_ring_pop_batch
+********************************************************************************
+* Summary:
+*  Copies up to max_items pending events, oldest first, and releases their
+*  slots. Must only be called by the consumer task.
+*
+* Return:
+*  Number of events copied
+*
+*******************************************************************************/
+uint32_t event_ring_pop_batch(event_ring_t *ring, void *items, uint32_t max_items)
+{
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+    uint8_t *dst = (uint8_t *)items;
+
+    if (count > max_items)
+    {
+        count = max_items;
+    }
+    if (0u == count)
+    {
+        return 0u;
+    }
+    __DMB();
+
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        memcpy(dst, &ring->storage[((tail + i) & (ring->capacity - 1u)) * ring->item_size],
+               ring->item_size);
+        dst += ring->item_size;
+    }
+
+    __DMB();
+    ring->tail = tail + count;
+    ring->stats->batches++;
+    RTOS_TRACE_OBJECT(RTOS_TRACE_RING_POP, ring, count);
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: event_ring_wait
+********************************************************************************
+* Summary:
+*  Blocks the consumer task until at least one event is pending, then drains
+*  up to max_items events like event_ring_pop_batch().
+*
+* Return:
+*  Number of events copied (at least one)
+*
+*******************************************************************************/
+uint32_t event_ring_wait(event_ring_t *ring, void *items, uint32_t max_items)
+{
+    uint32_t count;
+
+    while (0u == (count = event_ring_pop_batch(ring, items, max_items)))
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    return count;
+}
+
+
+/* [] END OF FILE */
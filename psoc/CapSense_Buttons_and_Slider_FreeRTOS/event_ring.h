@@ -0,0 +1,71 @@
+/******************************************************************************
+* File Name: event_ring.h
+*
+* Description: This file is the public interface of event_ring.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_EVENT_RING_H_
+#define SOURCE_EVENT_RING_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Counters of one ring, published in the diagnostics map */
+typedef struct
+{
+    uint32_t pushed;        /* Events accepted by the ring */
+    uint32_t dropped;       /* Events rejected because the ring was full */
+    uint32_t high_water;    /* Highest fill level observed by a producer */
+    uint32_t batches;       /* Non-empty batches drained by the consumer */
+} event_ring_stats_t;
+
+/* Ring of fixed-size events. head is only written by producers, tail only by
+ * the consumer; both run freely and are reduced modulo the capacity.
+ */
+typedef struct
+{
+    uint8_t *storage;
+    uint32_t item_size;
+    uint32_t capacity;      /* Must be a power of two */
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    TaskHandle_t consumer;
+    event_ring_stats_t *stats;
+} event_ring_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void event_ring_init(event_ring_t *ring, void *storage, uint32_t item_size,
+                     uint32_t capacity, event_ring_stats_t *stats);
+void event_ring_set_consumer(event_ring_t *ring, TaskHandle_t consumer);
+bool event_ring_push(event_ring_t *ring, const void *item);
+bool event_ring_push_from_isr(event_ring_t *ring, const void *item,
+                              BaseType_t *higher_priority_task_woken);
+uint32_t event_ring_pop_batch(event_ring_t *ring, void *items, uint32_t max_items);
+uint32_t event_ring_wait(event_ring_t *ring, void *items, uint32_t max_items);
+
+
+#endif /* SOURCE_EVENT_RING_H_ */
+
+
+/* [] END OF FILE */
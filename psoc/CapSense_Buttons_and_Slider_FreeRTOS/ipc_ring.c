@@ -0,0 +1,244 @@
+/******************************************************************************
+* File Name: ipc_ring.c
+*
+* Description: Event ring between the two CPU cores. The ring lives in the
+*              shared memory section, so both the CM0+ and the CM4 image can
+*              reach it, and depends on the PDL only; the same file builds
+*              into either image.
+*
+*              The producer publishes an event by advancing head, the
+*              consumer releases it by advancing tail, with a memory barrier
+*              between the data and the index. When the consumer runs out of
+*              events it sets waiting and checks the ring once more before it
+*              sleeps; the producer checks waiting after publishing and then
+*              raises the notify event of IPC_RING_CHANNEL. Because each side
+*              writes its flag before it reads the other's, at least one of
+*              them sees the other, and no wake-up is lost. The channel lock
+*              stays held until the consumer acknowledges the doorbell, so
+*              further events only raise another interrupt after that.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <string.h>
+#include "ipc_ring.h"
+
+
+/*******************************************************************************
+* Function Name: ipc_ring_init
+********************************************************************************
+* Summary:
+*  Initializes a ring and publishes its address in the data register of
+*  IPC_RING_CHANNEL. Called by the consumer before the producer attaches; the
+*  shared memory section is not cleared at start-up.
+*
+* Parameters:
+*  ipc_ring_t *ring   : Ring in the shared memory section
+*  uint32_t item_size : Size of one event in bytes, at most IPC_RING_ITEM_SIZE
+*
+*******************************************************************************/
+void ipc_ring_init(ipc_ring_t *ring, uint32_t item_size)
+{
+    CY_ASSERT((0u != item_size) && (item_size <= IPC_RING_ITEM_SIZE));
+
+    memset(ring, 0, sizeof(*ring));
+    ring->item_size = item_size;
+    __DMB();
+    ring->magic = IPC_RING_MAGIC;
+
+    Cy_IPC_Drv_WriteDataValue(Cy_IPC_Drv_GetIpcBaseAddress(IPC_RING_CHANNEL),
+                              (uintptr_t)ring);
+}
+
+
+/*******************************************************************************
+* Function Name: ipc_ring_enable_doorbell
+********************************************************************************
+* Summary:
+*  Routes the notify event of IPC_RING_CHANNEL to the interrupt of the
+*  consumer core. isr must call ipc_ring_doorbell_ack().
+*
+* Parameters:
+*  cy_israddress isr  : Doorbell interrupt handler
+*  uint32_t priority  : Priority of the interrupt
+*
+*******************************************************************************/
+void ipc_ring_enable_doorbell(cy_israddress isr, uint32_t priority)
+{
+    const cy_stc_sysint_t intr_config =
+    {
+        .intrSrc = IPC_RING_IRQN,
+        .intrPriority = priority,
+    };
+
+    Cy_IPC_Drv_SetInterruptMask(Cy_IPC_Drv_GetIntrBaseAddr(IPC_RING_INTR),
+                                CY_IPC_NO_NOTIFICATION, 1u << IPC_RING_CHANNEL);
+    Cy_SysInt_Init(&intr_config, isr);
+    NVIC_ClearPendingIRQ(intr_config.intrSrc);
+    NVIC_EnableIRQ(intr_config.intrSrc);
+}
+
+
+/*******************************************************************************
+* Function Name: ipc_ring_attach
+********************************************************************************
+* Summary:
+*  Looks up the ring published by the consumer core.
+*
+* Return:
+*  The ring, or NULL while the consumer has not initialized it yet
+*
+*******************************************************************************/
+ipc_ring_t *ipc_ring_attach(void)
+{
+    ipc_ring_t *ring = (ipc_ring_t *)Cy_IPC_Drv_ReadDataValue(
+                           Cy_IPC_Drv_GetIpcBaseAddress(IPC_RING_CHANNEL));
+
+    if ((NULL == ring) || (IPC_RING_MAGIC != ring->magic))
+    {
+        return NULL;
+    }
+    __DMB();
+    return ring;
+}
+
+
+/*******************************************************************************
+* Function Name: ipc_ring_push
+********************************************************************************
+* Summary:
+*  Publishes an event and rings the doorbell if the consumer is waiting.
+*  Never blocks. Must only be called by the producer.
+*
+* Return:
+*  true if the event was stored, false if the ring was full
+*
+*******************************************************************************/
+bool ipc_ring_push(ipc_ring_t *ring, const void *item)
+{
+    uint32_t head = ring->head;
+    uint32_t used = head - ring->tail;
+
+    if (used >= IPC_RING_SIZE)
+    {
+        ring->stats.dropped++;
+        return false;
+    }
+
+    memcpy(ring->storage[head & (IPC_RING_SIZE - 1u)], item, ring->item_size);
+    __DMB();
+    ring->head = head + 1u;
+
+    ring->stats.pushed++;
+    if ((used + 1u) > ring->stats.high_water)
+    {
+        ring->stats.high_water = used + 1u;
+    }
+
+    /* Orders the store of head before the load of waiting */
+    __DMB();
+    if (0u != ring->waiting)
+    {
+        /* Fails while the previous doorbell is not acknowledged */
+        if (CY_IPC_DRV_SUCCESS == Cy_IPC_Drv_AcquireNotify(
+                Cy_IPC_Drv_GetIpcBaseAddress(IPC_RING_CHANNEL), 1u << IPC_RING_INTR))
+        {
+            ring->stats.doorbells++;
+        }
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: ipc_ring_pop_batch
+********************************************************************************
+* Summary:
+*  Copies up to max_items pending events, oldest first, and releases their
+*  slots. Must only be called by the consumer.
+*
+* Return:
+*  Number of events copied
+*
+*******************************************************************************/
+uint32_t ipc_ring_pop_batch(ipc_ring_t *ring, void *items, uint32_t max_items)
+{
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+    uint8_t *dst = (uint8_t *)items;
+
+    if (count > max_items)
+    {
+        count = max_items;
+    }
+    if (0u == count)
+    {
+        return 0u;
+    }
+    __DMB();
+
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        memcpy(dst, ring->storage[(tail + i) & (IPC_RING_SIZE - 1u)], ring->item_size);
+        dst += ring->item_size;
+    }
+
+    __DMB();
+    ring->tail = tail + count;
+    ring->stats.batches++;
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: ipc_ring_arm
+********************************************************************************
+* Summary:
+*  Asks the producer for a doorbell before the consumer sleeps.
+*
+* Return:
+*  true if the ring is still empty and the consumer may sleep until the
+*  doorbell; false if events arrived meanwhile
+*
+*******************************************************************************/
+bool ipc_ring_arm(ipc_ring_t *ring)
+{
+    ring->waiting = 1u;
+
+    /* Orders the store of waiting before the load of head */
+    __DMB();
+    if (ring->head != ring->tail)
+    {
+        ring->waiting = 0u;
+        return false;
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: ipc_ring_doorbell_ack
+********************************************************************************
+* Summary:
+*  Acknowledges the doorbell from the consumer's interrupt handler and
+*  releases the channel for the next one.
+*
+*******************************************************************************/
+void ipc_ring_doorbell_ack(ipc_ring_t *ring)
+{
+    Cy_IPC_Drv_ClearInterrupt(Cy_IPC_Drv_GetIntrBaseAddr(IPC_RING_INTR),
+                              CY_IPC_NO_NOTIFICATION, 1u << IPC_RING_CHANNEL);
+    ring->waiting = 0u;
+    ring->stats.wakeups++;
+    __DMB();
+    (void)Cy_IPC_Drv_LockRelease(Cy_IPC_Drv_GetIpcBaseAddress(IPC_RING_CHANNEL),
+                                 CY_IPC_NO_NOTIFICATION);
+}
+
+
+/* [] END OF FILE */
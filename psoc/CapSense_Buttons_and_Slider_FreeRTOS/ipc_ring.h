@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: ipc_ring.h
+*
+* Description: This file is the public interface of ipc_ring.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_IPC_RING_H_
+#define SOURCE_IPC_RING_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cybsp.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Capacity of a ring, must be a power of two */
+#define IPC_RING_SIZE               (16u)
+
+/* Largest event a ring can carry */
+#define IPC_RING_ITEM_SIZE          (8u)
+
+#define IPC_RING_MAGIC              (0x49504352u)   /* "IPCR" */
+
+/* IPC channel whose lock and notify event form the doorbell, and the IPC
+ * interrupt structure it notifies. The channel's data register holds the
+ * address of the ring for the producer core.
+ */
+#define IPC_RING_CHANNEL            (CY_IPC_CHAN_USER)
+#define IPC_RING_INTR               (CY_IPC_INTR_USER)
+#define IPC_RING_IRQN               ((IRQn_Type)((uint32_t)cpuss_interrupts_ipc_0_IRQn + \
+                                                 IPC_RING_INTR))
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Counters of a ring. Each field is written by one core only. */
+typedef struct
+{
+    uint32_t pushed;            /* Producer: events accepted */
+    uint32_t dropped;           /* Producer: events rejected, ring full */
+    uint32_t high_water;        /* Producer: highest fill level */
+    uint32_t doorbells;         /* Producer: IPC notify events raised */
+    uint32_t batches;           /* Consumer: non-empty batches drained */
+    uint32_t wakeups;           /* Consumer: doorbells received */
+} ipc_ring_stats_t;
+
+/* Single-producer, single-consumer ring in memory shared by both cores. head
+ * is only written by the producer, tail and waiting only by the consumer;
+ * neither side takes a lock.
+ */
+typedef struct
+{
+    volatile uint32_t magic;    /* IPC_RING_MAGIC once initialized */
+    uint32_t item_size;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t waiting;  /* Consumer is about to sleep; ring the doorbell */
+    ipc_ring_stats_t stats;
+    uint8_t storage[IPC_RING_SIZE][IPC_RING_ITEM_SIZE];
+} ipc_ring_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+/* Consumer core */
+void ipc_ring_init(ipc_ring_t *ring, uint32_t item_size);
+void ipc_ring_enable_doorbell(cy_israddress isr, uint32_t priority);
+uint32_t ipc_ring_pop_batch(ipc_ring_t *ring, void *items, uint32_t max_items);
+bool ipc_ring_arm(ipc_ring_t *ring);
+void ipc_ring_doorbell_ack(ipc_ring_t *ring);
+
+/* Producer core */
+ipc_ring_t *ipc_ring_attach(void);
+bool ipc_ring_push(ipc_ring_t *ring, const void *item);
+
+
+#endif /* SOURCE_IPC_RING_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,210 @@
+/******************************************************************************
+* File Name: isr_profile.c
+*
+* Description: Execution time profile of selected interrupts. Attaching an
+*              interrupt replaces its entry in the RAM vector table with a
+*              wrapper that times the original handler with the cycle
+*              counter, so handlers installed by the HAL (EzI2C) are covered
+*              without changing their code.
+*
+*              Handlers that pre-empt each other are tracked on a small
+*              stack: the time of a nested handler is removed from the one it
+*              interrupted, and both sides are counted. The wrapper costs a
+*              few dozen cycles per interrupt and does not divide; averages
+*              and the share of the scan period are computed by task_capsense
+*              once per frame.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "isr_profile.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cycle_counter.h"
+#include "diag_i2c.h"
+
+
+#if APP_ISR_PROFILE
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+typedef struct
+{
+    cy_israddress handler;          /* Original vector */
+    uint64_t cycles_sum;
+    uint32_t frame_cycles;          /* Cycles since the last frame */
+} isr_profile_slot_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void isr_profile_run(uint32_t slot);
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+/* Written by the wrappers. Handlers nest strictly, so each one finds the
+ * stack as it left it when a nested handler returns.
+ */
+static isr_profile_slot_t isr_profile_slots[ISR_PROFILE_MAX_IRQS];
+static uint32_t isr_profile_stack[ISR_PROFILE_MAX_IRQS];
+static uint32_t isr_profile_nested_cycles[ISR_PROFILE_MAX_IRQS];
+static volatile uint32_t isr_profile_depth;
+
+
+/*******************************************************************************
+* Wrappers installed in the vector table, one per slot
+*******************************************************************************/
+#define ISR_PROFILE_WRAPPER(slot) \
+    static void isr_profile_wrapper_##slot(void) { isr_profile_run(slot##u); }
+
+ISR_PROFILE_WRAPPER(0)
+ISR_PROFILE_WRAPPER(1)
+ISR_PROFILE_WRAPPER(2)
+ISR_PROFILE_WRAPPER(3)
+
+static const cy_israddress isr_profile_wrappers[ISR_PROFILE_MAX_IRQS] =
+{
+    isr_profile_wrapper_0,
+    isr_profile_wrapper_1,
+    isr_profile_wrapper_2,
+    isr_profile_wrapper_3
+};
+
+
+/*******************************************************************************
+* Function Name: isr_profile_run
+********************************************************************************
+* Summary:
+*  Runs and times the original handler of a slot.
+*
+* Parameters:
+*  uint32_t slot : Slot of the interrupt
+*
+*******************************************************************************/
+static void isr_profile_run(uint32_t slot)
+{
+    isr_profile_irq_t *stats = &diag_i2c_map.isr_profile.irq[slot];
+    isr_profile_slot_t *entry = &isr_profile_slots[slot];
+    uint32_t depth = isr_profile_depth;
+    uint32_t start;
+    uint32_t cycles;
+
+    if (0u != depth)
+    {
+        stats->preemptions++;
+        diag_i2c_map.isr_profile.irq[isr_profile_stack[depth - 1u]].preempted++;
+    }
+    if (depth >= diag_i2c_map.isr_profile.depth_max)
+    {
+        diag_i2c_map.isr_profile.depth_max = depth + 1u;
+    }
+    isr_profile_stack[depth] = slot;
+    isr_profile_nested_cycles[depth] = 0u;
+    isr_profile_depth = depth + 1u;
+
+    start = cycle_counter_get();
+    entry->handler();
+    cycles = cycle_counter_get() - start;
+
+    isr_profile_depth = depth;
+    if (0u != depth)
+    {
+        isr_profile_nested_cycles[depth - 1u] += cycles;
+    }
+    cycles = (cycles > isr_profile_nested_cycles[depth]) ?
+             (cycles - isr_profile_nested_cycles[depth]) : 0u;
+
+    entry->cycles_sum += cycles;
+    entry->frame_cycles += cycles;
+    stats->count++;
+    if ((cycles < stats->cycles_min) || (1u == stats->count))
+    {
+        stats->cycles_min = cycles;
+    }
+    if (cycles > stats->cycles_max)
+    {
+        stats->cycles_max = cycles;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: isr_profile_attach
+********************************************************************************
+* Summary:
+*  Starts profiling an interrupt. Call after its handler is installed; the
+*  handler is looked up in the vector table and replaced by a wrapper.
+*
+* Parameters:
+*  IRQn_Type irqn : Interrupt to profile
+*
+*******************************************************************************/
+void isr_profile_attach(IRQn_Type irqn)
+{
+    isr_profile_t *profile = &diag_i2c_map.isr_profile;
+    uint32_t slot = profile->irqs;
+
+    CY_ASSERT(slot < ISR_PROFILE_MAX_IRQS);
+
+    taskENTER_CRITICAL();
+    profile->irq[slot].irqn = (uint32_t)irqn;
+    isr_profile_slots[slot].handler = Cy_SysInt_GetVector(irqn);
+    (void)Cy_SysInt_SetVector(irqn, isr_profile_wrappers[slot]);
+    profile->irqs = slot + 1u;
+    taskEXIT_CRITICAL();
+}
+
+
+/*******************************************************************************
+* Function Name: isr_profile_frame
+********************************************************************************
+* Summary:
+*  Updates the averages and the share of the scan period spent in each
+*  interrupt since the previous frame; called by task_capsense after every
+*  frame.
+*
+* Parameters:
+*  uint32_t period_ms : Scan period in use
+*
+*******************************************************************************/
+void isr_profile_frame(uint32_t period_ms)
+{
+    isr_profile_t *profile = &diag_i2c_map.isr_profile;
+    uint64_t period_cycles = ((uint64_t)period_ms * CYCLE_COUNTER_HZ) / 1000u;
+    uint32_t frame_cycles;
+    uint64_t cycles_sum;
+    uint32_t permille;
+
+    for (uint32_t slot = 0u; slot < profile->irqs; slot++)
+    {
+        isr_profile_irq_t *stats = &profile->irq[slot];
+
+        taskENTER_CRITICAL();
+        frame_cycles = isr_profile_slots[slot].frame_cycles;
+        isr_profile_slots[slot].frame_cycles = 0u;
+        cycles_sum = isr_profile_slots[slot].cycles_sum;
+        stats->cycles_avg = (0u != stats->count) ? (uint32_t)(cycles_sum / stats->count) : 0u;
+        taskEXIT_CRITICAL();
+
+        permille = (0u != period_cycles) ? (uint32_t)(((uint64_t)frame_cycles * 1000u) / period_cycles) : 0u;
+        stats->period_permille = permille;
+        if (permille > stats->period_max_permille)
+        {
+            stats->period_max_permille = permille;
+        }
+    }
+}
+
+#endif /* APP_ISR_PROFILE */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,80 @@
+/******************************************************************************
+* File Name: isr_profile.h
+*
+* Description: This file is the public interface of isr_profile.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_ISR_PROFILE_H_
+#define SOURCE_ISR_PROFILE_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "app_config.h"
+#include "cybsp.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Interrupts that can be profiled; one wrapper each */
+#define ISR_PROFILE_MAX_IRQS        (4u)
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Statistics of one interrupt. Cycles are exclusive: the time of profiled
+ * handlers that pre-empted this one is not included.
+ */
+typedef struct
+{
+    uint32_t irqn;
+    uint32_t count;
+    uint32_t cycles_min;
+    uint32_t cycles_avg;
+    uint32_t cycles_max;
+    uint32_t preemptions;           /* Entries that interrupted another handler */
+    uint32_t preempted;             /* Times this handler was interrupted */
+    uint32_t period_permille;       /* Share of the last scan period */
+    uint32_t period_max_permille;
+} isr_profile_irq_t;
+
+/* Interrupt profile, published in the diagnostics map */
+typedef struct
+{
+    uint32_t irqs;                  /* Entries of irq[] in use */
+    uint32_t depth_max;             /* Deepest nesting of profiled handlers */
+    isr_profile_irq_t irq[ISR_PROFILE_MAX_IRQS];
+} isr_profile_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_ISR_PROFILE
+void isr_profile_attach(IRQn_Type irqn);
+void isr_profile_frame(uint32_t period_ms);
+
+#define ISR_PROFILE_ATTACH(irqn)        isr_profile_attach(irqn)
+#define ISR_PROFILE_FRAME(period_ms)    isr_profile_frame(period_ms)
+#else
+#define ISR_PROFILE_ATTACH(irqn)
+#define ISR_PROFILE_FRAME(period_ms)
+#endif
+
+
+#endif /* SOURCE_ISR_PROFILE_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,302 @@
+/******************************************************************************
+* File Name: latency_trace.c
+*
+* Description: Touch-to-LED latency tracing. Each scan opens a record that is
+*              stamped with the cycle counter as it passes the pipeline
+*              stages. Records that lead to an LED command are pushed into a
+*              lock-free single-producer/single-consumer ring by the CapSense
+*              task and popped by the LED task, which stamps the PWM update
+*              and folds the record into per-stage histograms.
+*
+*              Because the LED ring delivers commands in order, the n-th
+*              record in the ring always belongs to the n-th command the LED
+*              task receives.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "latency_trace.h"
+
+#if APP_LATENCY_TRACE
+
+#include <string.h>
+#include "cybsp.h"
+#include "cycle_counter.h"
+#include "diag_i2c.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define LATENCY_RING_SIZE           (16u)   /* Must be a power of two */
+#define LATENCY_PUBLISH_INTERVAL    (16u)   /* Samples between summary updates */
+#define LATENCY_P50                 (50u)
+#define LATENCY_P99                 (99u)
+
+
+/*******************************************************************************
+* Data structure
+*******************************************************************************/
+typedef struct
+{
+    uint32_t stamp[LATENCY_STAGE_COUNT];
+} latency_record_t;
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+/* Time of the latest scan tick, claimed by the scan it starts */
+static volatile uint32_t latency_tick_stamp;
+
+/* Record of the scan currently travelling through the CapSense task */
+static latency_record_t latency_inflight;
+
+/* Ring written by the CapSense task (head) and read by the LED task (tail) */
+static latency_record_t latency_ring[LATENCY_RING_SIZE];
+static volatile uint32_t latency_ring_head;
+static volatile uint32_t latency_ring_tail;
+
+static uint32_t latency_max_us[LATENCY_STAGE_COUNT - 1u];
+static uint32_t latency_unpublished;
+
+
+/*******************************************************************************
+* Function Name: latency_bucket
+********************************************************************************
+* Summary:
+*  Maps a latency in microseconds to its histogram bucket.
+*
+*******************************************************************************/
+static uint32_t latency_bucket(uint32_t us)
+{
+    uint32_t msb;
+    uint32_t bucket;
+
+    if (us < 4u)
+    {
+        return us;
+    }
+
+    msb = 31u - __CLZ(us);
+    bucket = ((msb - 1u) * 4u) + ((us >> (msb - 2u)) & 3u);
+
+    return (bucket < LATENCY_HIST_BUCKETS) ? bucket : (LATENCY_HIST_BUCKETS - 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: latency_bucket_floor_us
+********************************************************************************
+* Summary:
+*  Returns the smallest latency in microseconds that falls into a bucket.
+*
+*******************************************************************************/
+uint32_t latency_bucket_floor_us(uint32_t bucket)
+{
+    if (bucket < 4u)
+    {
+        return bucket;
+    }
+
+    return (4u + (bucket & 3u)) << ((bucket / 4u) - 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: latency_percentile
+********************************************************************************
+* Summary:
+*  Returns the upper bound of the bucket holding the given percentile.
+*
+*******************************************************************************/
+static uint32_t latency_percentile(const uint32_t *hist, uint32_t samples, uint32_t percent)
+{
+    uint64_t target = (((uint64_t)samples * percent) + 99u) / 100u;
+    uint64_t seen = 0u;
+
+    for (uint32_t bucket = 0u; bucket < LATENCY_HIST_BUCKETS; bucket++)
+    {
+        seen += hist[bucket];
+        if ((seen >= target) && (0u != seen))
+        {
+            return latency_bucket_floor_us(bucket + 1u);
+        }
+    }
+
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: latency_trace_init
+********************************************************************************
+* Summary:
+*  Enables the cycle counter and clears the published report.
+*
+*******************************************************************************/
+void latency_trace_init(void)
+{
+    cycle_counter_init();
+    memset(&diag_i2c_map.latency, 0, sizeof(diag_i2c_map.latency));
+}
+
+
+/*******************************************************************************
+* Function Name: latency_trace_stamp
+********************************************************************************
+* Summary:
+*  Timestamps a stage of the in-flight record. LATENCY_STAGE_TIMER is only
+*  latched, since the next tick may arrive while the previous scan is still
+*  being processed; LATENCY_STAGE_SCAN_START opens a new record with it.
+*  Called from the scan scheduler interrupt, the CapSense task and the
+*  end-of-scan interrupt.
+*
+* Parameters:
+*  latency_stage_t stage : Stage that has just been reached
+*
+*******************************************************************************/
+void latency_trace_stamp(latency_stage_t stage)
+{
+    uint32_t now = cycle_counter_get();
+
+    if (LATENCY_STAGE_TIMER == stage)
+    {
+        latency_tick_stamp = now;
+        return;
+    }
+
+    if (LATENCY_STAGE_SCAN_START == stage)
+    {
+        memset(&latency_inflight, 0, sizeof(latency_inflight));
+        latency_inflight.stamp[LATENCY_STAGE_TIMER] = latency_tick_stamp;
+    }
+
+    latency_inflight.stamp[stage] = now;
+}
+
+
+/*******************************************************************************
+* Function Name: latency_trace_commit
+********************************************************************************
+* Summary:
+*  Pushes the in-flight record into the ring. Called by the CapSense task once
+*  the LED command has been accepted by the LED ring.
+*
+*******************************************************************************/
+void latency_trace_commit(void)
+{
+    uint32_t head = latency_ring_head;
+
+    if ((head - latency_ring_tail) >= LATENCY_RING_SIZE)
+    {
+        diag_i2c_map.latency.dropped++;
+        return;
+    }
+
+    latency_ring[head & (LATENCY_RING_SIZE - 1u)] = latency_inflight;
+    __DMB();
+    latency_ring_head = head + 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: latency_trace_complete
+********************************************************************************
+* Summary:
+*  Pops the record of the command the LED task has just applied, stamps the
+*  PWM update and adds every stage to its histogram. Called by the LED task.
+*
+*******************************************************************************/
+void latency_trace_complete(void)
+{
+    uint32_t now = cycle_counter_get();
+    uint32_t tail = latency_ring_tail;
+    latency_report_t *report = &diag_i2c_map.latency;
+    latency_record_t *record;
+
+    if (tail == latency_ring_head)
+    {
+        return;
+    }
+    __DMB();
+
+    record = &latency_ring[tail & (LATENCY_RING_SIZE - 1u)];
+    record->stamp[LATENCY_STAGE_PWM_UPDATE] = now;
+
+    for (uint32_t stage = LATENCY_STAGE_SCAN_START; stage < LATENCY_STAGE_COUNT; stage++)
+    {
+        uint32_t us = cycle_counter_to_us(record->stamp[stage] - record->stamp[LATENCY_STAGE_TIMER]);
+
+        report->hist[stage - 1u][latency_bucket(us)]++;
+        if (us > latency_max_us[stage - 1u])
+        {
+            latency_max_us[stage - 1u] = us;
+        }
+    }
+
+    __DMB();
+    latency_ring_tail = tail + 1u;
+    report->samples++;
+
+    if (++latency_unpublished >= LATENCY_PUBLISH_INTERVAL)
+    {
+        latency_trace_publish();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: latency_trace_discard
+********************************************************************************
+* Summary:
+*  Pops the record of a command the LED task dropped without applying it, so
+*  that the following records stay aligned with their commands.
+*
+*******************************************************************************/
+void latency_trace_discard(void)
+{
+    uint32_t tail = latency_ring_tail;
+
+    if (tail != latency_ring_head)
+    {
+        latency_ring_tail = tail + 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: latency_trace_publish
+********************************************************************************
+* Summary:
+*  Recomputes the p50/p99/max summaries from the histograms.
+*
+*******************************************************************************/
+void latency_trace_publish(void)
+{
+    latency_report_t *report = &diag_i2c_map.latency;
+
+    report->seq++;
+    __DMB();
+
+    for (uint32_t stage = 0u; stage < (LATENCY_STAGE_COUNT - 1u); stage++)
+    {
+        report->stage[stage].p50_us = latency_percentile(report->hist[stage], report->samples, LATENCY_P50);
+        report->stage[stage].p99_us = latency_percentile(report->hist[stage], report->samples, LATENCY_P99);
+        report->stage[stage].max_us = latency_max_us[stage];
+    }
+
+    __DMB();
+    report->seq++;
+    latency_unpublished = 0u;
+}
+
+#endif /* APP_LATENCY_TRACE */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name: latency_trace.h
+*
+* Description: This file is the public interface of latency_trace.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_LATENCY_TRACE_H_
+#define SOURCE_LATENCY_TRACE_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "app_config.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Histogram buckets per stage. Values below 4 us get one bucket each, above
+ * that every power of two is split into four buckets, which covers up to
+ * ~131 ms with a resolution of 25% or better.
+ */
+#define LATENCY_HIST_BUCKETS        (64u)
+
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+/* Stages of one touch event, in pipeline order */
+typedef enum
+{
+    LATENCY_STAGE_TIMER,        /* capsense_scan_tick fired */
+    LATENCY_STAGE_SCAN_START,   /* Cy_CapSense_ScanAllWidgets called */
+    LATENCY_STAGE_END_OF_SCAN,  /* capsense_end_of_scan_callback entered */
+    LATENCY_STAGE_PROCESS,      /* process_touch entered */
+    LATENCY_STAGE_LED_SEND,     /* LED command pushed to the LED ring */
+    LATENCY_STAGE_PWM_UPDATE,   /* task_led applied the command to the PWM */
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Latency of one stage, measured from LATENCY_STAGE_TIMER */
+typedef struct
+{
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} latency_summary_t;
+
+/* Report published over EzI2C. seq is odd while the summaries are being
+ * updated; a reader retries until it sees the same even value before and
+ * after reading. Index 0 of stage[] and hist[] is LATENCY_STAGE_SCAN_START.
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t samples;
+    uint32_t dropped;
+    latency_summary_t stage[LATENCY_STAGE_COUNT - 1u];
+    uint32_t hist[LATENCY_STAGE_COUNT - 1u][LATENCY_HIST_BUCKETS];
+} latency_report_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_LATENCY_TRACE
+void latency_trace_init(void);
+void latency_trace_stamp(latency_stage_t stage);
+void latency_trace_commit(void);
+void latency_trace_complete(void);
+void latency_trace_discard(void);
+void latency_trace_publish(void);
+uint32_t latency_bucket_floor_us(uint32_t bucket);
+
+#define LATENCY_TRACE_INIT()            latency_trace_init()
+#define LATENCY_TRACE_STAMP(stage)      latency_trace_stamp(stage)
+#define LATENCY_TRACE_COMMIT()          latency_trace_commit()
+#define LATENCY_TRACE_COMPLETE()        latency_trace_complete()
+#define LATENCY_TRACE_DISCARD()         latency_trace_discard()
+#else
+#define LATENCY_TRACE_INIT()
+#define LATENCY_TRACE_STAMP(stage)
+#define LATENCY_TRACE_COMMIT()
+#define LATENCY_TRACE_COMPLETE()
+#define LATENCY_TRACE_DISCARD()
+#endif
+
+
+#endif /* SOURCE_LATENCY_TRACE_H_ */
+
+
+/* [] END OF FILE */
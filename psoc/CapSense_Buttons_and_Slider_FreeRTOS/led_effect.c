@@ -0,0 +1,320 @@
+/******************************************************************************
+* File Name: led_effect.c
+*
+* Description: LED brightness on the TCPWM behind the HAL PWM object, with a
+*              gamma-corrected level table generated at compile time.
+*
+*              The HAL sets the period once at start-up. Afterwards a
+*              brightness change is a single write of the compare register,
+*              and a fade is a sequence of compare values that a DMA channel
+*              copies into the buffered compare register on every overflow
+*              of the PWM counter. With compare swap enabled, the counter
+*              moves the buffered value into the compare register at the
+*              next terminal count, so a new value always takes effect at a
+*              period boundary. Writing the compare register itself right
+*              after the overflow could miss the compare match of a small
+*              value and cut a period. A fade therefore runs without the CPU
+*              and without glitches: task_led only computes the sequence and
+*              does not wake up again until the next command.
+*
+*              The swap exchanges the two registers at every terminal count,
+*              so outside a fade both hold the same value.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "led_effect.h"
+#include "cybsp.h"
+#include "diag_i2c.h"
+
+
+#if APP_LED_EFFECTS
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Table rows, expanded by the preprocessor */
+#define LED_EFFECT_GAMMA_4(l)       LED_EFFECT_GAMMA(l), LED_EFFECT_GAMMA((l) + 1u), \
+                                    LED_EFFECT_GAMMA((l) + 2u), LED_EFFECT_GAMMA((l) + 3u)
+#define LED_EFFECT_GAMMA_16(l)      LED_EFFECT_GAMMA_4(l), LED_EFFECT_GAMMA_4((l) + 4u), \
+                                    LED_EFFECT_GAMMA_4((l) + 8u), LED_EFFECT_GAMMA_4((l) + 12u)
+#define LED_EFFECT_GAMMA_64(l)      LED_EFFECT_GAMMA_16(l), LED_EFFECT_GAMMA_16((l) + 16u), \
+                                    LED_EFFECT_GAMMA_16((l) + 32u), LED_EFFECT_GAMMA_16((l) + 48u)
+
+/* LED on-time in Q16 of each level */
+static const uint16_t led_effect_gamma[LED_EFFECT_LEVELS] =
+{
+    LED_EFFECT_GAMMA_64(0u), LED_EFFECT_GAMMA_64(64u),
+    LED_EFFECT_GAMMA_64(128u), LED_EFFECT_GAMMA_64(192u)
+};
+
+_Static_assert(LED_EFFECT_LEVELS == 256u, "led_effect_gamma is expanded for 256 levels");
+_Static_assert(LED_EFFECT_GAMMA(LED_EFFECT_LEVEL_MAX) == 65535u, "Gamma curve must end at full scale");
+_Static_assert(LED_EFFECT_LEVEL_FROM_PERCENT(100u) == LED_EFFECT_LEVEL_MAX, "Percent scale must end at full scale");
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static cyhal_pwm_t *led_effect_pwm;
+static cyhal_dma_t led_effect_dma;
+static uint32_t led_effect_period;
+static uint32_t led_effect_compare;         /* Last compare value written by the CPU */
+
+/* Compare values of the fade in progress, read by the DMA; the last value
+ * is repeated to leave both compare registers equal.
+ */
+static uint32_t led_effect_fade_buffer[LED_EFFECT_FADE_MAX_STEPS + 1u];
+
+
+/*******************************************************************************
+* Function Name: led_effect_compare_of
+********************************************************************************
+* Summary:
+*  Compare value of a level. The LED is active low, so it is on while the
+*  counter is at or above the compare value.
+*
+*******************************************************************************/
+static inline uint32_t led_effect_compare_of(uint32_t level)
+{
+    return led_effect_period - ((led_effect_gamma[level] * led_effect_period) >> 16u);
+}
+
+
+/*******************************************************************************
+* Function Name: led_effect_level_of
+********************************************************************************
+* Summary:
+*  Lowest level whose compare value is at or below the given one; used to
+*  resume from the point a fade was cut at.
+*
+*******************************************************************************/
+static uint32_t led_effect_level_of(uint32_t compare)
+{
+    uint32_t low = 0u;
+    uint32_t high = LED_EFFECT_LEVEL_MAX;
+
+    while (low < high)
+    {
+        uint32_t mid = (low + high) >> 1u;
+
+        if (led_effect_compare_of(mid) <= compare)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1u;
+        }
+    }
+    return low;
+}
+
+
+/*******************************************************************************
+* Function Name: led_effect_write
+********************************************************************************
+* Summary:
+*  Writes a compare value from the CPU. The swap is held off while the two
+*  registers are written, so that a terminal count between the writes cannot
+*  leave them different. Like a duty cycle update of the HAL, a value below
+*  the count already reached takes effect from the next period.
+*
+*******************************************************************************/
+static void led_effect_write(uint32_t compare)
+{
+    TCPWM_Type *base = led_effect_pwm->base;
+    uint32_t channel = led_effect_pwm->resource.channel_num;
+
+    Cy_TCPWM_PWM_EnableCompareSwap(base, channel, false);
+    Cy_TCPWM_PWM_SetCompare0(base, channel, compare);
+    Cy_TCPWM_PWM_SetCompare1(base, channel, compare);
+    Cy_TCPWM_PWM_EnableCompareSwap(base, channel, true);
+    led_effect_compare = compare;
+}
+
+
+/*******************************************************************************
+* Function Name: led_effect_stop
+********************************************************************************
+* Summary:
+*  Stops the fade in progress, if any, and returns the compare value it has
+*  reached. The value the DMA has already buffered for the next period is
+*  dropped.
+*
+*******************************************************************************/
+static uint32_t led_effect_stop(void)
+{
+    led_effect_stats_t *stats = &diag_i2c_map.led_effect;
+
+    if (!cyhal_dma_is_busy(&led_effect_dma))
+    {
+        return led_effect_compare;
+    }
+    (void)cyhal_dma_disable(&led_effect_dma);
+    stats->fades_cut++;
+    led_effect_write(Cy_TCPWM_PWM_GetCompare0(led_effect_pwm->base,
+                                              led_effect_pwm->resource.channel_num));
+    return led_effect_compare;
+}
+
+
+/*******************************************************************************
+* Function Name: led_effect_init
+********************************************************************************
+* Summary:
+*  Sets the PWM period through the HAL, enables compare swap, routes the
+*  counter overflow to the fade DMA channel and sets the initial level. The
+*  PWM must be initialized and is left running.
+*
+* Parameters:
+*  cyhal_pwm_t *pwm : PWM of the LED
+*  uint32_t level   : Initial level
+*
+* Return:
+*  Result of the HAL calls
+*
+*******************************************************************************/
+cy_rslt_t led_effect_init(cyhal_pwm_t *pwm, uint32_t level)
+{
+    led_effect_stats_t *stats = &diag_i2c_map.led_effect;
+    cyhal_source_t overflow;
+    cy_rslt_t result;
+
+    led_effect_pwm = pwm;
+
+    /* The only HAL update of the PWM; it computes the period */
+    result = cyhal_pwm_set_duty_cycle(pwm, 100.0f, LED_EFFECT_PWM_FREQ_HZ);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cyhal_pwm_start(pwm);
+    }
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cyhal_pwm_enable_output(pwm, CYHAL_PWM_OUTPUT_OVERFLOW, &overflow);
+    }
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cyhal_dma_init(&led_effect_dma, CYHAL_DMA_PRIORITY_DEFAULT,
+                                CYHAL_DMA_DIRECTION_MEM2PERIPH);
+    }
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cyhal_dma_connect_digital(&led_effect_dma, overflow,
+                                           CYHAL_DMA_INPUT_TRIGGER_SINGLE_ELEMENT);
+    }
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    led_effect_period = Cy_TCPWM_PWM_GetPeriod0(pwm->base, pwm->resource.channel_num) + 1u;
+    led_effect_write(Cy_TCPWM_PWM_GetCompare0(pwm->base, pwm->resource.channel_num));
+    stats->levels = LED_EFFECT_LEVELS;
+    stats->period_counts = led_effect_period;
+    led_effect_set(level);
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: led_effect_set
+********************************************************************************
+* Summary:
+*  Sets a level at once. Writes the compare register only, and only if the
+*  value changes.
+*
+* Parameters:
+*  uint32_t level : 0 to LED_EFFECT_LEVEL_MAX
+*
+*******************************************************************************/
+void led_effect_set(uint32_t level)
+{
+    led_effect_stats_t *stats = &diag_i2c_map.led_effect;
+    uint32_t compare = led_effect_compare_of(level);
+
+    stats->level = level;
+    if (compare == led_effect_stop())
+    {
+        return;
+    }
+    led_effect_write(compare);
+    stats->compare_writes++;
+}
+
+
+/*******************************************************************************
+* Function Name: led_effect_fade
+********************************************************************************
+* Summary:
+*  Fades from the current level to the given one, linearly in levels. The
+*  compare sequence is computed here and played by the DMA into the buffered
+*  compare register, one value per PWM period, each taking effect at the next
+*  terminal count. A fade in progress is cut and continued from where it was.
+*
+* Parameters:
+*  uint32_t level       : Target level, 0 to LED_EFFECT_LEVEL_MAX
+*  uint32_t duration_ms : Fade time, clipped to LED_EFFECT_FADE_MAX_STEPS
+*                         PWM periods
+*
+*******************************************************************************/
+void led_effect_fade(uint32_t level, uint32_t duration_ms)
+{
+    led_effect_stats_t *stats = &diag_i2c_map.led_effect;
+    uint32_t steps = (duration_ms * LED_EFFECT_PWM_FREQ_HZ) / 1000u;
+    uint32_t from = led_effect_level_of(led_effect_stop());
+    int32_t delta_q16;
+    int32_t level_q16;
+
+    if (steps > LED_EFFECT_FADE_MAX_STEPS)
+    {
+        steps = LED_EFFECT_FADE_MAX_STEPS;
+    }
+    if ((steps < 2u) || (from == level))
+    {
+        led_effect_set(level);
+        return;
+    }
+
+    /* The last value lands exactly on the target */
+    delta_q16 = (((int32_t)level - (int32_t)from) * 65536) / (int32_t)steps;
+    level_q16 = (int32_t)(from << 16u);
+    for (uint32_t i = 0u; i < (steps - 1u); i++)
+    {
+        level_q16 += delta_q16;
+        led_effect_fade_buffer[i] = led_effect_compare_of((uint32_t)(level_q16 + 32768) >> 16u);
+    }
+    led_effect_fade_buffer[steps - 1u] = led_effect_compare_of(level);
+    led_effect_fade_buffer[steps] = led_effect_fade_buffer[steps - 1u];
+
+    cyhal_dma_cfg_t dma_cfg =
+    {
+        .src_addr       = (uintptr_t)led_effect_fade_buffer,
+        .src_increment  = 1,
+        .dst_addr       = (uintptr_t)&TCPWM_CNT_CC_BUFF(led_effect_pwm->base,
+                                                        led_effect_pwm->resource.channel_num),
+        .dst_increment  = 0,
+        .transfer_width = 32u,
+        .length         = steps + 1u,
+        .burst_size     = 1u,
+        .action         = CYHAL_DMA_TRANSFER_BURST,
+    };
+    (void)cyhal_dma_configure(&led_effect_dma, &dma_cfg);
+    (void)cyhal_dma_enable(&led_effect_dma);
+
+    /* Where the fade ends, should it be cut before it completes */
+    led_effect_compare = led_effect_fade_buffer[steps - 1u];
+    stats->level = level;
+    stats->fades++;
+    stats->fade_steps += steps;
+}
+
+#endif /* APP_LED_EFFECTS */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,87 @@
+/******************************************************************************
+* File Name: led_effect.h
+*
+* Description: This file is the public interface of led_effect.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_LED_EFFECT_H_
+#define SOURCE_LED_EFFECT_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "cyhal.h"
+#include "app_config.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* PWM frequency of the LED. The DMA advances a fade by one step per PWM
+ * period, so this is also the step rate of fades.
+ */
+#define LED_EFFECT_PWM_FREQ_HZ      (1000u)
+
+/* Perceptual brightness levels; level 0 is off */
+#define LED_EFFECT_LEVELS           (256u)
+#define LED_EFFECT_LEVEL_MAX        (LED_EFFECT_LEVELS - 1u)
+
+/* Longest fade, in PWM periods */
+#define LED_EFFECT_FADE_MAX_STEPS   (128u)
+
+/* Gamma curve: level (0..255) to the LED on-time in Q16. A blend of 3/4 x^2
+ * and 1/4 x^3, which stays within 0.5 % of full scale of x^2.2.
+ */
+#define LED_EFFECT_GAMMA(level)     ((uint16_t)(((3ull * 255ull * (uint64_t)(level) * (level)) + \
+                                                 ((uint64_t)(level) * (level) * (level))) * \
+                                                65535ull / (4ull * 255ull * 255ull * 255ull)))
+
+/* Brightness in percent to level, without a division */
+#define LED_EFFECT_LEVEL_FROM_PERCENT(percent)  (((uint32_t)(percent) * 653u) >> 8u)
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* LED effect counters, published in the diagnostics map */
+typedef struct
+{
+    uint32_t levels;                /* LED_EFFECT_LEVELS, 0 if disabled */
+    uint32_t period_counts;         /* PWM period in counter clocks */
+    uint32_t level;                 /* Level set or faded to last */
+    uint32_t compare_writes;        /* Compare register writes by the CPU */
+    uint32_t fades;                 /* Fades handed to the DMA */
+    uint32_t fades_cut;             /* Fades replaced before completion */
+    uint32_t fade_steps;            /* Compare values of all fades */
+} led_effect_stats_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_LED_EFFECTS
+cy_rslt_t led_effect_init(cyhal_pwm_t *pwm, uint32_t level);
+void led_effect_set(uint32_t level);
+void led_effect_fade(uint32_t level, uint32_t duration_ms);
+
+/* RAM of the compare sequence read by the DMA */
+#define LED_EFFECT_RAM_BYTES        ((LED_EFFECT_FADE_MAX_STEPS + 1u) * sizeof(uint32_t))
+#else
+#define LED_EFFECT_RAM_BYTES        (0u)
+#endif
+
+
+#endif /* SOURCE_LED_EFFECT_H_ */
+
+
+/* [] END OF FILE */
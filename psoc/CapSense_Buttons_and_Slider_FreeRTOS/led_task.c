@@ -49,6 +49,10 @@
 #include "task.h"
 #include "queue.h"
 #include "cycfg.h"
+#include "latency_trace.h"
+#include "diag_i2c.h"
+#include "led_effect.h"
+#include "rtos_trace.h"
 
 
 /*******************************************************************************
@@ -59,13 +63,48 @@
                                          * is connected in active low 
                                          * configuration
                                          */
+#define LED_COMMAND_BATCH_SIZE  (LED_COMMAND_RING_SIZE)
+
+/* Fade time of the LED when it is turned on or off */
+#define LED_FADE_ON_OFF_MS      (120u)
+
+/* Priority of the IPC doorbell interrupt, the same as the CapSense interrupt */
+#define LED_IPC_INTERRUPT_PRIORITY  (7u)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t led_wait_commands(led_command_data_t *commands);
+#if APP_LED_EFFECTS
+static void led_apply_effect(const led_command_data_t *command);
+#endif
+#if APP_IPC_TOUCH_RING
+static void led_ipc_isr(void);
+#endif
 
 
 /*******************************************************************************
  * Global variable
  ******************************************************************************/
-/* Queue handle used for LED data */
-QueueHandle_t led_command_data_q;
+/* Ring used for LED commands */
+event_ring_t led_command_ring;
+
+#if APP_LED_EFFECTS
+/* LED state, only accessed by task_led */
+static bool led_on = true;
+static uint32_t led_level = LED_EFFECT_LEVEL_MAX;   /* Level while on */
+#endif
+
+#if APP_IPC_TOUCH_RING
+/* Ring used for LED commands from the other core; see ipc_ring.c */
+CY_SECTION_SHAREDMEM ipc_ring_t led_ipc_ring;
+static TaskHandle_t led_task_handle;
+#elif APP_EVENT_BUS
+/* Read position of task_led on touch_bus */
+event_bus_sub_t led_touch_sub;
+static uint32_t led_touch_discarded;        /* Overruns whose latency records are closed */
+#endif
 
 
 /*******************************************************************************
@@ -81,29 +120,62 @@ QueueHandle_t led_command_data_q;
 void task_led(void* param)
 {
     cyhal_pwm_t pwm_led;
+    led_command_data_t led_cmd_batch[LED_COMMAND_BATCH_SIZE];
+    uint32_t cmd_count;
+#if !APP_LED_EFFECTS
     bool led_on = true;
-    BaseType_t rtos_api_result;
     led_command_data_t led_cmd_data;
+#endif
 
     /* Suppress warning for unused parameter */
     (void)param;
 
     /* Initialize a PWM resource for driving an LED. */
     cyhal_pwm_init(&pwm_led, CYBSP_USER_LED, NULL);
+#if APP_LED_EFFECTS
+    if(CY_RSLT_SUCCESS != led_effect_init(&pwm_led, led_level))
+    {
+        CY_ASSERT(0u);
+    }
+#else
     cyhal_pwm_set_duty_cycle(&pwm_led, GET_DUTY_CYCLE(LED_MAX_BRIGHTNESS),
                              PWM_LED_FREQ_HZ);
     cyhal_pwm_start(&pwm_led);
+#endif
+
+#if APP_IPC_TOUCH_RING
+    /* The producer core rings the doorbell when this task waits */
+    led_task_handle = xTaskGetCurrentTaskHandle();
+    RTOS_TRACE_NAME(&led_ipc_ring, "IPC ISR");
+    ipc_ring_enable_doorbell(led_ipc_isr, LED_IPC_INTERRUPT_PRIORITY);
+#endif
 
     /* Repeatedly running part of the task */
     for(;;)
     {
-        /* Block until a command has been received over queue */
-        rtos_api_result = xQueueReceive(led_command_data_q, &led_cmd_data,
-                            portMAX_DELAY);
+        /* Block until commands have been pushed to the ring, then apply all
+         * pending commands in order.
+         */
+        cmd_count = led_wait_commands(led_cmd_batch);
 
-        /* Command has been received from queue */
-        if(rtos_api_result == pdTRUE)
+        for(uint32_t i = 0u; i < cmd_count; i++)
         {
+            /* Of consecutive brightness updates only the latest one is
+             * applied; the others are already stale.
+             */
+            if((LED_UPDATE_BRIGHTNESS == led_cmd_batch[i].command) &&
+               ((i + 1u) < cmd_count) &&
+               (LED_UPDATE_BRIGHTNESS == led_cmd_batch[i + 1u].command))
+            {
+                diag_i2c_map.led_coalesced++;
+                LATENCY_TRACE_DISCARD();
+                continue;
+            }
+
+#if APP_LED_EFFECTS
+            led_apply_effect(&led_cmd_batch[i]);
+#else
+            led_cmd_data = led_cmd_batch[i];
             switch(led_cmd_data.command)
             {
                 /* Turn on the LED. */
@@ -154,17 +226,170 @@ void task_led(void* param)
                     break;
                 }
             }
+#endif
+
+            /* The command has reached the PWM; close its latency record */
+            LATENCY_TRACE_COMPLETE();
         }
+    }
+}
 
-        /* Task has timed out and received no data during an interval of
-         * portMAXDELAY ticks.
-         */
-        else
+
+#if APP_LED_EFFECTS
+/*******************************************************************************
+* Function Name: led_apply_effect
+********************************************************************************
+* Summary:
+*  Applies an LED command through led_effect.c. Turning the LED on or off
+*  fades to the last brightness or to off; a brightness update is a single
+*  compare write, since the slider filter already smooths it.
+*
+*******************************************************************************/
+static void led_apply_effect(const led_command_data_t *command)
+{
+    uint32_t brightness;
+
+    switch(command->command)
+    {
+        case LED_TURN_ON:
+        {
+            if(!led_on)
+            {
+                led_effect_fade(led_level, LED_FADE_ON_OFF_MS);
+                led_on = true;
+            }
+            break;
+        }
+        case LED_TURN_OFF:
+        {
+            if(led_on)
+            {
+                led_effect_fade(0u, LED_FADE_ON_OFF_MS);
+                led_on = false;
+            }
+            break;
+        }
+        case LED_UPDATE_BRIGHTNESS:
+        {
+            if(led_on || (command->brightness > 0u))
+            {
+                brightness = (command->brightness < LED_MIN_BRIGHTNESS) ?
+                             LED_MIN_BRIGHTNESS : command->brightness;
+                led_level = LED_EFFECT_LEVEL_FROM_PERCENT(brightness);
+                led_effect_set(led_level);
+                led_on = true;
+            }
+            break;
+        }
+        default:
         {
-            /* Handle timeout here */
+            break;
         }
     }
 }
+#endif
+
+
+/*******************************************************************************
+* Function Name: led_wait_commands
+********************************************************************************
+* Summary:
+*  Blocks until at least one LED command is pending.
+*
+* Parameters:
+*  led_command_data_t *commands : Receives up to LED_COMMAND_BATCH_SIZE
+*                                 commands, oldest first
+*
+* Return:
+*  Number of commands received
+*
+*******************************************************************************/
+static uint32_t led_wait_commands(led_command_data_t *commands)
+{
+#if APP_IPC_TOUCH_RING
+    uint32_t count;
+
+    while(0u == (count = ipc_ring_pop_batch(&led_ipc_ring, commands,
+                                            LED_COMMAND_BATCH_SIZE)))
+    {
+        /* Sleep only if no command arrived while asking for the doorbell */
+        if(ipc_ring_arm(&led_ipc_ring))
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+    diag_i2c_map.ipc_ring = led_ipc_ring.stats;
+    return count;
+#elif APP_EVENT_BUS
+    const event_bus_event_t *event;
+    uint32_t count = 0u;
+
+    for(;;)
+    {
+        while(count < LED_COMMAND_BATCH_SIZE)
+        {
+            event = event_bus_peek(&led_touch_sub);
+
+            /* Lost events never reach the LED. Their latency records follow
+             * those of the commands already taken, so they are closed once
+             * these are applied.
+             */
+            if(led_touch_discarded != led_touch_sub.stats->overruns)
+            {
+                if(0u != count)
+                {
+                    break;
+                }
+                for(; led_touch_discarded != led_touch_sub.stats->overruns; led_touch_discarded++)
+                {
+                    LATENCY_TRACE_DISCARD();
+                }
+            }
+            if(NULL == event)
+            {
+                break;
+            }
+
+            /* The LED command is taken from the event in place */
+            commands[count].command = (led_command_t)event->led_command;
+            commands[count].brightness = event->brightness;
+            if(event_bus_release(&led_touch_sub))
+            {
+                count++;
+            }
+        }
+
+        if(0u != count)
+        {
+            return count;
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+#else
+    return event_ring_wait(&led_command_ring, commands, LED_COMMAND_BATCH_SIZE);
+#endif
+}
+
+
+#if APP_IPC_TOUCH_RING
+/*******************************************************************************
+* Function Name: led_ipc_isr
+********************************************************************************
+* Summary:
+*  IPC doorbell interrupt: wakes task_led.
+*
+*******************************************************************************/
+static void led_ipc_isr(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    RTOS_TRACE_ISR_ENTER(&led_ipc_ring);
+    ipc_ring_doorbell_ack(&led_ipc_ring);
+    vTaskNotifyGiveFromISR(led_task_handle, &xHigherPriorityTaskWoken);
+    RTOS_TRACE_ISR_EXIT(&led_ipc_ring);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+#endif
 
 
 /* END OF FILE [] */
@@ -52,6 +52,10 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "event_ring.h"
+#include "ipc_ring.h"
+#include "event_bus.h"
+#include "app_config.h"
 
 
 /*******************************************************************************
@@ -63,6 +67,9 @@
 /* Allowed TCPWM compare value for minimum brightness*/
 #define LED_MIN_BRIGHTNESS  (2u)
 
+/* Capacity of the LED command ring, must be a power of two */
+#define LED_COMMAND_RING_SIZE   (16u)
+
 
 /*******************************************************************************
  * Data structure and enumeration
@@ -86,7 +93,12 @@ typedef struct
 /*******************************************************************************
  * Global variable
  ******************************************************************************/
-extern QueueHandle_t led_command_data_q;
+extern event_ring_t led_command_ring;
+#if APP_IPC_TOUCH_RING
+extern ipc_ring_t led_ipc_ring;
+#elif APP_EVENT_BUS
+extern event_bus_sub_t led_touch_sub;
+#endif
 
 
 /*******************************************************************************
@@ -52,6 +52,16 @@
 #include "queue.h"
 #include "capsense_task.h"
 #include "led_task.h"
+#include "latency_trace.h"
+#include "diag_i2c.h"
+#include "power_mgr.h"
+#include "telemetry.h"
+#include "mem_report.h"
+#include "tuner_sync.h"
+#include "led_effect.h"
+#include "boot_profile.h"
+#include "baseline_store.h"
+#include "rtos_trace.h"
 
 
 /*******************************************************************************
@@ -62,13 +72,68 @@
  */
 #define TASK_CAPSENSE_PRIORITY (configMAX_PRIORITIES - 1)
 #define TASK_LED_PRIORITY (configMAX_PRIORITIES - 2)
+#define TASK_TUNER_PRIORITY (tskIDLE_PRIORITY + 1)
 
 /* Stack sizes of user tasks in this project */
+#ifndef TASK_CAPSENSE_STACK_SIZE
 #define TASK_CAPSENSE_STACK_SIZE (256u)
+#endif
 #define TASK_LED_STACK_SIZE (configMINIMAL_STACK_SIZE)
+#define TASK_TUNER_STACK_SIZE (configMINIMAL_STACK_SIZE)
 
-/* Queue lengths of message queues used in this project */
-#define SINGLE_ELEMENT_QUEUE (1u)
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+/* Storage of the event rings used in this project */
+static capsense_command_t capsense_command_storage[CAPSENSE_COMMAND_RING_SIZE];
+static led_command_data_t led_command_storage[LED_COMMAND_RING_SIZE];
+
+#if APP_IPC_TOUCH_RING
+#define APP_IPC_RING_RAM_BYTES (sizeof(ipc_ring_t))
+#else
+#define APP_IPC_RING_RAM_BYTES (0u)
+#endif
+
+#if APP_STATIC_ALLOCATION
+/* Stacks and control blocks of the user tasks */
+static StackType_t capsense_task_stack[TASK_CAPSENSE_STACK_SIZE];
+static StaticTask_t capsense_task_tcb;
+static StackType_t led_task_stack[TASK_LED_STACK_SIZE];
+static StaticTask_t led_task_tcb;
+#if APP_TUNER_SYNC
+static StackType_t tuner_task_stack[TASK_TUNER_STACK_SIZE];
+static StaticTask_t tuner_task_tcb;
+
+#define APP_TUNER_RAM_BYTES (sizeof(tuner_task_stack) + sizeof(tuner_task_tcb))
+#else
+#define APP_TUNER_RAM_BYTES (0u)
+#endif
+
+#define APP_TASK_RAM_BYTES  (sizeof(capsense_task_stack) + sizeof(capsense_task_tcb) + \
+                             sizeof(led_task_stack) + sizeof(led_task_tcb) + \
+                             APP_TUNER_RAM_BYTES)
+#define APP_HEAP_ALLOCATIONS (0u)
+#else
+#define APP_TASK_RAM_BYTES  (0u)
+#define APP_HEAP_ALLOCATIONS (2u + APP_TUNER_SYNC)
+#endif
+
+/* RAM reserved at build time: user tasks, idle and timer tasks, event rings,
+ * the diagnostics map, the Tuner's copy of the CapSense data, the LED fade
+ * sequence, the retained baselines and the RTOS trace buffer
+ */
+#define APP_STATIC_RAM_BYTES (APP_TASK_RAM_BYTES + TUNER_SYNC_RAM_BYTES + \
+    APP_IPC_RING_RAM_BYTES + LED_EFFECT_RAM_BYTES + BASELINE_STORE_RAM_BYTES + \
+    RTOS_TRACE_RAM_BYTES + \
+    ((configMINIMAL_STACK_SIZE + configTIMER_TASK_STACK_DEPTH) * sizeof(StackType_t)) + \
+    (2u * sizeof(StaticTask_t)) + \
+    sizeof(capsense_command_storage) + sizeof(led_command_storage) + sizeof(diag_i2c_map_t))
+
+/* The host simulation needs pthread-sized stacks */
+#if !defined(HOST_SIM)
+_Static_assert(APP_STATIC_RAM_BYTES <= APP_RAM_BUDGET_BYTES,
+               "Static RAM of the application exceeds APP_RAM_BUDGET_BYTES");
+#endif
 
 //Without this line, we get error 'uxTopUsedPriority is not defined'
 static volatile int uxTopUsedPriority;
@@ -91,8 +156,12 @@ int main(void)
 
 	cy_rslt_t result;
 
+    /* Time the start-up from here */
+    BOOT_PROFILE_START();
+
     /* Initialize the device and board peripherals */
     result = cybsp_init();
+    BOOT_PROFILE_MARK(BOOT_PHASE_BSP);
 
     /* Board init failed. Stop program execution */
     if (result != CY_RSLT_SUCCESS)
@@ -100,24 +169,93 @@ int main(void)
         CY_ASSERT(0);
     }
 
+    /* Record the scheduling events from the first kernel object created */
+    RTOS_TRACE_START();
+
     /* Enable global interrupts */
     __enable_irq();
 
-    /* Create the queues. See the respective data-types for details of queue
-     * contents
+    /* Start the cycle counter used for latency tracing */
+    LATENCY_TRACE_INIT();
+
+    /* Prepare the wake-up timer of the low-power idle */
+    POWER_MGR_INIT();
+
+    /* Publish the layout of the sensor telemetry ring */
+    TELEMETRY_INIT();
+
+    /* Publish the Tuner synchronization rate */
+    TUNER_SYNC_INIT();
+
+    TaskHandle_t capsense_task_handle;
+    TaskHandle_t led_task_handle;
+#if APP_TUNER_SYNC
+    TaskHandle_t tuner_task_handle;
+#endif
+
+    /* Create the event rings. See the respective data-types for details of
+     * ring contents
      */
-    led_command_data_q = xQueueCreate(SINGLE_ELEMENT_QUEUE,
-                                      sizeof(led_command_data_t));
-    capsense_command_q = xQueueCreate(SINGLE_ELEMENT_QUEUE,
-                                      sizeof(capsense_command_t));
+    event_ring_init(&led_command_ring, led_command_storage,
+                    sizeof(led_command_data_t), LED_COMMAND_RING_SIZE,
+                    &diag_i2c_map.led_ring);
+    event_ring_init(&capsense_command_ring, capsense_command_storage,
+                    sizeof(capsense_command_t), CAPSENSE_COMMAND_RING_SIZE,
+                    &diag_i2c_map.capsense_ring);
+#if APP_IPC_TOUCH_RING
+    ipc_ring_init(&led_ipc_ring, sizeof(led_command_data_t));
+#endif
+#if APP_EVENT_BUS
+    event_bus_init(&touch_bus, &diag_i2c_map.touch_bus);
+    RTOS_TRACE_NAME(&diag_i2c_map.touch_bus, "Touch bus");
+#endif
+    RTOS_TRACE_NAME(&led_command_ring, "LED ring");
+    RTOS_TRACE_NAME(&capsense_command_ring, "CapSense ring");
 
     /* Create the user tasks. See the respective task definition for more
      * details of these tasks.
      */
+#if APP_STATIC_ALLOCATION
+    capsense_task_handle = xTaskCreateStatic(task_capsense, "CapSense Task",
+                                             TASK_CAPSENSE_STACK_SIZE, NULL,
+                                             TASK_CAPSENSE_PRIORITY,
+                                             capsense_task_stack, &capsense_task_tcb);
+    led_task_handle = xTaskCreateStatic(task_led, "Led Task", TASK_LED_STACK_SIZE,
+                                        NULL, TASK_LED_PRIORITY,
+                                        led_task_stack, &led_task_tcb);
+#if APP_TUNER_SYNC
+    tuner_task_handle = xTaskCreateStatic(task_tuner, "Tuner Task", TASK_TUNER_STACK_SIZE,
+                                          NULL, TASK_TUNER_PRIORITY,
+                                          tuner_task_stack, &tuner_task_tcb);
+#endif
+#else
     xTaskCreate(task_capsense, "CapSense Task", TASK_CAPSENSE_STACK_SIZE,
-                NULL, TASK_CAPSENSE_PRIORITY, NULL);
+                NULL, TASK_CAPSENSE_PRIORITY, &capsense_task_handle);
     xTaskCreate(task_led, "Led Task", TASK_LED_STACK_SIZE,
-                NULL, TASK_LED_PRIORITY, NULL);
+                NULL, TASK_LED_PRIORITY, &led_task_handle);
+#if APP_TUNER_SYNC
+    xTaskCreate(task_tuner, "Tuner Task", TASK_TUNER_STACK_SIZE,
+                NULL, TASK_TUNER_PRIORITY, &tuner_task_handle);
+#endif
+#endif
+
+    /* Publish the RAM budget; stack high-water marks follow at run time */
+    mem_report_init(APP_STATIC_RAM_BYTES, APP_HEAP_ALLOCATIONS);
+    mem_report_task(MEM_TASK_CAPSENSE, capsense_task_handle, TASK_CAPSENSE_STACK_SIZE);
+    mem_report_task(MEM_TASK_LED, led_task_handle, TASK_LED_STACK_SIZE);
+#if APP_TUNER_SYNC
+    mem_report_task(MEM_TASK_TUNER, tuner_task_handle, TASK_TUNER_STACK_SIZE);
+#endif
+
+    /* Each task consumes one ring */
+    event_ring_set_consumer(&capsense_command_ring, capsense_task_handle);
+    event_ring_set_consumer(&led_command_ring, led_task_handle);
+#if APP_EVENT_BUS && !APP_IPC_TOUCH_RING
+    /* task_led reads the touch results from the bus instead */
+    event_bus_subscribe(&touch_bus, &led_touch_sub, led_task_handle);
+#endif
+
+    BOOT_PROFILE_MARK(BOOT_PHASE_SCHEDULER);
 
     /* Start the RTOS scheduler. This function should never return */
     vTaskStartScheduler();
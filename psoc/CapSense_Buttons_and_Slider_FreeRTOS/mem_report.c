@@ -0,0 +1,143 @@
+/******************************************************************************
+* File Name: mem_report.c
+*
+* Description: Publishes the RAM budget of the application and the stack
+*              high-water mark of every task in the diagnostics map, so that
+*              stack sizes can be trimmed from measurements on real units.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "mem_report.h"
+#include "timers.h"
+#include "diag_i2c.h"
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static TaskHandle_t mem_task_handle[MEM_TASK_COUNT];
+
+
+/*******************************************************************************
+* Function Name: mem_report_init
+********************************************************************************
+* Summary:
+*  Records the build-time RAM figures. The kernel tasks are registered with
+*  the stack depths of FreeRTOSConfig.h; their handles are looked up once
+*  the scheduler runs.
+*
+* Parameters:
+*  uint32_t static_bytes     : RAM reserved by the application at build time
+*  uint32_t heap_allocations : Application objects created on the heap
+*
+*******************************************************************************/
+void mem_report_init(uint32_t static_bytes, uint32_t heap_allocations)
+{
+    mem_report_t *report = &diag_i2c_map.mem;
+
+    report->static_bytes = static_bytes;
+    report->budget_bytes = APP_RAM_BUDGET_BYTES;
+    report->heap_allocations = heap_allocations;
+    report->task[MEM_TASK_IDLE].stack_bytes = configMINIMAL_STACK_SIZE * sizeof(StackType_t);
+    report->task[MEM_TASK_TIMER].stack_bytes = configTIMER_TASK_STACK_DEPTH * sizeof(StackType_t);
+}
+
+
+/*******************************************************************************
+* Function Name: mem_report_task
+********************************************************************************
+* Summary:
+*  Registers an application task.
+*
+* Parameters:
+*  mem_task_t task      : Slot of the task in the report
+*  TaskHandle_t handle  : Handle of the task
+*  uint32_t stack_words : Stack depth the task was created with
+*
+*******************************************************************************/
+void mem_report_task(mem_task_t task, TaskHandle_t handle, uint32_t stack_words)
+{
+    mem_task_handle[task] = handle;
+    diag_i2c_map.mem.task[task].stack_bytes = stack_words * sizeof(StackType_t);
+}
+
+
+/*******************************************************************************
+* Function Name: mem_report_kernel_tasks
+********************************************************************************
+* Summary:
+*  Looks up the handles of the kernel tasks, which exist once the scheduler
+*  has started.
+*
+*******************************************************************************/
+static void mem_report_kernel_tasks(void)
+{
+    if (NULL == mem_task_handle[MEM_TASK_IDLE])
+    {
+        mem_task_handle[MEM_TASK_IDLE] = xTaskGetIdleTaskHandle();
+        mem_task_handle[MEM_TASK_TIMER] = xTimerGetTimerDaemonTaskHandle();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: mem_report_slot
+********************************************************************************
+* Summary:
+*  Returns the slot of a task in the report.
+*
+* Parameters:
+*  TaskHandle_t handle : Handle of the task
+*
+* Return:
+*  MEM_TASK_COUNT if the task is not registered
+*
+*******************************************************************************/
+mem_task_t mem_report_slot(TaskHandle_t handle)
+{
+    uint32_t task;
+
+    mem_report_kernel_tasks();
+    for (task = 0u; task < MEM_TASK_COUNT; task++)
+    {
+        if (handle == mem_task_handle[task])
+        {
+            break;
+        }
+    }
+    return (mem_task_t)task;
+}
+
+
+/*******************************************************************************
+* Function Name: mem_report_update
+********************************************************************************
+* Summary:
+*  Refreshes the stack high-water marks. Scans each stack for the fill
+*  pattern, so task_capsense calls it once every MEM_REPORT_INTERVAL
+*  processed scans.
+*
+*******************************************************************************/
+void mem_report_update(void)
+{
+    mem_report_t *report = &diag_i2c_map.mem;
+
+    mem_report_kernel_tasks();
+    for (uint32_t task = 0u; task < MEM_TASK_COUNT; task++)
+    {
+        if (NULL != mem_task_handle[task])
+        {
+            report->task[task].stack_free_min_bytes =
+                uxTaskGetStackHighWaterMark(mem_task_handle[task]) * sizeof(StackType_t);
+        }
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,84 @@
+/******************************************************************************
+* File Name: mem_report.h
+*
+* Description: This file is the public interface of mem_report.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_MEM_REPORT_H_
+#define SOURCE_MEM_REPORT_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "app_config.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Processed scans between two stack high-water mark updates */
+#define MEM_REPORT_INTERVAL         (256u)
+
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+typedef enum
+{
+    MEM_TASK_CAPSENSE,
+    MEM_TASK_LED,
+    MEM_TASK_IDLE,
+    MEM_TASK_TIMER,
+    MEM_TASK_TUNER,
+    MEM_TASK_COUNT
+} mem_task_t;
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t stack_bytes;
+    uint32_t stack_free_min_bytes;  /* High-water mark: least free stack seen */
+} mem_task_report_t;
+
+/* Memory report, published in the diagnostics map. static_bytes is the RAM
+ * the application reserves at build time for task stacks and control blocks,
+ * event rings and the diagnostics map; the build fails if it exceeds
+ * budget_bytes (APP_RAM_BUDGET_BYTES).
+ */
+typedef struct
+{
+    uint32_t static_bytes;
+    uint32_t budget_bytes;
+    uint32_t heap_allocations;      /* Application objects created on the heap */
+    mem_task_report_t task[MEM_TASK_COUNT];
+} mem_report_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void mem_report_init(uint32_t static_bytes, uint32_t heap_allocations);
+void mem_report_task(mem_task_t task, TaskHandle_t handle, uint32_t stack_words);
+void mem_report_update(void);
+mem_task_t mem_report_slot(TaskHandle_t handle);
+
+
+#endif /* SOURCE_MEM_REPORT_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,303 @@
+/******************************************************************************
+* File Name: power_mgr.c
+*
+* Description: Low-power idle for the CapSense application. With tickless idle
+*              the RTOS calls vApplicationSleep() whenever all tasks are
+*              blocked; this implementation replaces the default one of the
+*              RTOS abstraction library and picks the power mode from the
+*              time left until the next scan tick or RTOS timeout:
+*
+*              - CPU Sleep for short windows or while a scan or an EzI2C
+*                transaction is in progress,
+*              - System Deep Sleep when the window covers its entry and exit
+*                cost (POWER_DEEPSLEEP_MIN_US).
+*
+*              The CPU wakes on the LPTIMER of the scan scheduler, on a second
+*              LPTIMER set to the next RTOS timeout, or on an EzI2C address
+*              match. The SysTick is stopped while sleeping and the RTOS tick
+*              count is stepped by the time slept.
+*
+*              In the host simulation build the decision runs as a dry run
+*              from the idle hook and only the statistics are updated.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "power_mgr.h"
+#include "cybsp.h"
+#include "cyhal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "capsense_task.h"
+#include "scan_scheduler.h"
+#include "diag_i2c.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define POWER_LPTIMER_INTR_PRIORITY (7u)
+
+#define POWER_TICKS_TO_US(ticks)    ((uint32_t)(((uint64_t)(ticks) * 1000000u) / SCAN_SCHEDULER_LPTIMER_HZ))
+#define POWER_MS_TO_TICKS(ms)       ((uint32_t)(((uint64_t)(ms) * SCAN_SCHEDULER_LPTIMER_HZ) / 1000u))
+
+
+/*******************************************************************************
+* Function Name: power_mgr_decide
+********************************************************************************
+* Summary:
+*  Selects the power mode for an idle window.
+*
+* Parameters:
+*  uint32_t idle_us : Time until the next scan tick or RTOS timeout
+*  bool busy        : A scan or an EzI2C transaction is in progress
+*
+*******************************************************************************/
+power_mode_t power_mgr_decide(uint32_t idle_us, bool busy)
+{
+    if (idle_us < POWER_SLEEP_MIN_US)
+    {
+        return POWER_MODE_ACTIVE;
+    }
+
+    /* Deep Sleep would stall the CSD block or the I2C slave */
+    if (busy || (idle_us < POWER_DEEPSLEEP_MIN_US))
+    {
+        return POWER_MODE_SLEEP;
+    }
+
+    return POWER_MODE_DEEPSLEEP;
+}
+
+
+#if APP_LOW_POWER
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+/* Wakes the CPU for RTOS timeouts; also the time base of the statistics */
+static cyhal_lptimer_t power_lptimer;
+
+static uint32_t power_last_read;
+static uint64_t power_total_ticks;
+static uint64_t power_sleep_ticks;
+static uint64_t power_deep_sleep_ticks;
+
+
+/*******************************************************************************
+* Function Name: power_mgr_init
+********************************************************************************
+* Summary:
+*  Initializes the LPTIMER that ends sleeps at the next RTOS timeout.
+*
+*******************************************************************************/
+void power_mgr_init(void)
+{
+    if (CY_RSLT_SUCCESS != cyhal_lptimer_init(&power_lptimer))
+    {
+        CY_ASSERT(0u);
+    }
+
+    /* The interrupt only has to wake the CPU, no callback is needed */
+    cyhal_lptimer_enable_event(&power_lptimer, CYHAL_LPTIMER_COMPARE_MATCH,
+                               POWER_LPTIMER_INTR_PRIORITY, true);
+    power_last_read = cyhal_lptimer_read(&power_lptimer);
+}
+
+
+/*******************************************************************************
+* Function Name: power_mgr_account
+********************************************************************************
+* Summary:
+*  Adds a sleep to the residency statistics.
+*
+* Parameters:
+*  power_mode_t mode : Mode that was held
+*  uint32_t slept    : LPTIMER ticks spent in that mode, at most the time
+*                      since the previous call
+*
+*******************************************************************************/
+static void power_mgr_account(power_mode_t mode, uint32_t slept)
+{
+    power_mgr_stats_t *stats = &diag_i2c_map.power;
+    uint32_t now = cyhal_lptimer_read(&power_lptimer);
+    uint32_t elapsed = now - power_last_read;
+    uint64_t active;
+
+    power_total_ticks += elapsed;
+    power_last_read = now;
+    if (slept > elapsed)
+    {
+        slept = elapsed;
+    }
+
+    if (POWER_MODE_DEEPSLEEP == mode)
+    {
+        stats->deep_sleeps++;
+        power_deep_sleep_ticks += slept;
+    }
+    else if (POWER_MODE_SLEEP == mode)
+    {
+        stats->sleeps++;
+        power_sleep_ticks += slept;
+    }
+
+    if (0u == power_total_ticks)
+    {
+        return;
+    }
+
+    active = power_total_ticks - power_sleep_ticks - power_deep_sleep_ticks;
+    if (active > power_total_ticks)
+    {
+        active = 0u;
+    }
+    stats->sleep_permille = (uint32_t)((power_sleep_ticks * 1000u) / power_total_ticks);
+    stats->deep_sleep_permille = (uint32_t)((power_deep_sleep_ticks * 1000u) / power_total_ticks);
+    stats->active_permille = (uint32_t)((active * 1000u) / power_total_ticks);
+}
+
+
+#if defined(HOST_SIM)
+/*******************************************************************************
+* Function Name: power_mgr_dry_run
+********************************************************************************
+* Summary:
+*  Called from the idle hook of the host simulation. Makes the decision
+*  vApplicationSleep() would make for the current idle window, once per
+*  window. The window is accounted as slept through when the next one
+*  starts.
+*
+*******************************************************************************/
+void power_mgr_dry_run(void)
+{
+    static uint32_t last_tick;
+    static power_mode_t window_mode = POWER_MODE_ACTIVE;
+    static uint32_t window_ticks;
+    uint32_t until_scan = scan_scheduler_ticks_until_next();
+    uint32_t next_tick = cyhal_lptimer_read(&power_lptimer) + until_scan;
+
+    if (next_tick == last_tick)
+    {
+        return;
+    }
+    last_tick = next_tick;
+
+    power_mgr_account(window_mode, (POWER_MODE_ACTIVE == window_mode) ? 0u : window_ticks);
+    window_mode = power_mgr_decide(POWER_TICKS_TO_US(until_scan), capsense_is_busy());
+    window_ticks = until_scan;
+}
+
+#else
+
+static uint64_t power_wake_latency_sum_us;
+static uint32_t power_wake_latency_samples;
+
+
+/*******************************************************************************
+* Function Name: power_mgr_wake_latency
+********************************************************************************
+* Summary:
+*  Records the wake latency of a sleep that was ended by the scan tick.
+*
+*******************************************************************************/
+static void power_mgr_wake_latency(uint32_t latency_ticks)
+{
+    power_mgr_stats_t *stats = &diag_i2c_map.power;
+    uint32_t latency_us = POWER_TICKS_TO_US(latency_ticks);
+
+    power_wake_latency_sum_us += latency_us;
+    power_wake_latency_samples++;
+    stats->wake_latency_avg_us = (uint32_t)(power_wake_latency_sum_us / power_wake_latency_samples);
+    if (latency_us > stats->wake_latency_max_us)
+    {
+        stats->wake_latency_max_us = latency_us;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: vApplicationSleep
+********************************************************************************
+* Summary:
+*  Tickless idle hook (portSUPPRESS_TICKS_AND_SLEEP). Sleeps until the next
+*  scan tick, RTOS timeout or EzI2C request and steps the tick count.
+*
+* Parameters:
+*  TickType_t xExpectedIdleTime : Ticks until the next RTOS timeout
+*
+*******************************************************************************/
+void vApplicationSleep(TickType_t xExpectedIdleTime)
+{
+    uint32_t critical = cyhal_system_critical_section_enter();
+    uint32_t until_scan;
+    uint32_t until_timeout;
+    uint32_t start;
+    uint32_t slept;
+    TickType_t slept_ms;
+    power_mode_t mode;
+
+    if (eAbortSleep == eTaskConfirmSleepModeStatus())
+    {
+        cyhal_system_critical_section_exit(critical);
+        return;
+    }
+
+    if (xExpectedIdleTime > POWER_MAX_SLEEP_MS)
+    {
+        xExpectedIdleTime = POWER_MAX_SLEEP_MS;
+    }
+    until_timeout = POWER_MS_TO_TICKS(xExpectedIdleTime);
+    until_scan = scan_scheduler_ticks_until_next();
+
+    mode = power_mgr_decide(POWER_TICKS_TO_US((until_scan < until_timeout) ? until_scan : until_timeout),
+                            capsense_is_busy());
+    if (POWER_MODE_ACTIVE == mode)
+    {
+        cyhal_system_critical_section_exit(critical);
+        return;
+    }
+
+    /* The scan scheduler and the EzI2C slave wake the CPU on their own */
+    cyhal_lptimer_set_delay(&power_lptimer, until_timeout);
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    start = cyhal_lptimer_read(&power_lptimer);
+
+    if ((POWER_MODE_DEEPSLEEP == mode) && (CY_RSLT_SUCCESS != cyhal_syspm_deepsleep()))
+    {
+        diag_i2c_map.power.deep_sleep_aborts++;
+        mode = POWER_MODE_SLEEP;
+    }
+    if (POWER_MODE_SLEEP == mode)
+    {
+        cyhal_syspm_sleep();
+    }
+
+    slept = cyhal_lptimer_read(&power_lptimer) - start;
+
+    /* Step the tick count; the tick interrupt resumes from a full period */
+    slept_ms = (TickType_t)((uint64_t)slept * 1000u / SCAN_SCHEDULER_LPTIMER_HZ);
+    vTaskStepTick((slept_ms < xExpectedIdleTime) ? slept_ms : (xExpectedIdleTime - 1u));
+    SysTick->VAL = 0u;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    if (slept >= until_scan)
+    {
+        power_mgr_wake_latency(slept - until_scan);
+    }
+    power_mgr_account(mode, slept);
+
+    cyhal_system_critical_section_exit(critical);
+}
+
+#endif /* HOST_SIM */
+
+#endif /* APP_LOW_POWER */
+
+
+/* [] END OF FILE */
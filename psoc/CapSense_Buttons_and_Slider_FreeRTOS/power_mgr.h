@@ -0,0 +1,97 @@
+/******************************************************************************
+* File Name: power_mgr.h
+*
+* Description: This file is the public interface of power_mgr.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_POWER_MGR_H_
+#define SOURCE_POWER_MGR_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_config.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Shortest idle window worth entering CPU Sleep for */
+#ifndef POWER_SLEEP_MIN_US
+#define POWER_SLEEP_MIN_US          (100u)
+#endif
+
+/* Shortest idle window worth entering System Deep Sleep for. Covers the
+ * SysPm callbacks and the wake-up of the high-frequency clocks.
+ */
+#ifndef POWER_DEEPSLEEP_MIN_US
+#define POWER_DEEPSLEEP_MIN_US      (2000u)
+#endif
+
+/* Longest single sleep when no RTOS timeout is pending */
+#define POWER_MAX_SLEEP_MS          (1000u)
+
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+typedef enum
+{
+    POWER_MODE_ACTIVE,          /* Idle window too short, keep running */
+    POWER_MODE_SLEEP,           /* CPU Sleep, peripherals keep running */
+    POWER_MODE_DEEPSLEEP        /* System Deep Sleep */
+} power_mode_t;
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Power statistics, published in the diagnostics map. Residency is counted
+ * since boot in parts per thousand. Wake latency runs from the scan tick
+ * that ends a sleep until the CPU executes again.
+ */
+typedef struct
+{
+    uint32_t sleeps;
+    uint32_t deep_sleeps;
+    uint32_t deep_sleep_aborts;     /* Deep Sleep refused by a SysPm callback */
+    uint32_t active_permille;
+    uint32_t sleep_permille;
+    uint32_t deep_sleep_permille;
+    uint32_t wake_latency_avg_us;
+    uint32_t wake_latency_max_us;
+} power_mgr_stats_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+power_mode_t power_mgr_decide(uint32_t idle_us, bool busy);
+
+#if APP_LOW_POWER
+void power_mgr_init(void);
+#if defined(HOST_SIM)
+void power_mgr_dry_run(void);
+#endif
+
+#define POWER_MGR_INIT()            power_mgr_init()
+#else
+#define POWER_MGR_INIT()
+#endif
+
+
+#endif /* SOURCE_POWER_MGR_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,327 @@
+/******************************************************************************
+* File Name: rtos_trace.c
+*
+* Description: Timeline of the scheduling events of the kernel and the
+*              application: task switches, kernel queue and timer daemon
+*              activity, the event rings and the event bus, and the
+*              application interrupts. Each event is an 8-byte record with a
+*              cycle counter timestamp in a buffer that wraps, so that it
+*              holds the last RTOS_TRACE_RECORDS events.
+*
+*              Records are written from tasks, from the context switch and
+*              from interrupts of any priority. A slot is reserved with an
+*              atomic increment of the head (LDREX/STREX on the CM4), so no
+*              interrupt is masked; a record interrupted between the
+*              reservation and the timestamp can carry a slightly later time
+*              than the one after it, which the converter sorts out.
+*
+*              Objects are identified by an id of one byte. Tasks keep their
+*              id in the task number of the kernel; all other objects are
+*              looked up by address among the named ones.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <string.h>
+#include "rtos_trace.h"
+#include "task.h"
+#include "timers.h"
+#include "cycle_counter.h"
+
+
+#if APP_RTOS_TRACE
+
+_Static_assert(0u == (RTOS_TRACE_RECORDS & (RTOS_TRACE_RECORDS - 1u)),
+               "RTOS_TRACE_RECORDS must be a power of two");
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+rtos_trace_t rtos_trace;
+
+/* Address of each named object; slot 0 is unused */
+static const void *rtos_trace_keys[RTOS_TRACE_MAX_OBJECTS];
+static uint32_t rtos_trace_objects = 1u;
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_record
+********************************************************************************
+* Summary:
+*  Appends a record. Callable from any context.
+*
+*******************************************************************************/
+static void rtos_trace_record(uint32_t type, uint32_t id, uint32_t arg)
+{
+    rtos_trace_record_t *record;
+
+    if (0u == rtos_trace.active)
+    {
+        return;
+    }
+    record = &rtos_trace.record[__atomic_fetch_add(&rtos_trace.head, 1u, __ATOMIC_RELAXED) &
+                                (RTOS_TRACE_RECORDS - 1u)];
+    record->time = cycle_counter_get();
+    record->type = (uint8_t)type;
+    record->id = (uint8_t)id;
+    record->arg = (uint16_t)arg;
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_lookup
+********************************************************************************
+* Summary:
+*  Returns the id of a named object, or 0.
+*
+*******************************************************************************/
+static uint32_t rtos_trace_lookup(const void *object)
+{
+    for (uint32_t id = 1u; id < rtos_trace_objects; id++)
+    {
+        if (object == rtos_trace_keys[id])
+        {
+            return id;
+        }
+    }
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_add
+********************************************************************************
+* Summary:
+*  Gives an object the next free id, or renames it if it has one already.
+*
+* Return:
+*  Id of the object, 0 if all are taken
+*
+*******************************************************************************/
+static uint32_t rtos_trace_add(const void *object, const char *name)
+{
+    uint32_t id;
+
+    taskENTER_CRITICAL();
+    id = rtos_trace_lookup(object);
+    if ((0u == id) && (rtos_trace_objects < RTOS_TRACE_MAX_OBJECTS))
+    {
+        id = rtos_trace_objects;
+        rtos_trace_keys[id] = object;
+        rtos_trace_objects = id + 1u;
+    }
+    if ((0u != id) && (NULL != name))
+    {
+        strncpy(rtos_trace.name[id], name, RTOS_TRACE_NAME_LEN - 1u);
+    }
+    taskEXIT_CRITICAL();
+    return id;
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_start
+********************************************************************************
+* Summary:
+*  Starts recording. Called in main() before any task is created.
+*
+*******************************************************************************/
+void rtos_trace_start(void)
+{
+    cycle_counter_init();
+
+    rtos_trace.magic = RTOS_TRACE_MAGIC;
+    rtos_trace.version = RTOS_TRACE_VERSION;
+    rtos_trace.clock_hz = CYCLE_COUNTER_HZ;
+    rtos_trace.records = RTOS_TRACE_RECORDS;
+    rtos_trace.objects = RTOS_TRACE_MAX_OBJECTS;
+    rtos_trace.name_len = RTOS_TRACE_NAME_LEN;
+    rtos_trace.active = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_stop
+********************************************************************************
+* Summary:
+*  Freezes the buffer, e.g. before it is read or on a fault.
+*
+*******************************************************************************/
+void rtos_trace_stop(void)
+{
+    rtos_trace.active = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_name
+********************************************************************************
+* Summary:
+*  Names an application object: an event ring, the event bus, or the object
+*  that stands for an interrupt in RTOS_TRACE_ISR_ENTER/EXIT.
+*
+*******************************************************************************/
+void rtos_trace_name(const void *object, const char *name)
+{
+    (void)rtos_trace_add(object, name);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_object
+********************************************************************************
+* Summary:
+*  Records an event of a named application object.
+*
+*******************************************************************************/
+void rtos_trace_object(rtos_trace_type_t type, const void *object, uint32_t arg)
+{
+    rtos_trace_record((uint32_t)type, rtos_trace_lookup(object), arg);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_task_create
+********************************************************************************
+* Summary:
+*  traceTASK_CREATE: names the task and keeps its id in its task number.
+*
+*******************************************************************************/
+void rtos_trace_task_create(void *task)
+{
+    TaskHandle_t handle = (TaskHandle_t)task;
+
+    vTaskSetTaskNumber(handle, rtos_trace_add(task, pcTaskGetName(handle)));
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_task_switched_in
+********************************************************************************
+* Summary:
+*  traceTASK_SWITCHED_IN, called by the kernel with the task that runs next.
+*
+*******************************************************************************/
+void rtos_trace_task_switched_in(void *task)
+{
+    rtos_trace_record(RTOS_TRACE_TASK_IN, uxTaskGetTaskNumber((TaskHandle_t)task), 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_task_switched_out
+********************************************************************************
+* Summary:
+*  traceTASK_SWITCHED_OUT, called by the kernel with the task that stops.
+*
+*******************************************************************************/
+void rtos_trace_task_switched_out(void *task)
+{
+    rtos_trace_record(RTOS_TRACE_TASK_OUT, uxTaskGetTaskNumber((TaskHandle_t)task), 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_queue_create
+********************************************************************************
+* Summary:
+*  traceQUEUE_CREATE. Queues are named when they are added to the queue
+*  registry; the converter calls the others by their id.
+*
+*******************************************************************************/
+void rtos_trace_queue_create(void *queue)
+{
+    (void)rtos_trace_add(queue, NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_queue_name
+********************************************************************************
+* Summary:
+*  traceQUEUE_REGISTRY_ADD.
+*
+*******************************************************************************/
+void rtos_trace_queue_name(void *queue, const char *name)
+{
+    (void)rtos_trace_add(queue, name);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_queue_send
+********************************************************************************
+* Summary:
+*  traceQUEUE_SEND and traceQUEUE_SEND_FROM_ISR; semaphores and mutexes are
+*  given through the same path.
+*
+*******************************************************************************/
+void rtos_trace_queue_send(void *queue, uint32_t from_isr)
+{
+    rtos_trace_record(RTOS_TRACE_QUEUE_SEND, rtos_trace_lookup(queue), from_isr);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_queue_receive
+********************************************************************************
+* Summary:
+*  traceQUEUE_RECEIVE and traceQUEUE_RECEIVE_FROM_ISR; semaphores and
+*  mutexes are taken through the same path.
+*
+*******************************************************************************/
+void rtos_trace_queue_receive(void *queue, uint32_t from_isr)
+{
+    rtos_trace_record(RTOS_TRACE_QUEUE_RECEIVE, rtos_trace_lookup(queue), from_isr);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_timer_create
+********************************************************************************
+* Summary:
+*  traceTIMER_CREATE.
+*
+*******************************************************************************/
+void rtos_trace_timer_create(void *timer)
+{
+    (void)rtos_trace_add(timer, pcTimerGetName((TimerHandle_t)timer));
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_timer_command
+********************************************************************************
+* Summary:
+*  traceTIMER_COMMAND_RECEIVED, called by the timer daemon for each command
+*  it takes from its queue.
+*
+*******************************************************************************/
+void rtos_trace_timer_command(void *timer, int32_t command)
+{
+    rtos_trace_record(RTOS_TRACE_TIMER_COMMAND, rtos_trace_lookup(timer), (uint32_t)command);
+}
+
+
+/*******************************************************************************
+* Function Name: rtos_trace_timer_expired
+********************************************************************************
+* Summary:
+*  traceTIMER_EXPIRED, called by the timer daemon before the callback.
+*
+*******************************************************************************/
+void rtos_trace_timer_expired(void *timer)
+{
+    rtos_trace_record(RTOS_TRACE_TIMER_EXPIRED, rtos_trace_lookup(timer), 0u);
+}
+
+#endif /* APP_RTOS_TRACE */
+
+
+/* [] END OF FILE */
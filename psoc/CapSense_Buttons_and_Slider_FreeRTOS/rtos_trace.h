@@ -0,0 +1,147 @@
+/******************************************************************************
+* File Name: rtos_trace.h
+*
+* Description: This file is the public interface of rtos_trace.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_RTOS_TRACE_H_
+#define SOURCE_RTOS_TRACE_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "app_config.h"
+#include "FreeRTOS.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Records kept; the oldest are overwritten once the buffer is full. Must be
+ * a power of two.
+ */
+#ifndef RTOS_TRACE_RECORDS
+#define RTOS_TRACE_RECORDS          (256u)
+#endif
+
+/* Named objects: tasks, kernel queues and timers, event rings and
+ * interrupts. Id 0 stands for objects without a slot.
+ */
+#define RTOS_TRACE_MAX_OBJECTS      (16u)
+#define RTOS_TRACE_NAME_LEN         (configMAX_TASK_NAME_LEN)
+
+#define RTOS_TRACE_MAGIC            (0x52545452u)   /* "RTTR" */
+#define RTOS_TRACE_VERSION          (1u)
+
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+/* Record types. The meaning of arg is given for each. */
+typedef enum
+{
+    RTOS_TRACE_TASK_IN = 1,         /* Task switched in */
+    RTOS_TRACE_TASK_OUT,            /* Task switched out */
+    RTOS_TRACE_ISR_ENTER,           /* Interrupt handler entered */
+    RTOS_TRACE_ISR_EXIT,            /* Interrupt handler left */
+    RTOS_TRACE_QUEUE_SEND,          /* Kernel queue or semaphore; arg: 1 from an interrupt */
+    RTOS_TRACE_QUEUE_RECEIVE,       /* Kernel queue or semaphore; arg: 1 from an interrupt */
+    RTOS_TRACE_TIMER_COMMAND,       /* Timer daemon; arg: command ID */
+    RTOS_TRACE_TIMER_EXPIRED,       /* Timer daemon runs the callback */
+    RTOS_TRACE_RING_PUSH,           /* Event ring; arg: fill level after the push */
+    RTOS_TRACE_RING_DROP,           /* Event ring full; arg: capacity */
+    RTOS_TRACE_RING_POP,            /* Event ring; arg: events taken */
+    RTOS_TRACE_BUS_PUBLISH,         /* Event bus; arg: low half of the sequence */
+    RTOS_TRACE_BUS_READ             /* Event bus; arg: low half of the sequence */
+} rtos_trace_type_t;
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t time;                  /* Cycle counter */
+    uint8_t type;                   /* rtos_trace_type_t */
+    uint8_t id;                     /* Object */
+    uint16_t arg;
+} rtos_trace_record_t;
+
+/* Trace buffer. Not part of the diagnostics map: it is read in one piece by
+ * the debugger, or written to a file by the host simulation, and converted
+ * with sim/rtos_trace_json.py. All fields are little-endian.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t clock_hz;              /* Cycle counter frequency */
+    uint32_t records;               /* RTOS_TRACE_RECORDS */
+    uint32_t objects;               /* RTOS_TRACE_MAX_OBJECTS */
+    uint32_t name_len;              /* RTOS_TRACE_NAME_LEN */
+    volatile uint32_t active;       /* Cleared by rtos_trace_stop() */
+    volatile uint32_t head;         /* Records written since the start */
+    char name[RTOS_TRACE_MAX_OBJECTS][RTOS_TRACE_NAME_LEN];
+    rtos_trace_record_t record[RTOS_TRACE_RECORDS];
+} rtos_trace_t;
+
+
+/*******************************************************************************
+ * Global variable
+ ******************************************************************************/
+extern rtos_trace_t rtos_trace;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_RTOS_TRACE
+void rtos_trace_start(void);
+void rtos_trace_stop(void);
+void rtos_trace_name(const void *object, const char *name);
+void rtos_trace_object(rtos_trace_type_t type, const void *object, uint32_t arg);
+
+/* Kernel hooks, installed in FreeRTOSConfig.h */
+void rtos_trace_task_create(void *task);
+void rtos_trace_task_switched_in(void *task);
+void rtos_trace_task_switched_out(void *task);
+void rtos_trace_queue_create(void *queue);
+void rtos_trace_queue_name(void *queue, const char *name);
+void rtos_trace_queue_send(void *queue, uint32_t from_isr);
+void rtos_trace_queue_receive(void *queue, uint32_t from_isr);
+void rtos_trace_timer_create(void *timer);
+void rtos_trace_timer_command(void *timer, int32_t command);
+void rtos_trace_timer_expired(void *timer);
+
+#define RTOS_TRACE_START()                      rtos_trace_start()
+#define RTOS_TRACE_STOP()                       rtos_trace_stop()
+#define RTOS_TRACE_NAME(object, name)           rtos_trace_name(object, name)
+#define RTOS_TRACE_OBJECT(type, object, arg)    rtos_trace_object(type, object, arg)
+#define RTOS_TRACE_ISR_ENTER(object)            rtos_trace_object(RTOS_TRACE_ISR_ENTER, object, 0u)
+#define RTOS_TRACE_ISR_EXIT(object)             rtos_trace_object(RTOS_TRACE_ISR_EXIT, object, 0u)
+#define RTOS_TRACE_RAM_BYTES                    (sizeof(rtos_trace_t))
+#else
+#define RTOS_TRACE_START()
+#define RTOS_TRACE_STOP()
+#define RTOS_TRACE_NAME(object, name)
+#define RTOS_TRACE_OBJECT(type, object, arg)
+#define RTOS_TRACE_ISR_ENTER(object)
+#define RTOS_TRACE_ISR_EXIT(object)
+#define RTOS_TRACE_RAM_BYTES                    (0u)
+#endif
+
+
+#endif /* SOURCE_RTOS_TRACE_H_ */
+
+
+/* [] END OF FILE */
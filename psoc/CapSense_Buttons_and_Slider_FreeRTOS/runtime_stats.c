@@ -0,0 +1,238 @@
+/******************************************************************************
+* File Name: runtime_stats.c
+*
+* Description: CPU load of every task and of the application interrupts.
+*              The kernel run time statistics count in cycles of the cycle
+*              counter; once per RUNTIME_STATS_WINDOW_MS the counters of all
+*              tasks are read and the load of the window is published in the
+*              diagnostics map. The CapSense and scan tick interrupts are
+*              timed separately with RUNTIME_STATS_ISR_ENTER/EXIT.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "runtime_stats.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "diag_i2c.h"
+
+
+#if APP_RUNTIME_STATS
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define RUNTIME_CYCLES_PER_TICK     (CYCLE_COUNTER_HZ / configTICK_RATE_HZ)
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+/* Written by the interrupts, read and cleared by the task in a critical
+ * section. All timed interrupts have the same priority and do not nest.
+ */
+static volatile uint32_t runtime_isr_cycles;
+static volatile uint32_t runtime_isr_count;
+static volatile uint32_t runtime_isr_max_cycles;
+
+/* Only accessed by runtime_stats_update() */
+static TickType_t runtime_window_start;
+static TaskStatus_t runtime_status[RUNTIME_STATS_MAX_TASKS];
+static TaskHandle_t runtime_last_handle[RUNTIME_STATS_MAX_TASKS];
+static uint32_t runtime_last_counter[RUNTIME_STATS_MAX_TASKS];
+
+
+/*******************************************************************************
+* Function Name: runtime_stats_timer_init
+********************************************************************************
+* Summary:
+*  portCONFIGURE_TIMER_FOR_RUN_TIME_STATS, called when the scheduler starts.
+*
+*******************************************************************************/
+void runtime_stats_timer_init(void)
+{
+    cycle_counter_init();
+}
+
+
+/*******************************************************************************
+* Function Name: runtime_stats_counter
+********************************************************************************
+* Summary:
+*  portGET_RUN_TIME_COUNTER_VALUE, called by the kernel on every context
+*  switch. The kernel only adds up differences, so the counter may wrap.
+*
+*******************************************************************************/
+uint32_t runtime_stats_counter(void)
+{
+    return cycle_counter_get();
+}
+
+
+/*******************************************************************************
+* Function Name: runtime_stats_isr_done
+********************************************************************************
+* Summary:
+*  Adds an interrupt to the statistics; called at the end of the handler
+*  through RUNTIME_STATS_ISR_EXIT().
+*
+* Parameters:
+*  uint32_t start : Cycle counter at the entry of the handler
+*
+*******************************************************************************/
+void runtime_stats_isr_done(uint32_t start)
+{
+    uint32_t cycles = cycle_counter_get() - start;
+
+    runtime_isr_cycles += cycles;
+    runtime_isr_count++;
+    if (cycles > runtime_isr_max_cycles)
+    {
+        runtime_isr_max_cycles = cycles;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: runtime_stats_load
+********************************************************************************
+* Summary:
+*  Sets the load of the window.
+*
+* Parameters:
+*  runtime_load_t *load   : Load to update
+*  uint64_t cycles        : Cycles used in the window
+*  uint64_t window_cycles : Length of the window
+*
+* Return:
+*  The load in parts per thousand
+*
+*******************************************************************************/
+static uint32_t runtime_stats_load(runtime_load_t *load, uint64_t cycles, uint64_t window_cycles)
+{
+    uint32_t permille = (uint32_t)((cycles * 1000u) / window_cycles);
+
+    if (permille > 1000u)
+    {
+        permille = 1000u;
+    }
+    load->cpu_permille = permille;
+    if (permille > load->cpu_max_permille)
+    {
+        load->cpu_max_permille = permille;
+    }
+    return permille;
+}
+
+
+/*******************************************************************************
+* Function Name: runtime_stats_task_cycles
+********************************************************************************
+* Summary:
+*  Returns the cycles a task ran since the previous window.
+*
+*******************************************************************************/
+static uint32_t runtime_stats_task_cycles(const TaskStatus_t *status)
+{
+    uint32_t cycles;
+    uint32_t i;
+
+    for (i = 0u; i < RUNTIME_STATS_MAX_TASKS; i++)
+    {
+        if ((status->xHandle == runtime_last_handle[i]) || (NULL == runtime_last_handle[i]))
+        {
+            break;
+        }
+    }
+    if (RUNTIME_STATS_MAX_TASKS == i)
+    {
+        return 0u;
+    }
+
+    cycles = status->ulRunTimeCounter - runtime_last_counter[i];
+    runtime_last_handle[i] = status->xHandle;
+    runtime_last_counter[i] = status->ulRunTimeCounter;
+    return cycles;
+}
+
+
+/*******************************************************************************
+* Function Name: runtime_stats_update
+********************************************************************************
+* Summary:
+*  Publishes the load of the window once it has elapsed; called by
+*  task_capsense after every frame.
+*
+*******************************************************************************/
+void runtime_stats_update(void)
+{
+    runtime_stats_t *stats = &diag_i2c_map.runtime;
+    TickType_t now = xTaskGetTickCount();
+    TickType_t window_ticks = now - runtime_window_start;
+    uint64_t window_cycles;
+    uint64_t task_cycles[MEM_TASK_COUNT] = { 0u };
+    uint64_t other_cycles = 0u;
+    uint32_t isr_cycles;
+    uint32_t busy_permille;
+    UBaseType_t tasks;
+
+    if (window_ticks < pdMS_TO_TICKS(RUNTIME_STATS_WINDOW_MS))
+    {
+        return;
+    }
+    window_cycles = (uint64_t)window_ticks * RUNTIME_CYCLES_PER_TICK;
+    runtime_window_start = now;
+
+    tasks = uxTaskGetSystemState(runtime_status, RUNTIME_STATS_MAX_TASKS, NULL);
+
+    taskENTER_CRITICAL();
+    isr_cycles = runtime_isr_cycles;
+    stats->isr_count = runtime_isr_count;
+    stats->isr_max_us = cycle_counter_to_us(runtime_isr_max_cycles);
+    runtime_isr_cycles = 0u;
+    runtime_isr_count = 0u;
+    taskEXIT_CRITICAL();
+
+    for (UBaseType_t i = 0u; i < tasks; i++)
+    {
+        mem_task_t slot = mem_report_slot(runtime_status[i].xHandle);
+        uint32_t cycles = runtime_stats_task_cycles(&runtime_status[i]);
+
+        if (MEM_TASK_COUNT == slot)
+        {
+            other_cycles += cycles;
+        }
+        else
+        {
+            task_cycles[slot] += cycles;
+        }
+    }
+
+    busy_permille = runtime_stats_load(&stats->other, other_cycles, window_cycles);
+    for (uint32_t task = 0u; task < MEM_TASK_COUNT; task++)
+    {
+        if (MEM_TASK_IDLE != task)
+        {
+            busy_permille += runtime_stats_load(&stats->task[task], task_cycles[task], window_cycles);
+        }
+    }
+    runtime_stats_load(&stats->isr, isr_cycles, window_cycles);
+
+    /* The idle task is whatever the other tasks left, asleep or not */
+    runtime_stats_load(&stats->task[MEM_TASK_IDLE],
+                       (busy_permille < 1000u) ? (((1000u - busy_permille) * window_cycles) / 1000u) : 0u,
+                       window_cycles);
+
+    stats->window_ms = (uint32_t)(((uint64_t)window_ticks * 1000u) / configTICK_RATE_HZ);
+    stats->windows++;
+}
+
+#endif /* APP_RUNTIME_STATS */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,93 @@
+/******************************************************************************
+* File Name: runtime_stats.h
+*
+* Description: This file is the public interface of runtime_stats.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_RUNTIME_STATS_H_
+#define SOURCE_RUNTIME_STATS_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "app_config.h"
+#include "cycle_counter.h"
+#include "mem_report.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Length of the window the CPU load is averaged over. Must stay below the
+ * wrap time of the 32-bit cycle counter (about 28 s at 150 MHz).
+ */
+#ifndef RUNTIME_STATS_WINDOW_MS
+#define RUNTIME_STATS_WINDOW_MS     (1000u)
+#endif
+
+/* Tasks read from the kernel per window */
+#define RUNTIME_STATS_MAX_TASKS     (8u)
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t cpu_permille;          /* Share of the last window */
+    uint32_t cpu_max_permille;      /* Highest share of any window */
+} runtime_load_t;
+
+/* CPU load, published in the diagnostics map once per window. Loads are
+ * parts per thousand of the wall-clock window. The cycle counter stops while
+ * the CPU sleeps, so the idle task is given the rest of the window, including
+ * the time asleep. Interrupt time is also part of the load of the task it
+ * interrupted. Task slots are those of the memory report, where the stack
+ * headroom of the same tasks is published.
+ */
+typedef struct
+{
+    uint32_t window_ms;
+    uint32_t windows;
+    runtime_load_t task[MEM_TASK_COUNT];
+    runtime_load_t other;           /* Tasks without a slot, combined */
+    runtime_load_t isr;             /* Application interrupts, combined */
+    uint32_t isr_count;             /* Interrupts in the last window */
+    uint32_t isr_max_us;            /* Longest single interrupt */
+} runtime_stats_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_RUNTIME_STATS
+void runtime_stats_timer_init(void);
+uint32_t runtime_stats_counter(void);
+void runtime_stats_isr_done(uint32_t start);
+void runtime_stats_update(void);
+
+/* Bracket the body of an interrupt handler */
+#define RUNTIME_STATS_ISR_ENTER()   uint32_t runtime_isr_start = cycle_counter_get()
+#define RUNTIME_STATS_ISR_EXIT()    runtime_stats_isr_done(runtime_isr_start)
+#define RUNTIME_STATS_UPDATE()      runtime_stats_update()
+#else
+#define RUNTIME_STATS_ISR_ENTER()
+#define RUNTIME_STATS_ISR_EXIT()
+#define RUNTIME_STATS_UPDATE()
+#endif
+
+
+#endif /* SOURCE_RUNTIME_STATS_H_ */
+
+
+/* [] END OF FILE */
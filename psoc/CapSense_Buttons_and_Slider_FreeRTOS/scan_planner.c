@@ -0,0 +1,222 @@
+/******************************************************************************
+* File Name: scan_planner.c
+*
+* Description: Chooses the widgets scanned in each frame. While no widget is
+*              touched every frame scans all widgets. Once a widget shows a
+*              touch it becomes hot and is scanned in every frame until
+*              SCAN_PLANNER_HOLD_FRAMES frames after its last touch; the
+*              remaining, cold widgets then share SCAN_PLANNER_COLD_PER_FRAME
+*              scans per frame in round-robin order, so a user dragging the
+*              slider does not pay for scanning idle buttons. A touch on a
+*              cold widget is seen the next time its turn comes and promotes
+*              it right away.
+*
+*              The planner only decides which widgets to scan; task_capsense
+*              runs the scans with the per-widget scan API.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <string.h>
+#include "scan_planner.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "diag_i2c.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#if defined(__GNUC__) || defined(__clang__)
+#define SCAN_PLANNER_CTZ(word)      ((uint32_t)__builtin_ctz(word))
+#else
+#define SCAN_PLANNER_CTZ(word)      ((uint32_t)__CLZ(__RBIT(word)))
+#endif
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static uint32_t planner_frame;
+static uint32_t planner_last_touch[CY_CAPSENSE_WIDGET_COUNT];
+static uint32_t planner_hot[SCAN_PLANNER_WORDS];
+static uint32_t planner_plan[SCAN_PLANNER_WORDS];   /* Widgets left to scan */
+static uint32_t planner_cold_cursor;
+
+static TickType_t planner_window_start;
+static uint32_t planner_window_scans[CY_CAPSENSE_WIDGET_COUNT];
+
+
+/*******************************************************************************
+* Function Name: scan_planner_is_hot
+*******************************************************************************/
+static inline bool scan_planner_is_hot(uint32_t widget)
+{
+    return (0u != (planner_hot[widget >> 5u] & (1uL << (widget & 31u))));
+}
+
+
+/*******************************************************************************
+* Function Name: scan_planner_init
+********************************************************************************
+* Summary:
+*  Starts with all widgets cold.
+*
+*******************************************************************************/
+void scan_planner_init(void)
+{
+    planner_frame = 0u;
+    planner_cold_cursor = 0u;
+    memset(planner_hot, 0, sizeof(planner_hot));
+    memset(planner_plan, 0, sizeof(planner_plan));
+    memset(planner_window_scans, 0, sizeof(planner_window_scans));
+    memset(&diag_i2c_map.scan_planner, 0, sizeof(diag_i2c_map.scan_planner));
+    planner_window_start = xTaskGetTickCount();
+}
+
+
+/*******************************************************************************
+* Function Name: scan_planner_begin_frame
+********************************************************************************
+* Summary:
+*  Plans the widgets of the next frame: all of them while none is hot,
+*  otherwise the hot ones plus the next cold ones in round-robin order.
+*
+*******************************************************************************/
+void scan_planner_begin_frame(void)
+{
+    scan_planner_stats_t *stats = &diag_i2c_map.scan_planner;
+    uint32_t any_hot = 0u;
+    uint32_t cold_left = SCAN_PLANNER_COLD_PER_FRAME;
+    uint32_t cursor = planner_cold_cursor;
+    bool partial = false;
+
+    /* Demote widgets whose last touch is too old */
+    for (uint32_t widget = 0u; widget < CY_CAPSENSE_WIDGET_COUNT; widget++)
+    {
+        if (scan_planner_is_hot(widget) &&
+            ((planner_frame - planner_last_touch[widget]) > SCAN_PLANNER_HOLD_FRAMES))
+        {
+            planner_hot[widget >> 5u] &= ~(1uL << (widget & 31u));
+        }
+    }
+
+    for (uint32_t word = 0u; word < SCAN_PLANNER_WORDS; word++)
+    {
+        any_hot |= planner_hot[word];
+        planner_plan[word] = planner_hot[word];
+        stats->hot_mask[word] = planner_hot[word];
+    }
+
+    for (uint32_t i = 0u; i < CY_CAPSENSE_WIDGET_COUNT; i++)
+    {
+        uint32_t widget = (cursor + i) % CY_CAPSENSE_WIDGET_COUNT;
+
+        if (scan_planner_is_hot(widget))
+        {
+            continue;
+        }
+        if ((0u != any_hot) && (0u == cold_left))
+        {
+            stats->skipped_scans++;
+            partial = true;
+            continue;
+        }
+        if (0u != any_hot)
+        {
+            cold_left--;
+            planner_cold_cursor = widget + 1u;
+        }
+        planner_plan[widget >> 5u] |= 1uL << (widget & 31u);
+    }
+
+    if (partial)
+    {
+        stats->partial_frames++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: scan_planner_next
+********************************************************************************
+* Summary:
+*  Returns the next widget of the frame, lowest ID first, or
+*  SCAN_PLANNER_DONE when all planned widgets have been handed out.
+*
+*******************************************************************************/
+uint32_t scan_planner_next(void)
+{
+    for (uint32_t word = 0u; word < SCAN_PLANNER_WORDS; word++)
+    {
+        if (0u != planner_plan[word])
+        {
+            uint32_t bit = SCAN_PLANNER_CTZ(planner_plan[word]);
+
+            planner_plan[word] &= planner_plan[word] - 1u;
+            return (word << 5u) + bit;
+        }
+    }
+    return SCAN_PLANNER_DONE;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_planner_widget_done
+********************************************************************************
+* Summary:
+*  Records the result of a processed widget. A touched widget becomes hot.
+*
+* Parameters:
+*  uint32_t widget : Widget ID
+*  bool active     : The widget reports a touch
+*
+*******************************************************************************/
+void scan_planner_widget_done(uint32_t widget, bool active)
+{
+    planner_window_scans[widget]++;
+    if (active)
+    {
+        planner_last_touch[widget] = planner_frame;
+        planner_hot[widget >> 5u] |= 1uL << (widget & 31u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: scan_planner_end_frame
+********************************************************************************
+* Summary:
+*  Closes a frame and updates the effective scan rates once per
+*  SCAN_PLANNER_RATE_WINDOW_MS.
+*
+*******************************************************************************/
+void scan_planner_end_frame(void)
+{
+    scan_planner_stats_t *stats = &diag_i2c_map.scan_planner;
+    TickType_t now = xTaskGetTickCount();
+    uint32_t elapsed_ms = (uint32_t)(now - planner_window_start) * portTICK_PERIOD_MS;
+
+    planner_frame++;
+    stats->frames++;
+
+    if (elapsed_ms < SCAN_PLANNER_RATE_WINDOW_MS)
+    {
+        return;
+    }
+
+    for (uint32_t widget = 0u; widget < CY_CAPSENSE_WIDGET_COUNT; widget++)
+    {
+        stats->scan_hz[widget] = (uint16_t)((planner_window_scans[widget] * 1000u) / elapsed_ms);
+        planner_window_scans[widget] = 0u;
+    }
+    planner_window_start = now;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,79 @@
+/******************************************************************************
+* File Name: scan_planner.h
+*
+* Description: This file is the public interface of scan_planner.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_SCAN_PLANNER_H_
+#define SOURCE_SCAN_PLANNER_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_config.h"
+#include "cycfg_capsense.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Frames a widget stays hot, i.e. scanned every frame, after its last touch */
+#ifndef SCAN_PLANNER_HOLD_FRAMES
+#define SCAN_PLANNER_HOLD_FRAMES    (32u)
+#endif
+
+/* Cold widgets scanned per frame while any widget is hot. Each cold widget
+ * is scanned at least once every ceil(cold widgets / this) frames.
+ */
+#ifndef SCAN_PLANNER_COLD_PER_FRAME
+#define SCAN_PLANNER_COLD_PER_FRAME (1u)
+#endif
+
+/* Window over which the effective scan rates are measured */
+#define SCAN_PLANNER_RATE_WINDOW_MS (1000u)
+
+/* Returned by scan_planner_next() when the frame is complete */
+#define SCAN_PLANNER_DONE           (0xFFFFFFFFu)
+
+#define SCAN_PLANNER_WORDS          ((CY_CAPSENSE_WIDGET_COUNT + 31u) / 32u)
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Planner statistics, published in the diagnostics map */
+typedef struct
+{
+    uint32_t frames;
+    uint32_t partial_frames;            /* Frames that skipped cold widgets */
+    uint32_t skipped_scans;             /* Widget scans saved by skipping */
+    uint32_t hot_mask[SCAN_PLANNER_WORDS];  /* Hot widgets, bit n of word w is widget ID 32w + n */
+    uint16_t scan_hz[CY_CAPSENSE_WIDGET_COUNT];     /* Effective scan rate */
+} scan_planner_stats_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void scan_planner_init(void);
+void scan_planner_begin_frame(void);
+uint32_t scan_planner_next(void);
+void scan_planner_widget_done(uint32_t widget, bool active);
+void scan_planner_end_frame(void);
+
+
+#endif /* SOURCE_SCAN_PLANNER_H_ */
+
+
+/* [] END OF FILE */
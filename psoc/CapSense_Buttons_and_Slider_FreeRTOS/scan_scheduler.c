@@ -0,0 +1,257 @@
+/******************************************************************************
+* File Name: scan_scheduler.c
+*
+* Description: Adaptive CapSense scan scheduling on the low-power timer
+*              (LPTIMER). The LPTIMER keeps counting in Deep Sleep and its
+*              compare-match interrupt starts every scan, so the scan period
+*              no longer depends on the RTOS timer daemon task.
+*
+*              Ticks are scheduled on absolute match values, one interval
+*              after the previous tick, so interrupt latency does not add up
+*              as drift. While a widget is touched the scheduler runs at
+*              SCAN_FAST_INTERVAL_MS; SCAN_ACTIVE_HOLD_MS after the last touch
+*              it backs off to SCAN_IDLE_INTERVAL_MS.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "scan_scheduler.h"
+#include "cybsp.h"
+#include "cyhal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "diag_i2c.h"
+#include "runtime_stats.h"
+#include "rtos_trace.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Same priority as the CapSense interrupt: both push to the CapSense ring */
+#define SCAN_LPTIMER_INTR_PRIORITY  (7u)
+
+/* Smallest distance between the counter and a new match value */
+#define SCAN_MIN_DELAY_TICKS        (4u)
+
+#define SCAN_MS_TO_TICKS(ms)        (((ms) * SCAN_SCHEDULER_LPTIMER_HZ) / 1000u)
+#define SCAN_TICKS_TO_US(ticks)     ((uint32_t)(((uint64_t)(ticks) * 1000000u) / SCAN_SCHEDULER_LPTIMER_HZ))
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static cyhal_lptimer_t scan_lptimer;
+static scan_scheduler_tick_t scan_tick;
+
+/* Written by the LPTIMER interrupt, and by the task inside a critical section */
+static volatile uint32_t scan_interval_ticks;
+static volatile uint32_t scan_tick_match;    /* Match of the latest tick */
+static volatile uint32_t scan_next_match;    /* Match currently programmed */
+
+static uint32_t scan_last_touch;
+static bool scan_touch_seen;
+static uint64_t scan_jitter_sum_us;
+
+
+/*******************************************************************************
+* Function Name: scan_scheduler_arm
+********************************************************************************
+* Summary:
+*  Programs the next tick. A match that has already passed is moved to one
+*  interval from now rather than firing a burst of late ticks.
+*
+* Return:
+*  true if the requested match had already passed
+*
+*******************************************************************************/
+static bool scan_scheduler_arm(uint32_t match)
+{
+    uint32_t now = cyhal_lptimer_read(&scan_lptimer);
+    bool late = ((int32_t)(match - now) < (int32_t)SCAN_MIN_DELAY_TICKS);
+
+    if (late)
+    {
+        match = now + scan_interval_ticks;
+    }
+
+    scan_next_match = match;
+    cyhal_lptimer_set_match(&scan_lptimer, match);
+    return late;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_scheduler_isr
+********************************************************************************
+* Summary:
+*  LPTIMER compare-match handler. Schedules the following tick and starts
+*  the current one.
+*
+*******************************************************************************/
+static void scan_scheduler_isr(void *callback_arg, cyhal_lptimer_event_t event)
+{
+    RUNTIME_STATS_ISR_ENTER();
+    RTOS_TRACE_ISR_ENTER(&scan_lptimer);
+
+    (void)callback_arg;
+    (void)event;
+
+    scan_tick_match = scan_next_match;
+    if (scan_scheduler_arm(scan_tick_match + scan_interval_ticks))
+    {
+        diag_i2c_map.scan_scheduler.skipped_ticks++;
+    }
+    scan_tick();
+
+    RTOS_TRACE_ISR_EXIT(&scan_lptimer);
+    RUNTIME_STATS_ISR_EXIT();
+}
+
+
+/*******************************************************************************
+* Function Name: scan_scheduler_init
+********************************************************************************
+* Summary:
+*  Initializes the LPTIMER. Scanning starts in idle mode.
+*
+* Parameters:
+*  scan_scheduler_tick_t tick : Called from the interrupt on every scan tick
+*
+*******************************************************************************/
+cy_rslt_t scan_scheduler_init(scan_scheduler_tick_t tick)
+{
+    cy_rslt_t result = cyhal_lptimer_init(&scan_lptimer);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    scan_tick = tick;
+    scan_interval_ticks = SCAN_MS_TO_TICKS(SCAN_IDLE_INTERVAL_MS);
+    diag_i2c_map.scan_scheduler.interval_ms = SCAN_IDLE_INTERVAL_MS;
+
+    RTOS_TRACE_NAME(&scan_lptimer, "Scan timer ISR");
+    cyhal_lptimer_register_callback(&scan_lptimer, scan_scheduler_isr, NULL);
+    cyhal_lptimer_enable_event(&scan_lptimer, CYHAL_LPTIMER_COMPARE_MATCH,
+                               SCAN_LPTIMER_INTR_PRIORITY, true);
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_scheduler_start
+********************************************************************************
+* Summary:
+*  Schedules the first tick one interval from now.
+*
+*******************************************************************************/
+void scan_scheduler_start(void)
+{
+    taskENTER_CRITICAL();
+    scan_tick_match = cyhal_lptimer_read(&scan_lptimer);
+    scan_scheduler_arm(scan_tick_match + scan_interval_ticks);
+    taskEXIT_CRITICAL();
+}
+
+
+/*******************************************************************************
+* Function Name: scan_scheduler_scan_started
+********************************************************************************
+* Summary:
+*  Records the jitter of a scan. Called by task_capsense just before it
+*  starts the scan of a tick.
+*
+*******************************************************************************/
+void scan_scheduler_scan_started(void)
+{
+    scan_scheduler_stats_t *stats = &diag_i2c_map.scan_scheduler;
+    uint32_t jitter_us = SCAN_TICKS_TO_US(cyhal_lptimer_read(&scan_lptimer) - scan_tick_match);
+    uint32_t scans;
+
+    if (SCAN_FAST_INTERVAL_MS == stats->interval_ms)
+    {
+        stats->fast_scans++;
+    }
+    else
+    {
+        stats->idle_scans++;
+    }
+
+    scans = stats->fast_scans + stats->idle_scans;
+    scan_jitter_sum_us += jitter_us;
+    stats->jitter_avg_us = (uint32_t)(scan_jitter_sum_us / scans);
+    if (jitter_us > stats->jitter_max_us)
+    {
+        stats->jitter_max_us = jitter_us;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: scan_scheduler_update
+********************************************************************************
+* Summary:
+*  Selects the scan interval from the result of the latest scan. Switching to
+*  the fast interval reschedules the pending tick right away, so a touch that
+*  starts while idle is followed up one fast interval later.
+*
+* Parameters:
+*  bool touched : true if any widget is active
+*
+*******************************************************************************/
+void scan_scheduler_update(bool touched)
+{
+    scan_scheduler_stats_t *stats = &diag_i2c_map.scan_scheduler;
+    uint32_t now = cyhal_lptimer_read(&scan_lptimer);
+    uint32_t interval_ms;
+
+    if (touched)
+    {
+        scan_last_touch = now;
+        scan_touch_seen = true;
+    }
+
+    interval_ms = (scan_touch_seen &&
+                   ((now - scan_last_touch) < SCAN_MS_TO_TICKS(SCAN_ACTIVE_HOLD_MS))) ?
+                  SCAN_FAST_INTERVAL_MS : SCAN_IDLE_INTERVAL_MS;
+
+    if (interval_ms == stats->interval_ms)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    scan_interval_ticks = SCAN_MS_TO_TICKS(interval_ms);
+    if (interval_ms < stats->interval_ms)
+    {
+        scan_scheduler_arm(scan_tick_match + scan_interval_ticks);
+    }
+    taskEXIT_CRITICAL();
+
+    stats->interval_ms = interval_ms;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_scheduler_ticks_until_next
+********************************************************************************
+* Summary:
+*  Returns the LPTIMER ticks left until the next scan tick, 0 if it is due.
+*
+*******************************************************************************/
+uint32_t scan_scheduler_ticks_until_next(void)
+{
+    int32_t left = (int32_t)(scan_next_match - cyhal_lptimer_read(&scan_lptimer));
+
+    return (left > 0) ? (uint32_t)left : 0u;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name: scan_scheduler.h
+*
+* Description: This file is the public interface of scan_scheduler.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_SCAN_SCHEDULER_H_
+#define SOURCE_SCAN_SCHEDULER_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Scan interval while a widget is touched */
+#ifndef SCAN_FAST_INTERVAL_MS
+#define SCAN_FAST_INTERVAL_MS       (4u)
+#endif
+
+/* Scan interval while no widget is touched */
+#ifndef SCAN_IDLE_INTERVAL_MS
+#define SCAN_IDLE_INTERVAL_MS       (64u)
+#endif
+
+/* Time after the last touch before the scheduler backs off to idle */
+#ifndef SCAN_ACTIVE_HOLD_MS
+#define SCAN_ACTIVE_HOLD_MS         (500u)
+#endif
+
+/* The LPTIMER counts the 32.768 kHz low-frequency clock */
+#define SCAN_SCHEDULER_LPTIMER_HZ   (32768u)
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Scheduler counters, published in the diagnostics map. Jitter is the delay
+ * between a scheduled scan tick and the start of the scan in task_capsense.
+ */
+typedef struct
+{
+    uint32_t interval_ms;       /* Scan interval in use */
+    uint32_t fast_scans;        /* Scans started at SCAN_FAST_INTERVAL_MS */
+    uint32_t idle_scans;        /* Scans started at SCAN_IDLE_INTERVAL_MS */
+    uint32_t skipped_ticks;     /* Ticks dropped because the schedule slipped */
+    uint32_t jitter_avg_us;
+    uint32_t jitter_max_us;
+} scan_scheduler_stats_t;
+
+/* Called in interrupt context on every scan tick */
+typedef void (*scan_scheduler_tick_t)(void);
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+cy_rslt_t scan_scheduler_init(scan_scheduler_tick_t tick);
+void scan_scheduler_start(void);
+void scan_scheduler_scan_started(void);
+void scan_scheduler_update(bool touched);
+uint32_t scan_scheduler_ticks_until_next(void);
+
+
+#endif /* SOURCE_SCAN_SCHEDULER_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,128 @@
+/*
+ * FreeRTOS configuration for the host simulation build (FreeRTOS POSIX port).
+ *
+ * Mirrors ../../FreeRTOSConfig.h so that the task, queue and timer behaviour
+ * of the application matches the target. Settings that only make sense on the
+ * Cortex-M4 (interrupt priorities, tickless idle, newlib reentrancy, stack
+ * overflow checking) are dropped or replaced with their POSIX equivalents.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+#include <stdint.h>
+
+/* Application build options (APP_RUNTIME_STATS, APP_RTOS_TRACE) */
+#include "app_config.h"
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configCPU_CLOCK_HZ                      1000000000u
+#define configTICK_RATE_HZ                      1000u
+#define configMAX_PRIORITIES                    7
+/* The POSIX port runs every task on a pthread, which needs at least
+ * PTHREAD_STACK_MIN bytes of stack. */
+#define configMINIMAL_STACK_SIZE                (16384u)
+#define configMAX_TASK_NAME_LEN                 16
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configQUEUE_REGISTRY_SIZE               10
+#define configUSE_QUEUE_SETS                    0
+#define configUSE_TIME_SLICING                  0
+#define configENABLE_BACKWARD_COMPATIBILITY     0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configTOTAL_HEAP_SIZE                   10240
+#define configAPPLICATION_ALLOCATED_HEAP        0
+
+/* Hook function related definitions. */
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICK_HOOK                     1
+#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK      0
+
+/* Run time and task stats gathering related definitions. The counter runs
+ * in nanoseconds on the host.
+ */
+#define configGENERATE_RUN_TIME_STATS           APP_RUNTIME_STATS
+#define configUSE_TRACE_FACILITY                1
+#define configUSE_STATS_FORMATTING_FUNCTIONS    0
+
+#if APP_RUNTIME_STATS
+extern void runtime_stats_timer_init( void );
+extern uint32_t runtime_stats_counter( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    runtime_stats_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()            runtime_stats_counter()
+#endif
+
+/* Kernel trace hooks. With APP_RTOS_TRACE task switches, queue and timer
+ * daemon activity are recorded for a timeline view (rtos_trace.c).
+ */
+#if APP_RTOS_TRACE
+extern void rtos_trace_task_create( void *task );
+extern void rtos_trace_task_switched_in( void *task );
+extern void rtos_trace_task_switched_out( void *task );
+extern void rtos_trace_queue_create( void *queue );
+extern void rtos_trace_queue_name( void *queue, const char *name );
+extern void rtos_trace_queue_send( void *queue, uint32_t from_isr );
+extern void rtos_trace_queue_receive( void *queue, uint32_t from_isr );
+extern void rtos_trace_timer_create( void *timer );
+extern void rtos_trace_timer_command( void *timer, int32_t command );
+extern void rtos_trace_timer_expired( void *timer );
+#define traceTASK_CREATE( pxNewTCB )                rtos_trace_task_create( pxNewTCB )
+#define traceTASK_SWITCHED_IN()                     rtos_trace_task_switched_in( pxCurrentTCB )
+#define traceTASK_SWITCHED_OUT()                    rtos_trace_task_switched_out( pxCurrentTCB )
+#define traceQUEUE_CREATE( pxNewQueue )             rtos_trace_queue_create( pxNewQueue )
+#define traceQUEUE_REGISTRY_ADD( xQueue, pcName )   rtos_trace_queue_name( xQueue, pcName )
+#define traceQUEUE_SEND( pxQueue )                  rtos_trace_queue_send( pxQueue, 0u )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )         rtos_trace_queue_send( pxQueue, 1u )
+#define traceQUEUE_RECEIVE( pxQueue )               rtos_trace_queue_receive( pxQueue, 0u )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )      rtos_trace_queue_receive( pxQueue, 1u )
+#define traceTIMER_CREATE( pxNewTimer )             rtos_trace_timer_create( pxNewTimer )
+#define traceTIMER_COMMAND_RECEIVED( pxTimer, xMessageID, xMessageValue ) \
+                                                    rtos_trace_timer_command( pxTimer, ( int32_t ) xMessageID )
+#define traceTIMER_EXPIRED( pxTimer )               rtos_trace_timer_expired( pxTimer )
+#endif
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES                   0
+#define configMAX_CO_ROUTINE_PRIORITIES         1
+
+/* Software timer related definitions. */
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               3
+#define configTIMER_QUEUE_LENGTH                10
+#define configTIMER_TASK_STACK_DEPTH            configMINIMAL_STACK_SIZE
+
+/* Optional functions - most linkers will remove unused functions anyway. */
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xResumeFromISR                  1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_xTimerGetTimerDaemonTaskHandle  1
+#define INCLUDE_eTaskGetState                   0
+#define INCLUDE_xEventGroupSetBitFromISR        1
+#define INCLUDE_xTimerPendFunctionCall          1
+#define INCLUDE_xTaskAbortDelay                 0
+#define INCLUDE_xTaskGetHandle                  0
+#define INCLUDE_xTaskResumeFromISR              1
+
+#define configASSERT( x )                       assert( x )
+
+#define configUSE_TICKLESS_IDLE                 0
+
+#endif /* FREERTOS_CONFIG_H */
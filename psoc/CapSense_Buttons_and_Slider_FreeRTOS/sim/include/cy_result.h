@@ -0,0 +1,18 @@
+/******************************************************************************
+* File Name: cyhal.h
+*
+* Description: Host simulation shim for the cy_result.h header. See cy_sim.h.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+#ifndef SIM_CY_RESULT_H_
+#define SIM_CY_RESULT_H_
+
+#include "cy_sim.h"
+
+#endif /* SIM_CY_RESULT_H_ */
+
+
+/* [] END OF FILE */
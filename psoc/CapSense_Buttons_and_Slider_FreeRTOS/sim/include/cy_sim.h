@@ -0,0 +1,612 @@
+/******************************************************************************
+* File Name: cy_sim.h
+*
+* Description: Host stand-ins for the subset of the PDL, HAL, BSP and CapSense
+*              middleware APIs used by this application. The declarations
+*              mirror the names and layouts of the real headers so that
+*              main.c, capsense_task.c and led_task.c build unmodified against
+*              the FreeRTOS POSIX port. cybsp.h, cyhal.h, cycfg.h and
+*              cycfg_capsense.h in this folder all resolve to this file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SIM_CY_SIM_H_
+#define SIM_CY_SIM_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/*******************************************************************************
+ * PDL / system
+ ******************************************************************************/
+typedef uint32_t cy_rslt_t;
+typedef uint32_t cy_status;
+typedef uint8_t  uint8;
+
+#define CY_RSLT_SUCCESS                 ((cy_rslt_t)0x00000000U)
+#define CY_RSLT_SIM_UNSUPPORTED         ((cy_rslt_t)0x04020001U)    /* Not modelled by the stand-ins */
+#define CY_RET_SUCCESS                  (0x00u)
+#define CY_RET_BAD_PARAM                (0x01u)
+#define CY_RET_INVALID_STATE            (0x08u)
+#define CYRET_SUCCESS                   (0x00u)
+
+#define CY_ASSERT(x)                    do { if (!(x)) { sim_halt(__FILE__, __LINE__); } } while(0)
+#define CY_UNUSED_PARAMETER(x)          ((void)(x))
+#define CY_SECTION_SHAREDMEM
+#define CY_NOINIT                       /* The host process starts with cleared memory */
+#define CY_ALIGN(align)                 __attribute__((aligned(align)))
+#define CY_SECTION(name)                /* Placement is left to the host linker */
+
+#define __enable_irq()                  sim_irq_global_enable(true)
+#define __disable_irq()                 sim_irq_global_enable(false)
+#define __DMB()                         __sync_synchronize()
+#define __CLZ(x)                        ((uint32_t)__builtin_clz(x))
+
+typedef int IRQn_Type;
+typedef void (*cy_israddress)(void);
+
+#define scb_0_interrupt_IRQn            ((IRQn_Type)39)
+#define csd_interrupt_IRQn              ((IRQn_Type)49)
+#define cpuss_interrupts_ipc_0_IRQn     ((IRQn_Type)23)
+#define SIM_IRQ_COUNT                   (64u)
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    uint32_t  intrPriority;
+} cy_stc_sysint_t;
+
+typedef enum
+{
+    CY_SYSINT_SUCCESS = 0x00u,
+    CY_SYSINT_BAD_PARAM = 0x01u,
+} cy_en_sysint_status_t;
+
+typedef struct
+{
+    uint32_t reserved;
+} CSD_Type;
+
+/* TCPWM, counter registers used by the PWM */
+#define SIM_TCPWM_CNT_COUNT             (8u)
+
+/* CTRL.AUTO_RELOAD_CC: swap CC and CC_BUFF at every terminal count */
+#define SIM_TCPWM_CTRL_AUTO_RELOAD_CC   (1uL << 0u)
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CC;
+    volatile uint32_t CC_BUFF;
+    volatile uint32_t PERIOD;
+} TCPWM_CNT_Type;
+
+typedef struct
+{
+    TCPWM_CNT_Type CNT[SIM_TCPWM_CNT_COUNT];
+} TCPWM_Type;
+
+#define TCPWM_CNT_CC(base, cntNum)      (((TCPWM_Type *)(base))->CNT[cntNum].CC)
+#define TCPWM_CNT_CC_BUFF(base, cntNum) (((TCPWM_Type *)(base))->CNT[cntNum].CC_BUFF)
+
+uint32_t Cy_TCPWM_PWM_GetPeriod0(TCPWM_Type const *base, uint32_t cntNum);
+uint32_t Cy_TCPWM_PWM_GetCompare0(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_PWM_SetCompare0(TCPWM_Type *base, uint32_t cntNum, uint32_t compare0);
+void Cy_TCPWM_PWM_SetCompare1(TCPWM_Type *base, uint32_t cntNum, uint32_t compare1);
+void Cy_TCPWM_PWM_EnableCompareSwap(TCPWM_Type *base, uint32_t cntNum, bool enable);
+
+extern CSD_Type sim_csd_hw;
+#define CYBSP_CSD_HW                    (&sim_csd_hw)
+
+/* SysPm */
+typedef enum
+{
+    CY_SYSPM_SUCCESS = 0x0u,
+    CY_SYSPM_FAIL = 0x1u,
+} cy_en_syspm_status_t;
+
+typedef enum
+{
+    CY_SYSPM_SLEEP = 0u,
+    CY_SYSPM_DEEPSLEEP = 1u,
+    CY_SYSPM_HIBERNATE = 2u,
+} cy_en_syspm_callback_type_t;
+
+typedef enum
+{
+    CY_SYSPM_CHECK_READY = 0x01u,
+    CY_SYSPM_CHECK_FAIL = 0x02u,
+    CY_SYSPM_BEFORE_TRANSITION = 0x04u,
+    CY_SYSPM_AFTER_TRANSITION = 0x08u,
+} cy_en_syspm_callback_mode_t;
+
+#define CY_SYSPM_SKIP_CHECK_READY       (0x01U)
+#define CY_SYSPM_SKIP_CHECK_FAIL        (0x02U)
+#define CY_SYSPM_SKIP_BEFORE_TRANSITION (0x04U)
+#define CY_SYSPM_SKIP_AFTER_TRANSITION  (0x08U)
+
+typedef struct
+{
+    void *base;
+    void *context;
+} cy_stc_syspm_callback_params_t;
+
+typedef cy_en_syspm_status_t (*Cy_SysPm_Callback)(cy_stc_syspm_callback_params_t *callbackParams,
+                                                  cy_en_syspm_callback_mode_t mode);
+
+typedef struct cy_stc_syspm_callback
+{
+    Cy_SysPm_Callback callback;
+    cy_en_syspm_callback_type_t type;
+    uint32_t skipMode;
+    cy_stc_syspm_callback_params_t *callbackParams;
+    struct cy_stc_syspm_callback *prevItm;
+    struct cy_stc_syspm_callback *nextItm;
+} cy_stc_syspm_callback_t;
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr);
+cy_israddress Cy_SysInt_GetVector(IRQn_Type IRQn);
+cy_israddress Cy_SysInt_SetVector(IRQn_Type IRQn, cy_israddress userIsr);
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler);
+
+/* IPC driver. A channel is a lock with a data register; acquiring it can
+ * raise notify events on IPC interrupt structures. The data register is
+ * pointer-sized on the host.
+ */
+#define CY_IPC_CHAN_USER                (8u)
+#define CY_IPC_INTR_USER                (8u)
+#define CY_IPC_NO_NOTIFICATION          (0u)
+#define SIM_IPC_CHANNELS                (16u)
+
+typedef enum
+{
+    CY_IPC_DRV_SUCCESS = 0x0u,
+    CY_IPC_DRV_ERROR = 0x1u,
+} cy_en_ipcdrv_status_t;
+
+typedef struct
+{
+    volatile uint32_t locked;
+    volatile uintptr_t data;
+} IPC_STRUCT_Type;
+
+typedef struct
+{
+    volatile uint32_t notify;       /* One bit per channel */
+    uint32_t notify_mask;
+} IPC_INTR_STRUCT_Type;
+
+IPC_STRUCT_Type *Cy_IPC_Drv_GetIpcBaseAddress(uint32_t ipcIndex);
+IPC_INTR_STRUCT_Type *Cy_IPC_Drv_GetIntrBaseAddr(uint32_t ipcIntrIndex);
+void Cy_IPC_Drv_WriteDataValue(IPC_STRUCT_Type *base, uintptr_t dataValue);
+uintptr_t Cy_IPC_Drv_ReadDataValue(IPC_STRUCT_Type const *base);
+cy_en_ipcdrv_status_t Cy_IPC_Drv_AcquireNotify(IPC_STRUCT_Type *base, uint32_t notifyEventIntr);
+cy_en_ipcdrv_status_t Cy_IPC_Drv_LockRelease(IPC_STRUCT_Type *base, uint32_t releaseEventIntr);
+void Cy_IPC_Drv_SetInterruptMask(IPC_INTR_STRUCT_Type *base, uint32_t ipcReleaseMask,
+                                 uint32_t ipcNotifyMask);
+void Cy_IPC_Drv_ClearInterrupt(IPC_INTR_STRUCT_Type *base, uint32_t ipcReleaseMask,
+                               uint32_t ipcNotifyMask);
+uint32_t Cy_IPC_Drv_GetInterruptStatusMasked(IPC_INTR_STRUCT_Type const *base);
+
+/* Flash driver. A row write copies the data into the read-only array that
+ * stands in for the flash row.
+ */
+#define CY_FLASH_SIZEOF_ROW             (512u)
+
+typedef enum
+{
+    CY_FLASH_DRV_SUCCESS = 0x00u,
+    CY_FLASH_DRV_INVALID_INPUT_PARAMETERS = 0x01u,
+} cy_en_flashdrv_status_t;
+
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uintptr_t rowAddr, const uint32_t *data);
+
+
+/*******************************************************************************
+ * HAL
+ ******************************************************************************/
+typedef int cyhal_gpio_t;
+typedef struct
+{
+    uint8_t type;
+    uint8_t block_num;
+    uint8_t channel_num;
+} cyhal_resource_inst_t;
+typedef struct
+{
+    uint32_t reserved;
+} cyhal_clock_t;
+
+#define CYBSP_USER_LED                  ((cyhal_gpio_t)0x0D)
+#define CYBSP_I2C_SDA                   ((cyhal_gpio_t)0x61)
+#define CYBSP_I2C_SCL                   ((cyhal_gpio_t)0x60)
+
+/* Trigger sources; a PWM output is the only one */
+typedef uint32_t cyhal_source_t;
+
+/* PWM. The counter runs from SIM_PWM_CLOCK_HZ; the output is high while the
+ * counter is below the compare value.
+ */
+#define SIM_PWM_CLOCK_HZ                (10000000u)
+
+typedef enum
+{
+    CYHAL_PWM_OUTPUT_OVERFLOW,
+    CYHAL_PWM_OUTPUT_UNDERFLOW,
+    CYHAL_PWM_OUTPUT_COMPARE_MATCH,
+} cyhal_pwm_output_t;
+
+typedef struct
+{
+    TCPWM_Type *base;
+    cyhal_resource_inst_t resource;
+    cyhal_gpio_t pin;
+    bool running;
+    float duty_cycle;
+    uint32_t frequency_hz;
+} cyhal_pwm_t;
+
+cy_rslt_t cyhal_pwm_init(cyhal_pwm_t *obj, cyhal_gpio_t pin, const cyhal_clock_t *clk);
+cy_rslt_t cyhal_pwm_set_duty_cycle(cyhal_pwm_t *obj, float duty_cycle, uint32_t frequencyhal_hz);
+cy_rslt_t cyhal_pwm_start(cyhal_pwm_t *obj);
+cy_rslt_t cyhal_pwm_stop(cyhal_pwm_t *obj);
+cy_rslt_t cyhal_pwm_enable_output(cyhal_pwm_t *obj, cyhal_pwm_output_t signal,
+                                  cyhal_source_t *source);
+
+/* DMA. A channel connected to the PWM overflow moves one element per PWM
+ * period, advanced by the tick hook. Addresses are pointer-sized on the host.
+ */
+#define CYHAL_DMA_PRIORITY_DEFAULT      (3u)
+
+typedef enum
+{
+    CYHAL_DMA_DIRECTION_MEM2MEM,
+    CYHAL_DMA_DIRECTION_MEM2PERIPH,
+    CYHAL_DMA_DIRECTION_PERIPH2MEM,
+    CYHAL_DMA_DIRECTION_PERIPH2PERIPH,
+} cyhal_dma_direction_t;
+
+typedef enum
+{
+    CYHAL_DMA_TRANSFER_BURST,
+    CYHAL_DMA_TRANSFER_FULL,
+} cyhal_dma_transfer_action_t;
+
+typedef enum
+{
+    CYHAL_DMA_INPUT_TRIGGER_SINGLE_ELEMENT,
+    CYHAL_DMA_INPUT_TRIGGER_SINGLE_BURST,
+    CYHAL_DMA_INPUT_TRIGGER_ALL_ELEMENTS,
+} cyhal_dma_input_t;
+
+typedef struct
+{
+    uintptr_t src_addr;
+    int16_t src_increment;
+    uintptr_t dst_addr;
+    int16_t dst_increment;
+    uint8_t transfer_width;
+    uint32_t length;
+    uint32_t burst_size;
+    cyhal_dma_transfer_action_t action;
+} cyhal_dma_cfg_t;
+
+typedef struct
+{
+    cyhal_dma_cfg_t cfg;
+    cyhal_pwm_t *trigger;
+    volatile bool enabled;
+    volatile uint32_t done;         /* Elements moved */
+} cyhal_dma_t;
+
+cy_rslt_t cyhal_dma_init(cyhal_dma_t *obj, uint8_t priority, cyhal_dma_direction_t direction);
+cy_rslt_t cyhal_dma_configure(cyhal_dma_t *obj, const cyhal_dma_cfg_t *cfg);
+cy_rslt_t cyhal_dma_connect_digital(cyhal_dma_t *obj, cyhal_source_t source, cyhal_dma_input_t input);
+cy_rslt_t cyhal_dma_enable(cyhal_dma_t *obj);
+cy_rslt_t cyhal_dma_disable(cyhal_dma_t *obj);
+bool cyhal_dma_is_busy(cyhal_dma_t *obj);
+
+/* EzI2C */
+typedef enum
+{
+    CYHAL_EZI2C_DATA_RATE_100KHZ = 100000,
+    CYHAL_EZI2C_DATA_RATE_400KHZ = 400000,
+    CYHAL_EZI2C_DATA_RATE_1MHZ = 1000000,
+} cyhal_ezi2c_data_rate_t;
+
+typedef enum
+{
+    CYHAL_EZI2C_SUB_ADDR8_BITS,
+    CYHAL_EZI2C_SUB_ADDR16_BITS,
+} cyhal_ezi2c_sub_addr_size_t;
+
+typedef struct
+{
+    uint8_t slave_address;
+    uint8_t *buf;
+    uint32_t buf_size;
+    uint32_t buf_rw_boundary;
+} cyhal_ezi2c_slave_cfg_t;
+
+typedef struct
+{
+    bool two_addresses;
+    bool enable_wake_from_sleep;
+    cyhal_ezi2c_data_rate_t data_rate;
+    cyhal_ezi2c_slave_cfg_t slave1_cfg;
+    cyhal_ezi2c_slave_cfg_t slave2_cfg;
+    cyhal_ezi2c_sub_addr_size_t sub_address_size;
+} cyhal_ezi2c_cfg_t;
+
+/* The slave sits on SCB3 of the kit. With CAPSENSE_SIM_I2C_POLL_BYTES set, a
+ * host reads that many bytes of the diagnostics map per tick, one SCB
+ * interrupt per byte.
+ */
+typedef struct
+{
+    cyhal_ezi2c_cfg_t cfg;
+    cyhal_resource_inst_t resource;
+    bool initialized;
+    uint32_t read_offset;
+} cyhal_ezi2c_t;
+
+typedef struct
+{
+    uint32_t reserved;
+} cy_stc_scb_ezi2c_context_t;
+
+cy_rslt_t cyhal_ezi2c_init(cyhal_ezi2c_t *obj, cyhal_gpio_t sda, cyhal_gpio_t scl,
+                           const cyhal_clock_t *clk, const cyhal_ezi2c_cfg_t *cfg);
+void cyhal_ezi2c_free(cyhal_ezi2c_t *obj);
+
+#define CYHAL_EZI2C_STATUS_BUSY         (0x08u)
+
+uint32_t cyhal_ezi2c_get_activity_status(cyhal_ezi2c_t *obj);
+
+/* LPTIMER, counting at 32768 Hz derived from the RTOS tick count */
+typedef enum
+{
+    CYHAL_LPTIMER_COMPARE_MATCH,
+} cyhal_lptimer_event_t;
+
+typedef void (*cyhal_lptimer_event_callback_t)(void *callback_arg, cyhal_lptimer_event_t event);
+
+typedef struct
+{
+    uint32_t match;
+    bool armed;
+    bool event_enabled;
+    cyhal_lptimer_event_callback_t callback;
+    void *callback_arg;
+} cyhal_lptimer_t;
+
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj);
+cy_rslt_t cyhal_lptimer_set_match(cyhal_lptimer_t *obj, uint32_t value);
+cy_rslt_t cyhal_lptimer_set_delay(cyhal_lptimer_t *obj, uint32_t delay);
+uint32_t cyhal_lptimer_read(const cyhal_lptimer_t *obj);
+void cyhal_lptimer_register_callback(cyhal_lptimer_t *obj, cyhal_lptimer_event_callback_t callback,
+                                     void *callback_arg);
+void cyhal_lptimer_enable_event(cyhal_lptimer_t *obj, cyhal_lptimer_event_t event,
+                                uint8_t intr_priority, bool enable);
+
+
+/*******************************************************************************
+ * BSP
+ ******************************************************************************/
+cy_rslt_t cybsp_init(void);
+
+
+/*******************************************************************************
+ * CapSense middleware
+ ******************************************************************************/
+#define CY_CAPSENSE_NOT_BUSY            (0x00u)
+#define CY_CAPSENSE_BUSY                (0x80u)
+
+/* Tuner commands and states handled by Cy_CapSense_RunTuner() */
+#define CY_CAPSENSE_TU_CMD_NONE_E       (0x00u)
+#define CY_CAPSENSE_TU_CMD_SUSPEND_E    (0x01u)
+#define CY_CAPSENSE_TU_CMD_RESUME_E     (0x02u)
+#define CY_CAPSENSE_TU_FSM_RUNNING      (0x00u)
+#define CY_CAPSENSE_TU_FSM_SUSPENDED    (0x01u)
+
+#define CY_CAPSENSE_WD_ACTIVE_MASK      (0x01u)
+#define CY_CAPSENSE_SNS_TOUCH_STATUS_MASK (0x01u)
+
+#define CY_CAPSENSE_WD_BUTTON_E         (0x01u)
+#define CY_CAPSENSE_WD_LINEAR_SLIDER_E  (0x02u)
+
+typedef enum
+{
+    CY_CAPSENSE_START_SAMPLE_E = 0x01u,
+    CY_CAPSENSE_END_OF_SCAN_E = 0x02u,
+} cy_en_capsense_callback_event_t;
+
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t z;
+    uint16_t id;
+} cy_stc_capsense_position_t;
+
+typedef struct
+{
+    cy_stc_capsense_position_t *ptrPosition;
+    uint8_t numPosition;
+} cy_stc_capsense_touch_t;
+
+typedef struct
+{
+    uint16_t raw;
+    uint16_t bsln;
+    uint16_t diff;
+    uint8_t status;
+    uint8_t negBslnRstCnt;
+    uint8_t idacComp;
+    uint8_t bslnExt;
+} cy_stc_capsense_sensor_context_t;
+
+typedef struct
+{
+    uint16_t fingerCap;
+    uint16_t sigPFC;
+    uint16_t resolution;
+    uint16_t maxRawCount;
+    uint16_t fingerTh;
+    uint16_t proxTh;
+    uint16_t lowBslnRst;
+    uint8_t noiseTh;
+    uint8_t nNoiseTh;
+    uint8_t hysteresis;
+    uint8_t onDebounce;
+    uint8_t status;
+    cy_stc_capsense_touch_t wdTouch;
+} cy_stc_capsense_widget_context_t;
+
+typedef struct
+{
+    cy_stc_capsense_widget_context_t *ptrWdContext;
+    cy_stc_capsense_sensor_context_t *ptrSnsContext;
+    uint16_t xResolution;
+    uint16_t yResolution;
+    uint16_t numSns;
+    uint8_t numCols;
+    uint8_t numRows;
+    uint8_t senseMethod;
+    uint8_t wdType;
+} cy_stc_capsense_widget_config_t;
+
+typedef struct
+{
+    uint16_t numWd;
+    uint16_t numSns;
+} cy_stc_capsense_common_config_t;
+
+typedef struct
+{
+    uint16_t configId;
+    uint16_t tunerCmd;
+    uint16_t scanCounter;
+    uint8_t tunerSt;
+    uint8_t initDone;
+    uint32_t status;
+} cy_stc_capsense_common_context_t;
+
+typedef struct
+{
+    uint16_t widgetIndex;
+    uint16_t sensorIndex;
+} cy_stc_active_scan_sns_t;
+
+struct cy_stc_capsense_context;
+
+typedef void (*cy_capsense_tuner_send_callback_t)(void *context);
+typedef void (*cy_capsense_tuner_receive_callback_t)(uint8_t **commandPacket, uint8_t **tunerPacket,
+                                                     struct cy_stc_capsense_context *context);
+
+typedef struct
+{
+    cy_capsense_tuner_send_callback_t ptrTunerSendCallback;
+    cy_capsense_tuner_receive_callback_t ptrTunerReceiveCallback;
+} cy_stc_capsense_internal_context_t;
+
+typedef struct cy_stc_capsense_context
+{
+    const cy_stc_capsense_common_config_t *ptrCommonConfig;
+    cy_stc_capsense_common_context_t *ptrCommonContext;
+    cy_stc_capsense_internal_context_t *ptrInternalContext;
+    const cy_stc_capsense_widget_config_t *ptrWdConfig;
+    cy_stc_capsense_widget_context_t *ptrWdContext;
+    cy_stc_active_scan_sns_t *ptrActiveScanSns;
+} cy_stc_capsense_context_t;
+
+typedef void (*cy_capsense_callback_t)(cy_stc_active_scan_sns_t *ptrActiveScan);
+
+/* Generated configuration (cycfg_capsense.h) */
+#define CY_CAPSENSE_WIDGET_COUNT        (3u)
+#define CY_CAPSENSE_SENSOR_COUNT        (7u)
+#define CY_CAPSENSE_POSITION_ENTRIES    (1u)
+
+#define CY_CAPSENSE_BUTTON0_WDGT_ID     (0u)
+#define CY_CAPSENSE_BUTTON1_WDGT_ID     (1u)
+#define CY_CAPSENSE_LINEARSLIDER0_WDGT_ID (2u)
+
+#define CY_CAPSENSE_BUTTON0_SNS0_ID     (0u)
+#define CY_CAPSENSE_BUTTON1_SNS0_ID     (0u)
+#define CY_CAPSENSE_LINEARSLIDER0_SNS0_ID (0u)
+
+typedef struct
+{
+    cy_stc_capsense_common_context_t commonContext;
+    cy_stc_capsense_widget_context_t widgetContext[CY_CAPSENSE_WIDGET_COUNT];
+    cy_stc_capsense_sensor_context_t sensorContext[CY_CAPSENSE_SENSOR_COUNT];
+    cy_stc_capsense_position_t position[CY_CAPSENSE_POSITION_ENTRIES];
+} cy_stc_capsense_tuner_t;
+
+extern cy_stc_capsense_context_t cy_capsense_context;
+extern cy_stc_capsense_tuner_t cy_capsense_tuner;
+
+cy_status Cy_CapSense_Init(cy_stc_capsense_context_t *context);
+cy_status Cy_CapSense_Enable(cy_stc_capsense_context_t *context);
+uint32_t Cy_CapSense_IsBusy(const cy_stc_capsense_context_t *context);
+cy_status Cy_CapSense_ScanAllWidgets(cy_stc_capsense_context_t *context);
+cy_status Cy_CapSense_SetupWidget(uint32_t widgetId, cy_stc_capsense_context_t *context);
+cy_status Cy_CapSense_Scan(cy_stc_capsense_context_t *context);
+cy_status Cy_CapSense_ProcessAllWidgets(cy_stc_capsense_context_t *context);
+cy_status Cy_CapSense_ProcessWidget(uint32_t widgetId, cy_stc_capsense_context_t *context);
+uint32_t Cy_CapSense_RunTuner(cy_stc_capsense_context_t *context);
+uint32_t Cy_CapSense_IsAnyWidgetActive(const cy_stc_capsense_context_t *context);
+uint32_t Cy_CapSense_IsWidgetActive(uint32_t widgetId, const cy_stc_capsense_context_t *context);
+uint32_t Cy_CapSense_IsSensorActive(uint32_t widgetId, uint32_t sensorId,
+                                    const cy_stc_capsense_context_t *context);
+cy_stc_capsense_touch_t *Cy_CapSense_GetTouchInfo(uint32_t widgetId,
+                                                   const cy_stc_capsense_context_t *context);
+cy_status Cy_CapSense_RegisterCallback(cy_en_capsense_callback_event_t callbackType,
+                                       cy_capsense_callback_t callbackFunction,
+                                       cy_stc_capsense_context_t *context);
+void Cy_CapSense_Wakeup(const cy_stc_capsense_context_t *context);
+void Cy_CapSense_InterruptHandler(const CSD_Type *base, cy_stc_capsense_context_t *context);
+cy_en_syspm_status_t Cy_CapSense_DeepSleepCallback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                   cy_en_syspm_callback_mode_t mode);
+
+
+/*******************************************************************************
+ * Simulation control
+ ******************************************************************************/
+void sim_halt(const char *file, int line);
+void sim_irq_global_enable(bool enable);
+void sim_irq_raise(IRQn_Type IRQn);
+void sim_finish(void);
+void sim_capsense_report(void);
+
+/* Checks of the protocols and rules, run by the SIM_CHECK build only */
+#ifndef SIM_CHECK
+#define SIM_CHECK                       (0u)
+#endif
+void sim_power_check(void);
+void sim_planner_check(void);
+void sim_ipc_check(void);
+void sim_bus_check(void);
+void sim_ring_check(void);
+void sim_filter_check(void);
+
+
+#endif /* SIM_CY_SIM_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,18 @@
+/******************************************************************************
+* File Name: cybsp.h
+*
+* Description: Host simulation shim for the cybsp.h header. See cy_sim.h.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+#ifndef SIM_CYBSP_H_
+#define SIM_CYBSP_H_
+
+#include "cy_sim.h"
+
+#endif /* SIM_CYBSP_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,18 @@
+/******************************************************************************
+* File Name: cycfg.h
+*
+* Description: Host simulation shim for the cycfg.h header. See cy_sim.h.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+#ifndef SIM_CYCFG_H_
+#define SIM_CYCFG_H_
+
+#include "cy_sim.h"
+
+#endif /* SIM_CYCFG_H_ */
+
+
+/* [] END OF FILE */
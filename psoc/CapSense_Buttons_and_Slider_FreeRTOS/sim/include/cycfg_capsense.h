@@ -0,0 +1,18 @@
+/******************************************************************************
+* File Name: cycfg_capsense.h
+*
+* Description: Host simulation shim for the cycfg_capsense.h header. See cy_sim.h.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+#ifndef SIM_CYCFG_CAPSENSE_H_
+#define SIM_CYCFG_CAPSENSE_H_
+
+#include "cy_sim.h"
+
+#endif /* SIM_CYCFG_CAPSENSE_H_ */
+
+
+/* [] END OF FILE */
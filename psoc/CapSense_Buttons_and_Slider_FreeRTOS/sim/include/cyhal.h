@@ -0,0 +1,18 @@
+/******************************************************************************
+* File Name: cyhal.h
+*
+* Description: Host simulation shim for the cyhal.h header. See cy_sim.h.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+#ifndef SIM_CYHAL_H_
+#define SIM_CYHAL_H_
+
+#include "cy_sim.h"
+
+#endif /* SIM_CYHAL_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""Convert an RTOS trace buffer (rtos_trace.c) to Chrome trace JSON.
+
+The input is the rtos_trace variable in one piece: the file the host
+simulation writes at the end of a run, or a dump taken by the debugger, e.g.
+
+    (gdb) dump binary value rtos_trace.bin rtos_trace
+
+The output opens in https://ui.perfetto.dev or chrome://tracing. Tasks and
+interrupts get one track each, with a slice for every time they ran; queue,
+timer daemon, event ring and event bus activity are instant events on the
+track of the task or interrupt that caused them.
+
+Usage:
+    rtos_trace_json.py rtos_trace.bin [-o rtos_trace.json]
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = 0x52545452  # "RTTR"
+VERSION = 1
+HEADER = struct.Struct("<8I")
+RECORD = struct.Struct("<IBBH")
+
+# rtos_trace_type_t
+TASK_IN = 1
+TASK_OUT = 2
+ISR_ENTER = 3
+ISR_EXIT = 4
+QUEUE_SEND = 5
+QUEUE_RECEIVE = 6
+TIMER_COMMAND = 7
+TIMER_EXPIRED = 8
+RING_PUSH = 9
+RING_DROP = 10
+RING_POP = 11
+BUS_PUBLISH = 12
+BUS_READ = 13
+
+# Instant events: record type -> (name prefix, name of arg)
+INSTANTS = {
+    QUEUE_SEND: ("send", "from_isr"),
+    QUEUE_RECEIVE: ("receive", "from_isr"),
+    TIMER_COMMAND: ("timer command", "command"),
+    TIMER_EXPIRED: ("timer expired", None),
+    RING_PUSH: ("push", "fill"),
+    RING_DROP: ("drop", "capacity"),
+    RING_POP: ("pop", "events"),
+    BUS_PUBLISH: ("publish", "seq"),
+    BUS_READ: ("read", "seq"),
+}
+
+# Timer daemon command IDs of FreeRTOS (timers.h)
+TIMER_COMMANDS = {
+    0: "start (no trace)", 1: "start", 2: "reset", 3: "stop",
+    4: "change period", 5: "delete", 6: "start from ISR",
+    7: "reset from ISR", 8: "stop from ISR", 9: "change period from ISR",
+}
+
+PID_TASKS = 1
+PID_ISRS = 2
+
+
+class TraceError(Exception):
+    pass
+
+
+def parse(data):
+    """Returns (clock_hz, names, records); records are (time, type, id, arg)
+    in the order they were written, times unwrapped to 64 bits."""
+    if len(data) < HEADER.size:
+        raise TraceError("file is shorter than the trace header")
+    (magic, version, clock_hz, capacity, objects, name_len,
+     _active, head) = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise TraceError("not an RTOS trace buffer (magic 0x%08x)" % magic)
+    if version != VERSION:
+        raise TraceError("trace version %d, expected %d" % (version, VERSION))
+
+    offset = HEADER.size
+    names = []
+    for i in range(objects):
+        raw = data[offset + i * name_len:offset + (i + 1) * name_len]
+        names.append(raw.split(b"\0", 1)[0].decode("ascii", "replace"))
+    offset += (objects * name_len + 3) & ~3
+    if len(data) < offset + capacity * RECORD.size:
+        raise TraceError("file is shorter than %d records" % capacity)
+
+    if head <= capacity:
+        slots = range(head)
+    else:
+        start = head % capacity
+        slots = [(start + i) % capacity for i in range(capacity)]
+
+    records = []
+    last = None
+    now = 0
+    for slot in slots:
+        time, kind, obj, arg = RECORD.unpack_from(data, offset + slot * RECORD.size)
+        if kind == 0:
+            continue  # Reserved but not written when the trace was stopped
+        if last is not None:
+            # Signed difference: the counter wraps, and a record can be a
+            # little older than the one before it
+            delta = (time - last) & 0xFFFFFFFF
+            now += delta - (1 << 32) if delta & 0x80000000 else delta
+        last = time
+        records.append((now, kind, obj, arg))
+
+    # Stable, so that records of equal time keep their order
+    records.sort(key=lambda record: record[0])
+    return clock_hz, names, records
+
+
+def object_name(names, obj, kind):
+    if 0 < obj < len(names) and names[obj]:
+        return names[obj]
+    return "%s %d" % (kind, obj)
+
+
+def convert(clock_hz, names, records):
+    """Returns the list of Chrome trace events."""
+    events = []
+    origin = records[0][0] if records else 0
+    tasks = set()
+    isrs = set()
+    task_start = {}
+    isr_starts = {}
+    isr_stack = []
+    running = 0
+
+    def us(time):
+        return (time - origin) * 1e6 / clock_hz
+
+    for time, kind, obj, arg in records:
+        if kind == TASK_IN:
+            tasks.add(obj)
+            task_start[obj] = time
+            running = obj
+        elif kind == TASK_OUT:
+            tasks.add(obj)
+            start = task_start.pop(obj, None)
+            if start is not None:
+                events.append({"ph": "X", "pid": PID_TASKS, "tid": obj,
+                               "name": object_name(names, obj, "task"),
+                               "ts": us(start), "dur": us(time) - us(start)})
+            running = 0
+        elif kind == ISR_ENTER:
+            isrs.add(obj)
+            isr_starts.setdefault(obj, []).append(time)
+            isr_stack.append(obj)
+        elif kind == ISR_EXIT:
+            isrs.add(obj)
+            if isr_starts.get(obj):
+                start = isr_starts[obj].pop()
+                events.append({"ph": "X", "pid": PID_ISRS, "tid": obj,
+                               "name": object_name(names, obj, "isr"),
+                               "ts": us(start), "dur": us(time) - us(start)})
+            for depth in range(len(isr_stack) - 1, -1, -1):
+                if isr_stack[depth] == obj:
+                    del isr_stack[depth]
+                    break
+        elif kind in INSTANTS:
+            prefix, arg_name = INSTANTS[kind]
+            kind_name = "timer" if kind in (TIMER_COMMAND, TIMER_EXPIRED) else "object"
+            args = {}
+            if arg_name == "command":
+                args[arg_name] = TIMER_COMMANDS.get(arg, arg)
+            elif arg_name is not None:
+                args[arg_name] = arg
+            if isr_stack:
+                pid, tid = PID_ISRS, isr_stack[-1]
+            else:
+                pid, tid = PID_TASKS, running
+                tasks.add(running)
+            events.append({"ph": "i", "s": "t", "pid": pid, "tid": tid,
+                           "name": "%s %s" % (prefix, object_name(names, obj, kind_name)),
+                           "ts": us(time), "args": args})
+
+    # Slices still open at the end of the trace
+    end = records[-1][0] if records else 0
+    for obj, start in task_start.items():
+        events.append({"ph": "X", "pid": PID_TASKS, "tid": obj,
+                       "name": object_name(names, obj, "task"),
+                       "ts": us(start), "dur": us(end) - us(start)})
+
+    meta = [{"ph": "M", "pid": PID_TASKS, "name": "process_name",
+             "args": {"name": "Tasks"}},
+            {"ph": "M", "pid": PID_ISRS, "name": "process_name",
+             "args": {"name": "Interrupts"}}]
+    for obj in sorted(tasks):
+        meta.append({"ph": "M", "pid": PID_TASKS, "tid": obj, "name": "thread_name",
+                     "args": {"name": object_name(names, obj, "task")}})
+    for obj in sorted(isrs):
+        meta.append({"ph": "M", "pid": PID_ISRS, "tid": obj, "name": "thread_name",
+                     "args": {"name": object_name(names, obj, "isr")}})
+    return meta + events
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("trace", help="trace buffer written by the simulation or the debugger")
+    parser.add_argument("-o", "--output", help="JSON file (default: standard output)")
+    args = parser.parse_args(argv)
+
+    with open(args.trace, "rb") as file:
+        data = file.read()
+    try:
+        clock_hz, names, records = parse(data)
+    except TraceError as error:
+        sys.exit("%s: %s" % (args.trace, error))
+
+    trace = {"traceEvents": convert(clock_hz, names, records),
+             "displayTimeUnit": "ns",
+             "otherData": {"clock_hz": clock_hz, "records": len(records)}}
+    if args.output:
+        with open(args.output, "w") as file:
+            json.dump(trace, file)
+    else:
+        json.dump(trace, sys.stdout)
+
+    span = (records[-1][0] - records[0][0]) * 1e3 / clock_hz if records else 0.0
+    print("%d records over %.3f ms" % (len(records), span), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,166 @@
+/******************************************************************************
+* File Name: sim_bus.c
+*
+* Description: Check of the event_bus.c protocol with a producer
+*              thread publishing faster than one of two subscribers reads.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stdio.h>
+#include <sched.h>
+#include <pthread.h>
+#include "cybsp.h"
+#include "event_bus.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Events published by the check */
+#define SIM_BUS_EVENTS              (200000u)
+
+/* The slow subscriber reads once every this many passes of the fast one */
+#define SIM_BUS_SLOW_DIVIDER        (64u)
+
+/* Payload derived from the sequence number, to detect torn events */
+#define SIM_BUS_PAYLOAD(seq)        ((uint32_t)(seq) * 2654435761u)
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static event_bus_t sim_bus;
+static event_bus_ring_t sim_bus_ring;
+static volatile bool sim_bus_done;
+
+
+/*******************************************************************************
+* Function Name: sim_bus_producer
+********************************************************************************
+* Summary:
+*  Publishes a numbered sequence of events without waiting for subscribers.
+*
+*******************************************************************************/
+static void *sim_bus_producer(void *arg)
+{
+    event_bus_event_t *event;
+
+    (void)arg;
+
+    for (uint32_t seq = 1u; seq <= SIM_BUS_EVENTS; seq++)
+    {
+        event = event_bus_claim(&sim_bus);
+        event->widget_id = (uint8_t)seq;
+        event->brightness = SIM_BUS_PAYLOAD(seq);
+        event_bus_publish(&sim_bus, event);
+        if (0u == (seq & 0xFu))
+        {
+            sched_yield();
+        }
+    }
+    sim_bus_done = true;
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_bus_read
+********************************************************************************
+* Summary:
+*  Reads the pending events of a subscriber and halts the simulation if an
+*  intact event is torn or out of order.
+*
+*******************************************************************************/
+static void sim_bus_read(event_bus_sub_t *sub, uint32_t *last_seq)
+{
+    const event_bus_event_t *event;
+    uint32_t seq;
+    uint32_t widget_id;
+    uint32_t brightness;
+
+    while (NULL != (event = event_bus_peek(sub)))
+    {
+        seq = sub->cursor;
+        widget_id = event->widget_id;
+        brightness = event->brightness;
+        if (!event_bus_release(sub))
+        {
+            continue;
+        }
+        if ((seq <= *last_seq) || (widget_id != (uint8_t)seq) ||
+            (brightness != SIM_BUS_PAYLOAD(seq)))
+        {
+            printf("bus: check failed: event %lu after %lu read as %02lx/%08lx\n",
+                   (unsigned long)seq, (unsigned long)*last_seq,
+                   (unsigned long)widget_id, (unsigned long)brightness);
+            CY_ASSERT(0u);
+        }
+        *last_seq = seq;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_bus_check
+********************************************************************************
+* Summary:
+*  Publishes SIM_BUS_EVENTS events from a producer thread to a fast and a slow
+*  subscriber in this thread. Halts the simulation if a subscriber reads a
+*  torn or reordered event, or if read and overrun events do not add up to the
+*  events published.
+*
+*******************************************************************************/
+void sim_bus_check(void)
+{
+    event_bus_sub_t fast;
+    event_bus_sub_t slow;
+    uint32_t fast_seq = 0u;
+    uint32_t slow_seq = 0u;
+    pthread_t producer;
+
+    event_bus_init(&sim_bus, &sim_bus_ring);
+    event_bus_subscribe(&sim_bus, &fast, NULL);
+    event_bus_subscribe(&sim_bus, &slow, NULL);
+    sim_bus_done = false;
+    pthread_create(&producer, NULL, sim_bus_producer, NULL);
+
+    for (uint32_t pass = 0u; !sim_bus_done; pass++)
+    {
+        sim_bus_read(&fast, &fast_seq);
+        if (0u == (pass % SIM_BUS_SLOW_DIVIDER))
+        {
+            sim_bus_read(&slow, &slow_seq);
+        }
+        sched_yield();
+    }
+    pthread_join(producer, NULL);
+    sim_bus_read(&fast, &fast_seq);
+    sim_bus_read(&slow, &slow_seq);
+
+    for (uint32_t i = 0u; i < sim_bus_ring.subscribers; i++)
+    {
+        const event_bus_sub_stats_t *stats = &sim_bus_ring.sub[i];
+
+        if ((stats->read + stats->overruns) != SIM_BUS_EVENTS)
+        {
+            printf("bus: check failed: subscriber %lu read %lu, lost %lu of %lu events\n",
+                   (unsigned long)i, (unsigned long)stats->read,
+                   (unsigned long)stats->overruns, (unsigned long)SIM_BUS_EVENTS);
+            CY_ASSERT(0u);
+        }
+    }
+
+    printf("bus: two-thread check passed (%lu events; fast read=%lu overruns=%lu; slow read=%lu overruns=%lu)\n",
+           (unsigned long)SIM_BUS_EVENTS,
+           (unsigned long)sim_bus_ring.sub[0].read, (unsigned long)sim_bus_ring.sub[0].overruns,
+           (unsigned long)sim_bus_ring.sub[1].read, (unsigned long)sim_bus_ring.sub[1].overruns);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,672 @@
+/******************************************************************************
+* File Name: sim_capsense.c
+*
+* Description: Host stand-in for the CapSense middleware. Every scan consumes
+*              one frame of a recorded sensor trace, synthesizes raw counts for
+*              the two buttons and the 5-segment slider from it, and raises the
+*              CSD interrupt so that the application's end-of-scan path runs
+*              exactly as on the target.
+*
+*              Trace format (one sample per line, '#' starts a comment):
+*                  button0,button1,slider[,frames]
+*              slider is the touch position in 0..xResolution, or -1 when the
+*              slider is not touched. frames repeats the sample for that many
+*              consecutive scans (default 1).
+*
+*              CAPSENSE_SIM_TRACE selects the trace file and CAPSENSE_SIM_LOOPS
+*              how many times it is replayed. Without a trace file a built-in
+*              tap-and-slide sequence is used.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cycfg_capsense.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define SIM_SLIDER_RESOLUTION       (100u)
+#define SIM_SLIDER_SEGMENTS         (5u)
+#define SIM_SLIDER_FIRST_SNS        (2u)
+#define SIM_ALL_WIDGETS             (0xFFFFFFFFu)
+#define SIM_BASELINE                (1000u)
+#define SIM_FINGER_SIGNAL           (300u)
+#define SIM_FINGER_THRESHOLD        (100u)
+#define SIM_MAX_FRAMES              (1u << 20)
+#define SIM_DRAIN_FRAMES            (16u)   /* Untouched scans replayed after
+                                             * the trace so the pipeline can
+                                             * settle before the report.
+                                             */
+
+
+/*******************************************************************************
+* Data structure
+*******************************************************************************/
+typedef struct
+{
+    uint8_t button0;
+    uint8_t button1;
+    int16_t slider;
+} sim_frame_t;
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+cy_stc_capsense_tuner_t cy_capsense_tuner;
+
+static const cy_stc_capsense_common_config_t sim_common_config =
+{
+    .numWd = CY_CAPSENSE_WIDGET_COUNT,
+    .numSns = CY_CAPSENSE_SENSOR_COUNT,
+};
+
+static const cy_stc_capsense_widget_config_t sim_widget_config[CY_CAPSENSE_WIDGET_COUNT] =
+{
+    {
+        .ptrWdContext = &cy_capsense_tuner.widgetContext[CY_CAPSENSE_BUTTON0_WDGT_ID],
+        .ptrSnsContext = &cy_capsense_tuner.sensorContext[0],
+        .numSns = 1u,
+        .wdType = CY_CAPSENSE_WD_BUTTON_E,
+    },
+    {
+        .ptrWdContext = &cy_capsense_tuner.widgetContext[CY_CAPSENSE_BUTTON1_WDGT_ID],
+        .ptrSnsContext = &cy_capsense_tuner.sensorContext[1],
+        .numSns = 1u,
+        .wdType = CY_CAPSENSE_WD_BUTTON_E,
+    },
+    {
+        .ptrWdContext = &cy_capsense_tuner.widgetContext[CY_CAPSENSE_LINEARSLIDER0_WDGT_ID],
+        .ptrSnsContext = &cy_capsense_tuner.sensorContext[SIM_SLIDER_FIRST_SNS],
+        .xResolution = SIM_SLIDER_RESOLUTION,
+        .numSns = SIM_SLIDER_SEGMENTS,
+        .numCols = SIM_SLIDER_SEGMENTS,
+        .wdType = CY_CAPSENSE_WD_LINEAR_SLIDER_E,
+    },
+};
+
+static cy_stc_active_scan_sns_t sim_active_scan_sns;
+static cy_stc_capsense_internal_context_t sim_internal_context;
+
+cy_stc_capsense_context_t cy_capsense_context =
+{
+    .ptrCommonConfig = &sim_common_config,
+    .ptrCommonContext = &cy_capsense_tuner.commonContext,
+    .ptrInternalContext = &sim_internal_context,
+    .ptrWdConfig = sim_widget_config,
+    .ptrWdContext = cy_capsense_tuner.widgetContext,
+    .ptrActiveScanSns = &sim_active_scan_sns,
+};
+
+static sim_frame_t *sim_trace;
+static uint32_t sim_trace_len;
+static uint32_t sim_trace_pos;
+static uint32_t sim_loops_left;
+static uint32_t sim_drain_left = SIM_DRAIN_FRAMES;
+static sim_frame_t sim_current_frame;
+
+static volatile uint32_t sim_busy;
+static uint32_t sim_setup_widget = SIM_ALL_WIDGETS;    /* Set up for Cy_CapSense_Scan() */
+static uint32_t sim_scan_widget = SIM_ALL_WIDGETS;     /* Scan in progress */
+static cy_capsense_callback_t sim_eos_callback;
+
+static uint32_t sim_scan_count;
+static uint32_t sim_process_count;
+static uint32_t sim_tuner_count;
+static uint32_t sim_widget_scan_count;
+static uint32_t sim_widget_process_count;
+
+
+/*******************************************************************************
+* Function Name: sim_trace_append
+********************************************************************************
+* Summary:
+*  Appends a frame to the replay buffer, growing it as required.
+*
+*******************************************************************************/
+static void sim_trace_append(sim_frame_t frame, uint32_t repeat)
+{
+    static uint32_t capacity;
+
+    while ((repeat-- > 0u) && (sim_trace_len < SIM_MAX_FRAMES))
+    {
+        if (sim_trace_len == capacity)
+        {
+            capacity = (0u == capacity) ? 256u : (capacity * 2u);
+            sim_trace = realloc(sim_trace, capacity * sizeof(sim_frame_t));
+            CY_ASSERT(NULL != sim_trace);
+        }
+        sim_trace[sim_trace_len++] = frame;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_trace_builtin
+********************************************************************************
+* Summary:
+*  Builds the default trace: tap Button0, slide across the slider and back,
+*  tap Button1.
+*
+*******************************************************************************/
+static void sim_trace_builtin(void)
+{
+    const sim_frame_t idle = { 0u, 0u, -1 };
+    sim_frame_t frame = idle;
+
+    sim_trace_append(idle, 10u);
+    frame.button0 = 1u;
+    sim_trace_append(frame, 5u);
+    sim_trace_append(idle, 10u);
+
+    for (int16_t pos = 0; pos <= (int16_t)SIM_SLIDER_RESOLUTION; pos += 2)
+    {
+        frame = idle;
+        frame.slider = pos;
+        sim_trace_append(frame, 1u);
+    }
+    for (int16_t pos = (int16_t)SIM_SLIDER_RESOLUTION; pos >= 0; pos -= 5)
+    {
+        frame = idle;
+        frame.slider = pos;
+        sim_trace_append(frame, 1u);
+    }
+
+    sim_trace_append(idle, 10u);
+    frame = idle;
+    frame.button1 = 1u;
+    sim_trace_append(frame, 5u);
+    sim_trace_append(idle, 10u);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_trace_load
+********************************************************************************
+* Summary:
+*  Loads the trace selected by CAPSENSE_SIM_TRACE, or the built-in one.
+*
+*******************************************************************************/
+static void sim_trace_load(void)
+{
+    const char *path = getenv("CAPSENSE_SIM_TRACE");
+    const char *loops = getenv("CAPSENSE_SIM_LOOPS");
+    char line[128];
+
+    sim_loops_left = (NULL != loops) ? (uint32_t)strtoul(loops, NULL, 0) : 1u;
+    if (0u == sim_loops_left)
+    {
+        sim_loops_left = 1u;
+    }
+
+    if ((NULL == path) || ('\0' == path[0]))
+    {
+        sim_trace_builtin();
+        return;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (NULL == file)
+    {
+        fprintf(stderr, "sim: cannot open trace '%s'\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        unsigned int b0, b1, frames = 1u;
+        int slider;
+
+        if (('#' == line[0]) || ('\n' == line[0]))
+        {
+            continue;
+        }
+        if (sscanf(line, "%u,%u,%d,%u", &b0, &b1, &slider, &frames) >= 3)
+        {
+            sim_frame_t frame = { (uint8_t)(b0 != 0u), (uint8_t)(b1 != 0u), (int16_t)slider };
+            sim_trace_append(frame, frames);
+        }
+    }
+    fclose(file);
+
+    if (0u == sim_trace_len)
+    {
+        fprintf(stderr, "sim: trace '%s' holds no samples\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_next_frame
+********************************************************************************
+* Summary:
+*  Returns the next frame to replay. Once all loops have been replayed a few
+*  untouched frames are returned before the simulation is finished.
+*
+*******************************************************************************/
+static bool sim_next_frame(sim_frame_t *frame)
+{
+    static const sim_frame_t idle = { 0u, 0u, -1 };
+
+    if (sim_loops_left > 0u)
+    {
+        *frame = sim_trace[sim_trace_pos++];
+        if (sim_trace_pos == sim_trace_len)
+        {
+            sim_trace_pos = 0u;
+            sim_loops_left--;
+        }
+        return true;
+    }
+
+    *frame = idle;
+    return (sim_drain_left-- > 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_load_raw_counts
+********************************************************************************
+* Summary:
+*  Synthesizes raw counts from the current frame for the sensors of one
+*  widget, or of all widgets. Slider segments see a triangular signal profile
+*  around the touch position.
+*
+*******************************************************************************/
+static void sim_load_raw_counts(const sim_frame_t *frame, uint32_t widget)
+{
+    cy_stc_capsense_sensor_context_t *sns = cy_capsense_tuner.sensorContext;
+    const int32_t pitch = (int32_t)(SIM_SLIDER_RESOLUTION / (SIM_SLIDER_SEGMENTS - 1u));
+    uint16_t raw[CY_CAPSENSE_SENSOR_COUNT];
+    uint32_t first = 0u;
+    uint32_t count = CY_CAPSENSE_SENSOR_COUNT;
+
+    raw[0] = (uint16_t)(SIM_BASELINE + (frame->button0 ? SIM_FINGER_SIGNAL : 0u));
+    raw[1] = (uint16_t)(SIM_BASELINE + (frame->button1 ? SIM_FINGER_SIGNAL : 0u));
+
+    for (uint32_t seg = 0u; seg < SIM_SLIDER_SEGMENTS; seg++)
+    {
+        int32_t signal = 0;
+
+        if (frame->slider >= 0)
+        {
+            int32_t distance = abs((int32_t)frame->slider - ((int32_t)seg * pitch));
+            signal = (int32_t)SIM_FINGER_SIGNAL - ((distance * (int32_t)SIM_FINGER_SIGNAL) / pitch);
+            signal = (signal < 0) ? 0 : signal;
+        }
+        raw[SIM_SLIDER_FIRST_SNS + seg] = (uint16_t)(SIM_BASELINE + (uint32_t)signal);
+    }
+
+    if (SIM_ALL_WIDGETS != widget)
+    {
+        first = (uint32_t)(sim_widget_config[widget].ptrSnsContext - sns);
+        count = sim_widget_config[widget].numSns;
+    }
+    for (uint32_t i = first; i < (first + count); i++)
+    {
+        sns[i].raw = raw[i];
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_Init
+*******************************************************************************/
+cy_status Cy_CapSense_Init(cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    memset(&cy_capsense_tuner, 0, sizeof(cy_capsense_tuner));
+    for (uint32_t wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        cy_capsense_tuner.widgetContext[wd].fingerTh = SIM_FINGER_THRESHOLD;
+        cy_capsense_tuner.widgetContext[wd].hysteresis = SIM_FINGER_THRESHOLD / 8u;
+        cy_capsense_tuner.widgetContext[wd].resolution = 12u;
+    }
+    cy_capsense_tuner.widgetContext[CY_CAPSENSE_LINEARSLIDER0_WDGT_ID].wdTouch.ptrPosition =
+        &cy_capsense_tuner.position[0];
+
+    sim_trace_load();
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_Enable
+*******************************************************************************/
+cy_status Cy_CapSense_Enable(cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    for (uint32_t sns = 0u; sns < CY_CAPSENSE_SENSOR_COUNT; sns++)
+    {
+        cy_capsense_tuner.sensorContext[sns].raw = SIM_BASELINE;
+        cy_capsense_tuner.sensorContext[sns].bsln = SIM_BASELINE;
+        cy_capsense_tuner.sensorContext[sns].diff = 0u;
+    }
+    cy_capsense_tuner.commonContext.initDone = 1u;
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_IsBusy
+*******************************************************************************/
+uint32_t Cy_CapSense_IsBusy(const cy_stc_capsense_context_t *context)
+{
+    (void)context;
+    return sim_busy;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_start_scan
+********************************************************************************
+* Summary:
+*  Raises the CSD interrupt, which completes the scan on the next RTOS tick.
+*  A scan of all widgets, or of a widget not above the previously scanned
+*  one, latches the next trace frame. Finishes the simulation once the trace
+*  is exhausted.
+*
+*******************************************************************************/
+static void sim_start_scan(uint32_t widget)
+{
+    static uint32_t last_widget = SIM_ALL_WIDGETS;
+
+    if ((SIM_ALL_WIDGETS == widget) || (SIM_ALL_WIDGETS == last_widget) ||
+        (widget <= last_widget))
+    {
+        if (!sim_next_frame(&sim_current_frame))
+        {
+            sim_finish();
+        }
+        sim_scan_count++;
+    }
+
+    last_widget = widget;
+    sim_scan_widget = widget;
+    sim_busy = CY_CAPSENSE_BUSY;
+    sim_irq_raise(csd_interrupt_IRQn);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_ScanAllWidgets
+*******************************************************************************/
+cy_status Cy_CapSense_ScanAllWidgets(cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    sim_start_scan(SIM_ALL_WIDGETS);
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_SetupWidget
+*******************************************************************************/
+cy_status Cy_CapSense_SetupWidget(uint32_t widgetId, cy_stc_capsense_context_t *context)
+{
+    if ((widgetId >= context->ptrCommonConfig->numWd) || (CY_CAPSENSE_BUSY == sim_busy))
+    {
+        return CY_RET_BAD_PARAM;
+    }
+
+    sim_setup_widget = widgetId;
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_Scan
+*******************************************************************************/
+cy_status Cy_CapSense_Scan(cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    if ((SIM_ALL_WIDGETS == sim_setup_widget) || (CY_CAPSENSE_BUSY == sim_busy))
+    {
+        return CY_RET_INVALID_STATE;
+    }
+
+    sim_widget_scan_count++;
+    sim_start_scan(sim_setup_widget);
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_InterruptHandler
+*******************************************************************************/
+void Cy_CapSense_InterruptHandler(const CSD_Type *base, cy_stc_capsense_context_t *context)
+{
+    (void)base;
+
+    if (CY_CAPSENSE_BUSY != sim_busy)
+    {
+        return;
+    }
+
+    sim_load_raw_counts(&sim_current_frame, sim_scan_widget);
+    context->ptrCommonContext->scanCounter++;
+    sim_busy = CY_CAPSENSE_NOT_BUSY;
+
+    if (NULL != sim_eos_callback)
+    {
+        sim_eos_callback(context->ptrActiveScanSns);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_process_widget
+********************************************************************************
+* Summary:
+*  Updates diff counts and sensor/widget status from the last scan. The slider
+*  position is taken straight from the trace instead of a centroid.
+*
+*******************************************************************************/
+static void sim_process_widget(const cy_stc_capsense_context_t *context, uint32_t widget)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg = &context->ptrWdConfig[widget];
+    cy_stc_capsense_widget_context_t *wd_ctx = wd_cfg->ptrWdContext;
+    uint8_t wd_status = 0u;
+
+    for (uint32_t sns = 0u; sns < wd_cfg->numSns; sns++)
+    {
+        cy_stc_capsense_sensor_context_t *sns_ctx = &wd_cfg->ptrSnsContext[sns];
+
+        sns_ctx->diff = (sns_ctx->raw > sns_ctx->bsln) ? (uint16_t)(sns_ctx->raw - sns_ctx->bsln) : 0u;
+        sns_ctx->status = (sns_ctx->diff >= wd_ctx->fingerTh) ? CY_CAPSENSE_SNS_TOUCH_STATUS_MASK : 0u;
+        wd_status |= sns_ctx->status;
+    }
+    wd_ctx->status = wd_status ? CY_CAPSENSE_WD_ACTIVE_MASK : 0u;
+
+    if ((CY_CAPSENSE_WD_LINEAR_SLIDER_E == wd_cfg->wdType) && (NULL != wd_ctx->wdTouch.ptrPosition))
+    {
+        wd_ctx->wdTouch.numPosition = wd_status ? 1u : 0u;
+        if (wd_status)
+        {
+            wd_ctx->wdTouch.ptrPosition->x = (uint16_t)sim_current_frame.slider;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_ProcessAllWidgets
+*******************************************************************************/
+cy_status Cy_CapSense_ProcessAllWidgets(cy_stc_capsense_context_t *context)
+{
+    for (uint32_t wd = 0u; wd < context->ptrCommonConfig->numWd; wd++)
+    {
+        sim_process_widget(context, wd);
+    }
+
+    sim_process_count++;
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_ProcessWidget
+*******************************************************************************/
+cy_status Cy_CapSense_ProcessWidget(uint32_t widgetId, cy_stc_capsense_context_t *context)
+{
+    if (widgetId >= context->ptrCommonConfig->numWd)
+    {
+        return CY_RET_BAD_PARAM;
+    }
+
+    sim_process_widget(context, widgetId);
+    sim_widget_process_count++;
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_RunTuner
+*******************************************************************************/
+uint32_t Cy_CapSense_RunTuner(cy_stc_capsense_context_t *context)
+{
+    cy_stc_capsense_common_context_t *common = context->ptrCommonContext;
+    cy_stc_capsense_internal_context_t *internal = context->ptrInternalContext;
+    uint8_t *command_packet;
+    uint8_t *tuner_packet;
+
+    sim_tuner_count++;
+
+    /* Like the middleware, stay here while the Tuner has suspended scanning */
+    do
+    {
+        if (NULL != internal->ptrTunerReceiveCallback)
+        {
+            internal->ptrTunerReceiveCallback(&command_packet, &tuner_packet, context);
+        }
+
+        if (CY_CAPSENSE_TU_CMD_SUSPEND_E == common->tunerCmd)
+        {
+            common->tunerSt = CY_CAPSENSE_TU_FSM_SUSPENDED;
+        }
+        else if (CY_CAPSENSE_TU_CMD_RESUME_E == common->tunerCmd)
+        {
+            common->tunerSt = CY_CAPSENSE_TU_FSM_RUNNING;
+        }
+        common->tunerCmd = CY_CAPSENSE_TU_CMD_NONE_E;
+    } while (CY_CAPSENSE_TU_FSM_SUSPENDED == common->tunerSt);
+
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_IsAnyWidgetActive
+*******************************************************************************/
+uint32_t Cy_CapSense_IsAnyWidgetActive(const cy_stc_capsense_context_t *context)
+{
+    uint32_t active = 0u;
+
+    for (uint32_t wd = 0u; wd < context->ptrCommonConfig->numWd; wd++)
+    {
+        active |= Cy_CapSense_IsWidgetActive(wd, context);
+    }
+    return active;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_IsWidgetActive
+*******************************************************************************/
+uint32_t Cy_CapSense_IsWidgetActive(uint32_t widgetId, const cy_stc_capsense_context_t *context)
+{
+    return (uint32_t)context->ptrWdConfig[widgetId].ptrWdContext->status & CY_CAPSENSE_WD_ACTIVE_MASK;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_IsSensorActive
+*******************************************************************************/
+uint32_t Cy_CapSense_IsSensorActive(uint32_t widgetId, uint32_t sensorId,
+                                    const cy_stc_capsense_context_t *context)
+{
+    return (uint32_t)context->ptrWdConfig[widgetId].ptrSnsContext[sensorId].status &
+           CY_CAPSENSE_SNS_TOUCH_STATUS_MASK;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_GetTouchInfo
+*******************************************************************************/
+cy_stc_capsense_touch_t *Cy_CapSense_GetTouchInfo(uint32_t widgetId,
+                                                   const cy_stc_capsense_context_t *context)
+{
+    return &context->ptrWdConfig[widgetId].ptrWdContext->wdTouch;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_RegisterCallback
+*******************************************************************************/
+cy_status Cy_CapSense_RegisterCallback(cy_en_capsense_callback_event_t callbackType,
+                                       cy_capsense_callback_t callbackFunction,
+                                       cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    if (CY_CAPSENSE_END_OF_SCAN_E == callbackType)
+    {
+        sim_eos_callback = callbackFunction;
+    }
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_Wakeup
+*******************************************************************************/
+void Cy_CapSense_Wakeup(const cy_stc_capsense_context_t *context)
+{
+    (void)context;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_DeepSleepCallback
+*******************************************************************************/
+cy_en_syspm_status_t Cy_CapSense_DeepSleepCallback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                   cy_en_syspm_callback_mode_t mode)
+{
+    (void)callbackParams;
+    (void)mode;
+    return (CY_CAPSENSE_NOT_BUSY == sim_busy) ? CY_SYSPM_SUCCESS : CY_SYSPM_FAIL;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_capsense_report
+********************************************************************************
+* Summary:
+*  Prints the CapSense side of the end-of-run report.
+*
+*******************************************************************************/
+void sim_capsense_report(void)
+{
+    printf("capsense: frames=%lu scans=%lu processed=%lu tuner=%lu "
+           "widget_scans=%lu widget_processed=%lu\n",
+           (unsigned long)sim_trace_len, (unsigned long)sim_scan_count,
+           (unsigned long)sim_process_count, (unsigned long)sim_tuner_count,
+           (unsigned long)sim_widget_scan_count, (unsigned long)sim_widget_process_count);
+}
+
+
+/* [] END OF FILE */
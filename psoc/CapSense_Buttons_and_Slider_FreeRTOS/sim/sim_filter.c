@@ -0,0 +1,299 @@
+/******************************************************************************
+* File Name: sim_filter.c
+*
+* Description: Check and benchmark of the slider filter. Replays
+*              scripted slider sequences through touch_filter.c and verifies
+*              that
+*
+*              - a step converges to the new position without overshoot,
+*              - a single-scan spike does not change the brightness,
+*              - jitter within the hysteresis is not reported,
+*              - a fast lift-off is a flick to 100% or 0%,
+*              - a long travel that comes to rest is a swipe,
+*              - a short, slow drag is no gesture,
+*
+*              then times touch_filter_update() over a long sweep.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stdio.h>
+#include "cybsp.h"
+#include "touch_filter.h"
+#include "cycle_counter.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* With this resolution a slider position is a percentage */
+#define SIM_FILTER_RESOLUTION       (100u)
+
+/* Updates timed by the benchmark */
+#define SIM_FILTER_BENCH_UPDATES    (1000000u)
+
+#define SIM_FILTER_EXPECT(cond, ...) \
+    do { if (!(cond)) { printf("filter: check failed: " __VA_ARGS__); printf("\n"); CY_ASSERT(0u); } } while(0)
+
+
+/*******************************************************************************
+* Data structure
+*******************************************************************************/
+/* Outcome of a sequence of scans */
+typedef struct
+{
+    uint32_t reports;           /* Brightness changes */
+    uint32_t brightness;        /* Last reported brightness */
+    touch_gesture_t gesture;    /* Gesture of the lift-off */
+    bool lift_changed;          /* The lift-off changed the brightness */
+} sim_filter_result_t;
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static touch_filter_t sim_filter;
+static touch_filter_stats_t sim_filter_stats;
+
+
+/*******************************************************************************
+* Function Name: sim_filter_touch
+********************************************************************************
+* Summary:
+*  Feeds touched samples moving linearly from one position to another and
+*  then holding it.
+*
+* Parameters:
+*  uint32_t from, to            : Positions of the first and the last sample
+*  uint32_t scans               : Samples from "from" to "to"
+*  uint32_t hold                : Additional samples at "to"
+*  sim_filter_result_t *result  : Accumulates the reports
+*
+*******************************************************************************/
+static void sim_filter_touch(uint32_t from, uint32_t to, uint32_t scans, uint32_t hold,
+                             sim_filter_result_t *result)
+{
+    touch_filter_output_t output;
+    int32_t span = (int32_t)to - (int32_t)from;
+    uint32_t position;
+
+    for (uint32_t i = 0u; i < (scans + hold); i++)
+    {
+        position = ((i + 1u) >= scans) ? to :
+                   (uint32_t)((int32_t)from + ((span * (int32_t)i) / (int32_t)(scans - 1u)));
+        if (touch_filter_update(&sim_filter, true, (uint16_t)position, &output))
+        {
+            result->reports++;
+            result->brightness = output.brightness;
+        }
+        SIM_FILTER_EXPECT(TOUCH_GESTURE_NONE == output.gesture, "gesture while touched");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_filter_lift
+********************************************************************************
+* Summary:
+*  Ends the touch and records the gesture.
+*
+*******************************************************************************/
+static void sim_filter_lift(sim_filter_result_t *result)
+{
+    touch_filter_output_t output;
+
+    result->lift_changed = touch_filter_update(&sim_filter, false, 0u, &output);
+    result->gesture = output.gesture;
+    if (result->lift_changed)
+    {
+        result->brightness = output.brightness;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_filter_check_shape
+********************************************************************************
+* Summary:
+*  Checks smoothing, spike rejection and hysteresis.
+*
+*******************************************************************************/
+static void sim_filter_check_shape(void)
+{
+    sim_filter_result_t result = { 0u };
+    touch_filter_output_t output;
+    uint32_t previous = 0u;
+
+    /* A step converges monotonically and without overshoot */
+    touch_filter_init(&sim_filter, SIM_FILTER_RESOLUTION, &sim_filter_stats);
+    sim_filter_touch(20u, 20u, 1u, 3u, &result);
+    SIM_FILTER_EXPECT((1u == result.reports) && (20u == result.brightness),
+                      "touch-down reported %lu times at %lu%%",
+                      (unsigned long)result.reports, (unsigned long)result.brightness);
+    for (uint32_t i = 0u; i < 40u; i++)
+    {
+        if (touch_filter_update(&sim_filter, true, 80u, &output))
+        {
+            SIM_FILTER_EXPECT((output.brightness >= previous) && (output.brightness <= 80u),
+                              "step reported %lu%% after %lu%%",
+                              (unsigned long)output.brightness, (unsigned long)previous);
+            previous = output.brightness;
+        }
+    }
+    SIM_FILTER_EXPECT(previous >= (80u - TOUCH_FILTER_HYSTERESIS_PCT),
+                      "step settled at %lu%%", (unsigned long)previous);
+    sim_filter_lift(&result);
+
+#if TOUCH_FILTER_MEDIAN
+    /* A single-scan spike is removed by the median */
+    result = (sim_filter_result_t){ 0u };
+    sim_filter_touch(50u, 50u, 1u, 5u, &result);
+    sim_filter_touch(95u, 95u, 1u, 0u, &result);
+    sim_filter_touch(50u, 50u, 1u, 5u, &result);
+    SIM_FILTER_EXPECT((1u == result.reports) && (50u == result.brightness),
+                      "spike reported %lu times, last %lu%%",
+                      (unsigned long)result.reports, (unsigned long)result.brightness);
+    sim_filter_lift(&result);
+#endif
+
+    /* Jitter within the hysteresis is not reported, a larger move is */
+    touch_filter_init(&sim_filter, SIM_FILTER_RESOLUTION, &sim_filter_stats);
+    result = (sim_filter_result_t){ 0u };
+    sim_filter_touch(50u, 50u, 1u, 3u, &result);
+    for (uint32_t i = 0u; i < 50u; i++)
+    {
+        sim_filter_touch(50u + (i & 1u), 50u + (i & 1u), 1u, 0u, &result);
+    }
+    SIM_FILTER_EXPECT(1u == result.reports, "jitter reported %lu times", (unsigned long)result.reports);
+    sim_filter_touch(60u, 60u, 1u, 20u, &result);
+    SIM_FILTER_EXPECT((result.reports > 1u) && (result.brightness >= (60u - TOUCH_FILTER_HYSTERESIS_PCT)),
+                      "move reported %lu times, last %lu%%",
+                      (unsigned long)result.reports, (unsigned long)result.brightness);
+    sim_filter_lift(&result);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_filter_check_gestures
+********************************************************************************
+* Summary:
+*  Checks the classification of lift-offs.
+*
+*******************************************************************************/
+static void sim_filter_check_gestures(void)
+{
+    sim_filter_result_t result = { 0u };
+
+    touch_filter_init(&sim_filter, SIM_FILTER_RESOLUTION, &sim_filter_stats);
+
+    /* Lifted while moving fast */
+    sim_filter_touch(10u, 90u, 9u, 0u, &result);
+    sim_filter_lift(&result);
+    SIM_FILTER_EXPECT((TOUCH_GESTURE_FLICK_UP == result.gesture) && result.lift_changed &&
+                      (100u == result.brightness), "flick up read as gesture %d at %lu%%",
+                      (int)result.gesture, (unsigned long)result.brightness);
+
+    result = (sim_filter_result_t){ 0u };
+    sim_filter_touch(90u, 10u, 9u, 0u, &result);
+    sim_filter_lift(&result);
+    SIM_FILTER_EXPECT((TOUCH_GESTURE_FLICK_DOWN == result.gesture) && result.lift_changed &&
+                      (0u == result.brightness), "flick down read as gesture %d at %lu%%",
+                      (int)result.gesture, (unsigned long)result.brightness);
+
+    /* Long travel that comes to rest before the lift-off */
+    result = (sim_filter_result_t){ 0u };
+    sim_filter_touch(10u, 70u, 61u, 15u, &result);
+    sim_filter_lift(&result);
+    SIM_FILTER_EXPECT((TOUCH_GESTURE_SWIPE_UP == result.gesture) && !result.lift_changed,
+                      "swipe up read as gesture %d", (int)result.gesture);
+
+    result = (sim_filter_result_t){ 0u };
+    sim_filter_touch(70u, 10u, 61u, 15u, &result);
+    sim_filter_lift(&result);
+    SIM_FILTER_EXPECT((TOUCH_GESTURE_SWIPE_DOWN == result.gesture) && !result.lift_changed,
+                      "swipe down read as gesture %d", (int)result.gesture);
+
+    /* The same travel spread over too many scans */
+    result = (sim_filter_result_t){ 0u };
+    sim_filter_touch(10u, 70u, TOUCH_FILTER_SWIPE_MAX_SCANS + 1u, 15u, &result);
+    sim_filter_lift(&result);
+    SIM_FILTER_EXPECT(TOUCH_GESTURE_NONE == result.gesture,
+                      "slow travel read as gesture %d", (int)result.gesture);
+
+    /* Short, slow drag */
+    result = (sim_filter_result_t){ 0u };
+    sim_filter_touch(10u, 30u, 41u, 5u, &result);
+    sim_filter_lift(&result);
+    SIM_FILTER_EXPECT(TOUCH_GESTURE_NONE == result.gesture,
+                      "drag read as gesture %d", (int)result.gesture);
+
+    SIM_FILTER_EXPECT((2u == sim_filter_stats.flicks) && (2u == sim_filter_stats.swipes),
+                      "counted %lu flicks and %lu swipes",
+                      (unsigned long)sim_filter_stats.flicks, (unsigned long)sim_filter_stats.swipes);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_filter_bench
+********************************************************************************
+* Summary:
+*  Times SIM_FILTER_BENCH_UPDATES updates over a sweep of the slider with
+*  regular lift-offs.
+*
+* Return:
+*  Counter ticks per update, measured around the whole loop
+*
+*******************************************************************************/
+static uint32_t sim_filter_bench(void)
+{
+    touch_filter_output_t output;
+    uint32_t start;
+    uint32_t reports = 0u;
+
+    touch_filter_init(&sim_filter, SIM_FILTER_RESOLUTION, &sim_filter_stats);
+    start = cycle_counter_get();
+    for (uint32_t i = 0u; i < SIM_FILTER_BENCH_UPDATES; i++)
+    {
+        /* Touched for 200 scans sweeping the slider, then 56 scans lifted */
+        bool touched = ((i & 0xFFu) < 200u);
+        uint16_t position = (uint16_t)((i & 0xFFu) >> 1);
+
+        reports += touch_filter_update(&sim_filter, touched, position, &output) ? 1u : 0u;
+    }
+    start = cycle_counter_get() - start;
+    SIM_FILTER_EXPECT(reports == sim_filter_stats.reports, "benchmark reported %lu of %lu changes",
+                      (unsigned long)reports, (unsigned long)sim_filter_stats.reports);
+    return start / SIM_FILTER_BENCH_UPDATES;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_filter_check
+********************************************************************************
+* Summary:
+*  Runs the filter checks and the benchmark, and halts the simulation on the
+*  first failure. The cycle counter of the host runs in nanoseconds; the
+*  in-call average also counts the two reads of the counter.
+*
+*******************************************************************************/
+void sim_filter_check(void)
+{
+    uint32_t loop_cycles;
+
+    sim_filter_check_shape();
+    sim_filter_check_gestures();
+    loop_cycles = sim_filter_bench();
+    touch_filter_publish(&sim_filter);
+
+    printf("filter: check passed; %lu updates, cycles per update loop=%lu in-call avg=%lu max=%lu\n",
+           (unsigned long)sim_filter_stats.samples, (unsigned long)loop_cycles,
+           (unsigned long)sim_filter_stats.cycles_avg, (unsigned long)sim_filter_stats.cycles_max);
+}
+
+
+/* [] END OF FILE */
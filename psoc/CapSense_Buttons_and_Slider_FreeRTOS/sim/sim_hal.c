@@ -0,0 +1,1126 @@
+/******************************************************************************
+* File Name: sim_hal.c
+*
+* Description: Host stand-ins for the BSP, PDL interrupt/SysPm helpers and the
+*              PWM and EzI2C HAL drivers used by this application, plus the
+*              static memory hooks the FreeRTOS kernel expects from the port.
+*
+*              Interrupts are modelled as a vector table: raising an enabled
+*              interrupt marks it pending, and the RTOS tick hook runs the
+*              pending handlers in interrupt context on the next tick. The
+*              LPTIMER is derived from the tick count and fires from the same
+*              hook, so all simulated interrupts are serialized.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "cybsp.h"
+#include "cyhal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "diag_i2c.h"
+#include "rtos_trace.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define SIM_LPTIMER_COUNT           (2u)    /* MCWDT instances of the device */
+#define SIM_EZI2C_SCB               (3u)    /* SCB of the kit's I2C pins */
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+CSD_Type sim_csd_hw;
+
+static cy_israddress sim_vectors[SIM_IRQ_COUNT];
+static bool sim_irq_enabled[SIM_IRQ_COUNT];
+static volatile bool sim_irq_pending[SIM_IRQ_COUNT];
+static bool sim_irq_global = false;
+static cyhal_lptimer_t *sim_lptimers[SIM_LPTIMER_COUNT];
+static uint32_t sim_lptimer_count;
+
+static cy_stc_syspm_callback_t *sim_syspm_callbacks;
+
+static TCPWM_Type sim_tcpwm;
+static cyhal_pwm_t *sim_pwm;
+static uint32_t sim_pwm_duty_updates;
+static uint32_t sim_pwm_starts;
+static uint32_t sim_pwm_stops;
+static uint32_t sim_pwm_compare_writes;
+static cyhal_dma_t *sim_dma;
+static uint32_t sim_dma_writes;
+static uint32_t sim_flash_row_writes;
+
+static cyhal_ezi2c_t *sim_ezi2c;
+static uint32_t sim_ezi2c_poll_bytes;
+static volatile uint8_t sim_ezi2c_last_byte;
+
+static struct timespec sim_start_time;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void sim_dma_tick(void);
+
+
+/*******************************************************************************
+* Function Name: cybsp_init
+********************************************************************************
+* Summary:
+*  Starts the wall clock used for the end-of-run report. A SIM_CHECK build
+*  (make check) runs the protocol and rule checks instead of the
+*  application and exits; the run, bench and trace builds never run them.
+*
+*******************************************************************************/
+cy_rslt_t cybsp_init(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &sim_start_time);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+#if SIM_CHECK
+    sim_ring_check();
+    sim_filter_check();
+    sim_power_check();
+    sim_planner_check();
+    sim_ipc_check();
+    sim_bus_check();
+    printf("sim: all checks passed\n");
+    exit(EXIT_SUCCESS);
+#endif
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_halt
+********************************************************************************
+* Summary:
+*  Target CY_ASSERT halts the CPU; on the host the process is aborted.
+*
+*******************************************************************************/
+void sim_halt(const char *file, int line)
+{
+    fprintf(stderr, "sim: CY_ASSERT failed at %s:%d\n", file, line);
+    abort();
+}
+
+
+/*******************************************************************************
+* Function Name: sim_latency_report
+********************************************************************************
+* Summary:
+*  Prints the latency summaries as a host would read them over EzI2C.
+*
+*******************************************************************************/
+static void sim_latency_report(void)
+{
+#if APP_LATENCY_TRACE
+    static const char *const stage_names[LATENCY_STAGE_COUNT - 1u] =
+    {
+        "scan_start", "end_of_scan", "process", "led_send", "pwm_update"
+    };
+    const latency_report_t *report = &diag_i2c_map.latency;
+
+    latency_trace_publish();
+    printf("latency: samples=%lu dropped=%lu\n",
+           (unsigned long)report->samples, (unsigned long)report->dropped);
+    for (uint32_t stage = 0u; stage < (LATENCY_STAGE_COUNT - 1u); stage++)
+    {
+        printf("  %-12s p50<%6lu us  p99<%6lu us  max=%6lu us\n",
+               stage_names[stage],
+               (unsigned long)report->stage[stage].p50_us,
+               (unsigned long)report->stage[stage].p99_us,
+               (unsigned long)report->stage[stage].max_us);
+    }
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ring_report
+********************************************************************************
+* Summary:
+*  Prints the counters of one event ring.
+*
+*******************************************************************************/
+static void sim_ring_report(const char *name, const event_ring_stats_t *stats)
+{
+    printf("ring %-8s pushed=%lu dropped=%lu high_water=%lu batches=%lu\n", name,
+           (unsigned long)stats->pushed, (unsigned long)stats->dropped,
+           (unsigned long)stats->high_water, (unsigned long)stats->batches);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_signal_report
+********************************************************************************
+* Summary:
+*  Prints the cost of signalling task_capsense (APP_SIGNAL_BENCH).
+*
+*******************************************************************************/
+static void sim_signal_report(void)
+{
+#if APP_SIGNAL_BENCH
+    const capsense_signal_stats_t *stats = &diag_i2c_map.capsense_signal;
+
+    printf("signal: mode=%s scan_cycles=%lu scan_hop=%lu process_hop=%lu "
+           "cycles_per_scan_cycle=%lu max=%lu\n",
+           (0u != stats->mode) ? "notify" : "ring",
+           (unsigned long)stats->scan_cycles, (unsigned long)stats->scan_hop_avg,
+           (unsigned long)stats->process_hop_avg, (unsigned long)stats->cycle_avg,
+           (unsigned long)stats->cycle_max);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_frame_report
+********************************************************************************
+* Summary:
+*  Prints the frame counters of task_capsense.
+*
+*******************************************************************************/
+static void sim_frame_report(void)
+{
+    const capsense_frame_stats_t *stats = &diag_i2c_map.capsense_frame;
+
+    printf("frame: pipelined=%lu frames=%lu deferred=%lu overruns=%lu time avg=%lu us max=%lu us\n",
+           (unsigned long)stats->pipelined, (unsigned long)stats->frames,
+           (unsigned long)stats->deferred_ticks, (unsigned long)stats->overruns,
+           (unsigned long)stats->frame_us_avg, (unsigned long)stats->frame_us_max);
+
+#if APP_CAPSENSE_PIPELINE
+    const scan_planner_stats_t *planner = &diag_i2c_map.scan_planner;
+
+    printf("planner: partial_frames=%lu skipped_scans=%lu scan_hz",
+           (unsigned long)planner->partial_frames, (unsigned long)planner->skipped_scans);
+    for (uint32_t widget = 0u; widget < CY_CAPSENSE_WIDGET_COUNT; widget++)
+    {
+        printf(" %u", (unsigned)planner->scan_hz[widget]);
+    }
+    printf("\n");
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_scheduler_report
+********************************************************************************
+* Summary:
+*  Prints the scan scheduler counters.
+*
+*******************************************************************************/
+static void sim_scheduler_report(void)
+{
+    const scan_scheduler_stats_t *stats = &diag_i2c_map.scan_scheduler;
+
+    printf("scan: fast=%lu idle=%lu skipped=%lu interval=%lu ms "
+           "jitter avg=%lu us max=%lu us\n",
+           (unsigned long)stats->fast_scans, (unsigned long)stats->idle_scans,
+           (unsigned long)stats->skipped_ticks, (unsigned long)stats->interval_ms,
+           (unsigned long)stats->jitter_avg_us, (unsigned long)stats->jitter_max_us);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_power_report
+********************************************************************************
+* Summary:
+*  Prints the residency the low-power idle would have reached.
+*
+*******************************************************************************/
+static void sim_power_report(void)
+{
+    const power_mgr_stats_t *stats = &diag_i2c_map.power;
+
+    printf("power: sleeps=%lu deep_sleeps=%lu residency active=%lu sleep=%lu "
+           "deep_sleep=%lu (permille)\n",
+           (unsigned long)stats->sleeps, (unsigned long)stats->deep_sleeps,
+           (unsigned long)stats->active_permille, (unsigned long)stats->sleep_permille,
+           (unsigned long)stats->deep_sleep_permille);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_filter_report
+********************************************************************************
+* Summary:
+*  Prints the cost and the gestures of the slider filter.
+*
+*******************************************************************************/
+static void sim_filter_report(void)
+{
+    const touch_filter_stats_t *stats = &diag_i2c_map.touch_filter;
+
+    printf("filter: samples=%lu reports=%lu cycles avg=%lu max=%lu swipes=%lu flicks=%lu\n",
+           (unsigned long)stats->samples, (unsigned long)stats->reports,
+           (unsigned long)stats->cycles_avg, (unsigned long)stats->cycles_max,
+           (unsigned long)stats->swipes, (unsigned long)stats->flicks);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_telemetry_report
+********************************************************************************
+* Summary:
+*  Checks the newest telemetry record the way a host would read it.
+*
+*******************************************************************************/
+static void sim_telemetry_report(void)
+{
+    const telemetry_ring_t *ring = &diag_i2c_map.telemetry;
+    const telemetry_record_t *record = &ring->record[ring->head % TELEMETRY_RECORDS];
+
+    if (0u == ring->records)
+    {
+        printf("telemetry: disabled\n");
+        return;
+    }
+    printf("telemetry: head=%lu record_size=%u newest %s touch=0x%lx raw0=%u diff0=%u\n",
+           (unsigned long)ring->head, (unsigned)ring->record_size,
+           ((0u != record->seq) && (record->seq == record->seq_end)) ? "complete" : "TORN",
+           (unsigned long)record->touch, (unsigned)record->raw[0], (unsigned)record->diff[0]);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_mem_report
+********************************************************************************
+* Summary:
+*  Prints the RAM budget and the stack high-water marks.
+*
+*******************************************************************************/
+static void sim_mem_report(void)
+{
+    static const char *const names[MEM_TASK_COUNT] = { "capsense", "led", "idle", "timer", "tuner" };
+    const mem_report_t *report = &diag_i2c_map.mem;
+
+    mem_report_update();
+    printf("mem: static=%lu bytes budget=%lu bytes heap_allocations=%lu\n",
+           (unsigned long)report->static_bytes, (unsigned long)report->budget_bytes,
+           (unsigned long)report->heap_allocations);
+    for (uint32_t task = 0u; task < MEM_TASK_COUNT; task++)
+    {
+        printf("  %-9s stack=%7lu free_min=%7lu\n", names[task],
+               (unsigned long)report->task[task].stack_bytes,
+               (unsigned long)report->task[task].stack_free_min_bytes);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_runtime_report
+********************************************************************************
+* Summary:
+*  Prints the CPU load of the last window next to the stack headroom of
+*  each task.
+*
+*******************************************************************************/
+static void sim_runtime_report(void)
+{
+#if APP_RUNTIME_STATS
+    static const char *const names[MEM_TASK_COUNT] = { "capsense", "led", "idle", "timer", "tuner" };
+    const runtime_stats_t *stats = &diag_i2c_map.runtime;
+
+    printf("cpu: windows=%lu window=%lu ms isr=%lu/window isr_max=%lu us\n",
+           (unsigned long)stats->windows, (unsigned long)stats->window_ms,
+           (unsigned long)stats->isr_count, (unsigned long)stats->isr_max_us);
+    for (uint32_t task = 0u; task < MEM_TASK_COUNT; task++)
+    {
+        printf("  %-9s load=%5.1f%% max=%5.1f%% stack_free_min=%lu\n", names[task],
+               (double)stats->task[task].cpu_permille / 10.0,
+               (double)stats->task[task].cpu_max_permille / 10.0,
+               (unsigned long)diag_i2c_map.mem.task[task].stack_free_min_bytes);
+    }
+    printf("  %-9s load=%5.1f%% max=%5.1f%%\n", "other",
+           (double)stats->other.cpu_permille / 10.0, (double)stats->other.cpu_max_permille / 10.0);
+    printf("  %-9s load=%5.1f%% max=%5.1f%%\n", "isr",
+           (double)stats->isr.cpu_permille / 10.0, (double)stats->isr.cpu_max_permille / 10.0);
+#else
+    printf("cpu: disabled\n");
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_isr_report
+********************************************************************************
+* Summary:
+*  Prints the interrupt profile.
+*
+*******************************************************************************/
+static void sim_isr_report(void)
+{
+#if APP_ISR_PROFILE
+    const isr_profile_t *profile = &diag_i2c_map.isr_profile;
+
+    printf("isr: profiled=%lu depth_max=%lu i2c_poll=%lu bytes/tick\n",
+           (unsigned long)profile->irqs, (unsigned long)profile->depth_max,
+           (unsigned long)sim_ezi2c_poll_bytes);
+    for (uint32_t slot = 0u; slot < profile->irqs; slot++)
+    {
+        const isr_profile_irq_t *irq = &profile->irq[slot];
+
+        printf("  irq%-3lu count=%lu cycles min/avg/max=%lu/%lu/%lu preemptions=%lu preempted=%lu "
+               "period=%.1f%% max=%.1f%%\n",
+               (unsigned long)irq->irqn, (unsigned long)irq->count,
+               (unsigned long)irq->cycles_min, (unsigned long)irq->cycles_avg,
+               (unsigned long)irq->cycles_max, (unsigned long)irq->preemptions,
+               (unsigned long)irq->preempted, (double)irq->period_permille / 10.0,
+               (double)irq->period_max_permille / 10.0);
+    }
+#else
+    printf("isr: disabled\n");
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_tuner_report
+********************************************************************************
+* Summary:
+*  Prints the Tuner synchronization counters.
+*
+*******************************************************************************/
+static void sim_tuner_report(void)
+{
+    const tuner_sync_stats_t *stats = &diag_i2c_map.tuner_sync;
+
+    printf("tuner: rate=%lu Hz syncs=%lu host_bytes=%lu late_syncs=%lu sync_max=%lu us\n",
+           (unsigned long)stats->rate_hz, (unsigned long)stats->syncs,
+           (unsigned long)stats->host_bytes, (unsigned long)stats->late_syncs,
+           (unsigned long)stats->sync_us_max);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ipc_report
+********************************************************************************
+* Summary:
+*  Prints the counters of the IPC ring to task_led.
+*
+*******************************************************************************/
+static void sim_ipc_report(void)
+{
+#if APP_IPC_TOUCH_RING
+    const ipc_ring_stats_t *stats = &diag_i2c_map.ipc_ring;
+
+    printf("ring ipc: pushed=%lu dropped=%lu high_water=%lu batches=%lu doorbells=%lu wakeups=%lu\n",
+           (unsigned long)stats->pushed, (unsigned long)stats->dropped,
+           (unsigned long)stats->high_water, (unsigned long)stats->batches,
+           (unsigned long)stats->doorbells, (unsigned long)stats->wakeups);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_pwm_duty
+********************************************************************************
+* Summary:
+*  Duty cycle of the LED PWM in percent, from its registers.
+*
+*******************************************************************************/
+static double sim_pwm_duty(void)
+{
+    const TCPWM_CNT_Type *cnt;
+
+    if (NULL == sim_pwm)
+    {
+        return 0.0;
+    }
+    cnt = &sim_pwm->base->CNT[sim_pwm->resource.channel_num];
+    return (100.0 * cnt->CC) / (cnt->PERIOD + 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_led_effect_report
+********************************************************************************
+* Summary:
+*  Prints the LED effect counters.
+*
+*******************************************************************************/
+static void sim_led_effect_report(void)
+{
+#if APP_LED_EFFECTS
+    const led_effect_stats_t *stats = &diag_i2c_map.led_effect;
+
+    printf("led: effect levels=%lu period=%lu level=%lu compare_writes=%lu fades=%lu cut=%lu fade_steps=%lu\n",
+           (unsigned long)stats->levels, (unsigned long)stats->period_counts,
+           (unsigned long)stats->level, (unsigned long)stats->compare_writes,
+           (unsigned long)stats->fades, (unsigned long)stats->fades_cut,
+           (unsigned long)stats->fade_steps);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_bus_report
+********************************************************************************
+* Summary:
+*  Prints the touch event bus and the counters of its subscribers.
+*
+*******************************************************************************/
+static void sim_bus_report(void)
+{
+#if APP_EVENT_BUS
+    const event_bus_ring_t *ring = &diag_i2c_map.touch_bus;
+
+    printf("bus: touch events=%lu subscribers=%lu\n",
+           (unsigned long)ring->head, (unsigned long)ring->subscribers);
+    for (uint32_t i = 0u; i < ring->subscribers; i++)
+    {
+        printf("bus: sub%lu read=%lu lag_max=%lu overruns=%lu\n", (unsigned long)i,
+               (unsigned long)ring->sub[i].read, (unsigned long)ring->sub[i].lag_max,
+               (unsigned long)ring->sub[i].overruns);
+    }
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_boot_report
+********************************************************************************
+* Summary:
+*  Prints the start-up timeline and where the baselines came from.
+*
+*******************************************************************************/
+static void sim_boot_report(void)
+{
+#if APP_BOOT_PROFILE
+    static const char *const phase_names[BOOT_PHASE_COUNT] =
+    {
+        "main", "bsp", "scheduler", "task", "tuner", "capsense_init",
+        "capsense_enable", "first_scan", "first_process"
+    };
+    const boot_profile_t *profile = &diag_i2c_map.boot;
+
+    printf("boot: fast_start=%lu", (unsigned long)profile->fast_start);
+    for (uint32_t phase = 1u; phase < BOOT_PHASE_COUNT; phase++)
+    {
+        if (0u != (profile->reached & (1u << phase)))
+        {
+            printf(" %s=%lu", phase_names[phase], (unsigned long)profile->us[phase]);
+        }
+    }
+    printf(" us\n");
+#endif
+#if APP_FAST_START
+    const baseline_store_stats_t *stats = &diag_i2c_map.baseline_store;
+
+    printf("boot: baseline source=%lu rejected=%lu retained_saves=%lu flash_writes=%lu flash_errors=%lu row_writes=%lu\n",
+           (unsigned long)stats->source, (unsigned long)stats->rejected,
+           (unsigned long)stats->retained_saves, (unsigned long)stats->flash_writes,
+           (unsigned long)stats->flash_errors, (unsigned long)sim_flash_row_writes);
+#endif
+}
+
+
+#if APP_FAST_START && APP_BASELINE_FLASH
+/*******************************************************************************
+* Function Name: sim_baseline_flash_check
+********************************************************************************
+* Summary:
+*  Checks that the baseline flash row is read back after it is written. Moves
+*  a baseline past BASELINE_STORE_FLASH_DELTA and saves until the flash copy
+*  is compared, which must write the row once. Then saves again as on the
+*  next boot, which must find the row current and leave it alone; a row read
+*  as its erased initializer would be written again. Runs after the report,
+*  so that it does not change the counts of the run.
+*
+*******************************************************************************/
+static void sim_baseline_flash_check(void)
+{
+    baseline_store_stats_t *stats = &diag_i2c_map.baseline_store;
+    uint16_t bsln = cy_capsense_tuner.sensorContext[0u].bsln;
+    uint32_t row_writes[2u];
+
+    cy_capsense_tuner.sensorContext[0u].bsln = (uint16_t)(bsln + (2u * BASELINE_STORE_FLASH_DELTA));
+    for (uint32_t boot = 0u; boot < 2u; boot++)
+    {
+        row_writes[boot] = sim_flash_row_writes;
+        stats->retained_saves = 0u;
+        for (uint32_t frame = 0u; frame < (BASELINE_STORE_INTERVAL * BASELINE_STORE_FLASH_SAVES); frame++)
+        {
+            baseline_store_frame(false);
+        }
+        row_writes[boot] = sim_flash_row_writes - row_writes[boot];
+    }
+    cy_capsense_tuner.sensorContext[0u].bsln = bsln;
+
+    if ((1u != row_writes[0u]) || (0u != row_writes[1u]) || (0u != stats->flash_errors))
+    {
+        printf("boot: flash check failed: row written %lu times, then %lu times, errors=%lu\n",
+               (unsigned long)row_writes[0u], (unsigned long)row_writes[1u],
+               (unsigned long)stats->flash_errors);
+        CY_ASSERT(0u);
+    }
+    printf("boot: flash check passed; written row read back\n");
+}
+#endif
+
+
+/*******************************************************************************
+* Function Name: sim_rtos_trace_report
+********************************************************************************
+* Summary:
+*  Writes the RTOS trace buffer to CAPSENSE_SIM_RTOS_TRACE (rtos_trace.bin by
+*  default) for sim/rtos_trace_json.py. Recording is stopped first, so that
+*  the end-of-run report does not push the run out of the buffer.
+*
+*******************************************************************************/
+static void sim_rtos_trace_report(void)
+{
+#if APP_RTOS_TRACE
+    const char *path = getenv("CAPSENSE_SIM_RTOS_TRACE");
+    FILE *file;
+    uint32_t kept;
+
+    RTOS_TRACE_STOP();
+    path = ((NULL != path) && ('\0' != path[0])) ? path : "rtos_trace.bin";
+    kept = (rtos_trace.head < RTOS_TRACE_RECORDS) ? rtos_trace.head : RTOS_TRACE_RECORDS;
+
+    file = fopen(path, "wb");
+    if ((NULL == file) || (1u != fwrite(&rtos_trace, sizeof(rtos_trace), 1u, file)))
+    {
+        printf("rtos_trace: cannot write %s\n", path);
+    }
+    else
+    {
+        printf("rtos_trace: recorded=%lu kept=%lu file=%s\n",
+               (unsigned long)rtos_trace.head, (unsigned long)kept, path);
+    }
+    if (NULL != file)
+    {
+        fclose(file);
+    }
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: sim_finish
+********************************************************************************
+* Summary:
+*  Prints the end-of-run report and terminates the simulation.
+*
+*******************************************************************************/
+void sim_finish(void)
+{
+    struct timespec now;
+    double elapsed_s;
+
+    sim_rtos_trace_report();
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed_s = (double)(now.tv_sec - sim_start_time.tv_sec) +
+                ((double)(now.tv_nsec - sim_start_time.tv_nsec) / 1e9);
+
+    printf("sim: elapsed=%.3f s ticks=%lu\n", elapsed_s,
+           (unsigned long)xTaskGetTickCount());
+    sim_boot_report();
+#if APP_FAST_START && APP_BASELINE_FLASH
+    sim_baseline_flash_check();
+#endif
+    sim_capsense_report();
+    sim_frame_report();
+    sim_scheduler_report();
+    sim_power_report();
+    sim_filter_report();
+    sim_telemetry_report();
+    sim_mem_report();
+    sim_runtime_report();
+    sim_isr_report();
+    sim_tuner_report();
+    printf("led: duty_updates=%lu starts=%lu stops=%lu compare_writes=%lu dma_writes=%lu last_duty=%.1f%%\n",
+           (unsigned long)sim_pwm_duty_updates, (unsigned long)sim_pwm_starts,
+           (unsigned long)sim_pwm_stops, (unsigned long)sim_pwm_compare_writes,
+           (unsigned long)sim_dma_writes, sim_pwm_duty());
+    sim_led_effect_report();
+    sim_ring_report("capsense", &diag_i2c_map.capsense_ring);
+    sim_ring_report("led", &diag_i2c_map.led_ring);
+    sim_ipc_report();
+    sim_bus_report();
+    printf("led: coalesced=%lu\n", (unsigned long)diag_i2c_map.led_coalesced);
+    sim_latency_report();
+    sim_signal_report();
+
+    exit(EXIT_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Interrupt controller
+*******************************************************************************/
+void sim_irq_global_enable(bool enable)
+{
+    sim_irq_global = enable;
+}
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr)
+{
+    if ((NULL == config) || ((uint32_t)config->intrSrc >= SIM_IRQ_COUNT))
+    {
+        return CY_SYSINT_BAD_PARAM;
+    }
+    sim_vectors[config->intrSrc] = userIsr;
+    return CY_SYSINT_SUCCESS;
+}
+
+cy_israddress Cy_SysInt_GetVector(IRQn_Type IRQn)
+{
+    return sim_vectors[IRQn];
+}
+
+cy_israddress Cy_SysInt_SetVector(IRQn_Type IRQn, cy_israddress userIsr)
+{
+    cy_israddress prev = sim_vectors[IRQn];
+
+    sim_vectors[IRQn] = userIsr;
+    return prev;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    sim_irq_pending[IRQn] = false;
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    sim_irq_enabled[IRQn] = true;
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    sim_irq_enabled[IRQn] = false;
+}
+
+void sim_irq_raise(IRQn_Type IRQn)
+{
+    sim_irq_pending[IRQn] = true;
+}
+
+
+/*******************************************************************************
+* Function Name: vApplicationTickHook
+********************************************************************************
+* Summary:
+*  Runs from the tick interrupt of the POSIX port. Delivers pending
+*  interrupts, then the DMA transfers triggered by the PWM, then the LPTIMER
+*  compare match.
+*
+*******************************************************************************/
+void vApplicationTickHook(void)
+{
+    if (!sim_irq_global)
+    {
+        return;
+    }
+
+    for (uint32_t irq = 0u; irq < SIM_IRQ_COUNT; irq++)
+    {
+        if (sim_irq_pending[irq] && sim_irq_enabled[irq] && (NULL != sim_vectors[irq]))
+        {
+            sim_irq_pending[irq] = false;
+            sim_vectors[irq]();
+        }
+    }
+
+    /* A polling I2C host interrupts once per byte */
+    if ((NULL != sim_ezi2c) && (0u != sim_ezi2c_poll_bytes))
+    {
+        IRQn_Type irqn = (IRQn_Type)(scb_0_interrupt_IRQn + sim_ezi2c->resource.block_num);
+
+        for (uint32_t byte = 0u; byte < sim_ezi2c_poll_bytes; byte++)
+        {
+            sim_vectors[irqn]();
+        }
+    }
+
+    sim_dma_tick();
+
+    for (uint32_t i = 0u; i < sim_lptimer_count; i++)
+    {
+        cyhal_lptimer_t *lptimer = sim_lptimers[i];
+
+        if (lptimer->armed && lptimer->event_enabled &&
+            ((int32_t)(cyhal_lptimer_read(lptimer) - lptimer->match) >= 0))
+        {
+            lptimer->armed = false;
+            if (NULL != lptimer->callback)
+            {
+                lptimer->callback(lptimer->callback_arg, CYHAL_LPTIMER_COMPARE_MATCH);
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_SysPm_RegisterCallback
+*******************************************************************************/
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler)
+{
+    handler->prevItm = NULL;
+    handler->nextItm = sim_syspm_callbacks;
+    if (NULL != sim_syspm_callbacks)
+    {
+        sim_syspm_callbacks->prevItm = handler;
+    }
+    sim_syspm_callbacks = handler;
+    return true;
+}
+
+
+/*******************************************************************************
+* PWM
+*******************************************************************************/
+cy_rslt_t cyhal_pwm_init(cyhal_pwm_t *obj, cyhal_gpio_t pin, const cyhal_clock_t *clk)
+{
+    (void)clk;
+
+    obj->base = &sim_tcpwm;
+    obj->resource.type = 0u;
+    obj->resource.block_num = 0u;
+    obj->resource.channel_num = 0u;
+    obj->pin = pin;
+    obj->running = false;
+    obj->duty_cycle = 0.0f;
+    obj->frequency_hz = 0u;
+    sim_pwm = obj;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_pwm_set_duty_cycle(cyhal_pwm_t *obj, float duty_cycle, uint32_t frequencyhal_hz)
+{
+    TCPWM_CNT_Type *cnt = &obj->base->CNT[obj->resource.channel_num];
+    uint32_t period = SIM_PWM_CLOCK_HZ / frequencyhal_hz;
+
+    obj->duty_cycle = duty_cycle;
+    obj->frequency_hz = frequencyhal_hz;
+    cnt->PERIOD = period - 1u;
+    cnt->CC = (uint32_t)((duty_cycle * (float)period) / 100.0f);
+    sim_pwm_duty_updates++;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_pwm_start(cyhal_pwm_t *obj)
+{
+    obj->running = true;
+    sim_pwm_starts++;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_pwm_stop(cyhal_pwm_t *obj)
+{
+    obj->running = false;
+    sim_pwm_stops++;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_pwm_enable_output(cyhal_pwm_t *obj, cyhal_pwm_output_t signal,
+                                  cyhal_source_t *source)
+{
+    if (CYHAL_PWM_OUTPUT_OVERFLOW != signal)
+    {
+        return CY_RSLT_SIM_UNSUPPORTED;
+    }
+    *source = (cyhal_source_t)1u;
+    return CY_RSLT_SUCCESS;
+}
+
+uint32_t Cy_TCPWM_PWM_GetPeriod0(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].PERIOD;
+}
+
+uint32_t Cy_TCPWM_PWM_GetCompare0(TCPWM_Type const *base, uint32_t cntNum)
+{
+    return base->CNT[cntNum].CC;
+}
+
+void Cy_TCPWM_PWM_SetCompare0(TCPWM_Type *base, uint32_t cntNum, uint32_t compare0)
+{
+    base->CNT[cntNum].CC = compare0;
+    sim_pwm_compare_writes++;
+}
+
+void Cy_TCPWM_PWM_SetCompare1(TCPWM_Type *base, uint32_t cntNum, uint32_t compare1)
+{
+    base->CNT[cntNum].CC_BUFF = compare1;
+}
+
+void Cy_TCPWM_PWM_EnableCompareSwap(TCPWM_Type *base, uint32_t cntNum, bool enable)
+{
+    if (enable)
+    {
+        base->CNT[cntNum].CTRL |= SIM_TCPWM_CTRL_AUTO_RELOAD_CC;
+    }
+    else
+    {
+        base->CNT[cntNum].CTRL &= ~SIM_TCPWM_CTRL_AUTO_RELOAD_CC;
+    }
+}
+
+
+/*******************************************************************************
+* Flash. The row is a const array in a read-only page of the process, which
+* is made writable for the copy.
+*******************************************************************************/
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uintptr_t rowAddr, const uint32_t *data)
+{
+    uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = rowAddr & ~(page_size - 1u);
+    size_t length = (size_t)((rowAddr + CY_FLASH_SIZEOF_ROW) - first);
+
+    if ((0u != (rowAddr % CY_FLASH_SIZEOF_ROW)) ||
+        (0 != mprotect((void *)first, length, PROT_READ | PROT_WRITE)))
+    {
+        return CY_FLASH_DRV_INVALID_INPUT_PARAMETERS;
+    }
+    memcpy((void *)rowAddr, data, CY_FLASH_SIZEOF_ROW);
+    (void)mprotect((void *)first, length, PROT_READ);
+    sim_flash_row_writes++;
+    return CY_FLASH_DRV_SUCCESS;
+}
+
+
+/*******************************************************************************
+* DMA
+*******************************************************************************/
+cy_rslt_t cyhal_dma_init(cyhal_dma_t *obj, uint8_t priority, cyhal_dma_direction_t direction)
+{
+    (void)priority;
+    (void)direction;
+
+    memset(obj, 0, sizeof(*obj));
+    sim_dma = obj;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_dma_configure(cyhal_dma_t *obj, const cyhal_dma_cfg_t *cfg)
+{
+    if ((32u != cfg->transfer_width) || (1u != cfg->burst_size))
+    {
+        return CY_RSLT_SIM_UNSUPPORTED;
+    }
+    obj->cfg = *cfg;
+    obj->done = 0u;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_dma_connect_digital(cyhal_dma_t *obj, cyhal_source_t source, cyhal_dma_input_t input)
+{
+    if ((1u != source) || (CYHAL_DMA_INPUT_TRIGGER_SINGLE_ELEMENT != input))
+    {
+        return CY_RSLT_SIM_UNSUPPORTED;
+    }
+    obj->trigger = sim_pwm;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_dma_enable(cyhal_dma_t *obj)
+{
+    obj->enabled = true;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_dma_disable(cyhal_dma_t *obj)
+{
+    obj->enabled = false;
+    return CY_RSLT_SUCCESS;
+}
+
+bool cyhal_dma_is_busy(cyhal_dma_t *obj)
+{
+    return obj->enabled && (obj->done < obj->cfg.length);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_dma_tick
+********************************************************************************
+* Summary:
+*  Runs the PWM overflows of one tick. Each terminal count swaps the compare
+*  registers if compare swap is enabled, then the overflow triggers the next
+*  DMA element, which therefore takes effect one period later.
+*
+*******************************************************************************/
+static void sim_dma_tick(void)
+{
+    cyhal_dma_t *dma = sim_dma;
+    cyhal_pwm_t *pwm = sim_pwm;
+    TCPWM_CNT_Type *cnt;
+    uint32_t overflows;
+    uint32_t compare;
+
+    if ((NULL == pwm) || !pwm->running)
+    {
+        return;
+    }
+    cnt = &pwm->base->CNT[pwm->resource.channel_num];
+
+    overflows = (pwm->frequency_hz * portTICK_PERIOD_MS) / 1000u;
+    while (0u != overflows--)
+    {
+        if (0u != (cnt->CTRL & SIM_TCPWM_CTRL_AUTO_RELOAD_CC))
+        {
+            compare = cnt->CC;
+            cnt->CC = cnt->CC_BUFF;
+            cnt->CC_BUFF = compare;
+        }
+
+        if ((NULL != dma) && cyhal_dma_is_busy(dma) && (pwm == dma->trigger))
+        {
+            const volatile uint32_t *src = (const volatile uint32_t *)dma->cfg.src_addr;
+            volatile uint32_t *dst = (volatile uint32_t *)dma->cfg.dst_addr;
+
+            dst[dma->done * dma->cfg.dst_increment] = src[dma->done * dma->cfg.src_increment];
+            dma->done++;
+            sim_dma_writes++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* EzI2C
+*******************************************************************************/
+static void sim_ezi2c_isr(void)
+{
+    const cyhal_ezi2c_slave_cfg_t *slave = sim_ezi2c->cfg.two_addresses ?
+                                           &sim_ezi2c->cfg.slave2_cfg : &sim_ezi2c->cfg.slave1_cfg;
+
+    /* One byte of a sequential read of the slave buffer */
+    sim_ezi2c_last_byte = slave->buf[sim_ezi2c->read_offset];
+    sim_ezi2c->read_offset = (sim_ezi2c->read_offset + 1u) % slave->buf_size;
+}
+
+cy_rslt_t cyhal_ezi2c_init(cyhal_ezi2c_t *obj, cyhal_gpio_t sda, cyhal_gpio_t scl,
+                           const cyhal_clock_t *clk, const cyhal_ezi2c_cfg_t *cfg)
+{
+    const char *poll = getenv("CAPSENSE_SIM_I2C_POLL_BYTES");
+    IRQn_Type irqn = (IRQn_Type)(scb_0_interrupt_IRQn + SIM_EZI2C_SCB);
+
+    (void)sda;
+    (void)scl;
+    (void)clk;
+
+    obj->cfg = *cfg;
+    obj->resource.block_num = SIM_EZI2C_SCB;
+    obj->read_offset = 0u;
+    obj->initialized = true;
+
+    sim_ezi2c = obj;
+    sim_ezi2c_poll_bytes = (NULL != poll) ? (uint32_t)strtoul(poll, NULL, 0) : 0u;
+    sim_vectors[irqn] = sim_ezi2c_isr;
+    sim_irq_enabled[irqn] = true;
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_ezi2c_free(cyhal_ezi2c_t *obj)
+{
+    obj->initialized = false;
+}
+
+uint32_t cyhal_ezi2c_get_activity_status(cyhal_ezi2c_t *obj)
+{
+    /* Bus activity is not modelled, the slave is always idle */
+    (void)obj;
+    return 0u;
+}
+
+
+/*******************************************************************************
+* LPTIMER
+*******************************************************************************/
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj)
+{
+    obj->match = 0u;
+    obj->armed = false;
+    obj->event_enabled = false;
+    obj->callback = NULL;
+    obj->callback_arg = NULL;
+    if (sim_lptimer_count >= SIM_LPTIMER_COUNT)
+    {
+        return (cy_rslt_t)1u;
+    }
+    sim_lptimers[sim_lptimer_count++] = obj;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_lptimer_set_match(cyhal_lptimer_t *obj, uint32_t value)
+{
+    obj->match = value;
+    obj->armed = true;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_lptimer_set_delay(cyhal_lptimer_t *obj, uint32_t delay)
+{
+    return cyhal_lptimer_set_match(obj, cyhal_lptimer_read(obj) + delay);
+}
+
+uint32_t cyhal_lptimer_read(const cyhal_lptimer_t *obj)
+{
+    (void)obj;
+    return (uint32_t)(((uint64_t)xTaskGetTickCountFromISR() * 32768u) / configTICK_RATE_HZ);
+}
+
+void cyhal_lptimer_register_callback(cyhal_lptimer_t *obj, cyhal_lptimer_event_callback_t callback,
+                                     void *callback_arg)
+{
+    obj->callback = callback;
+    obj->callback_arg = callback_arg;
+}
+
+void cyhal_lptimer_enable_event(cyhal_lptimer_t *obj, cyhal_lptimer_event_t event,
+                                uint8_t intr_priority, bool enable)
+{
+    (void)event;
+    (void)intr_priority;
+    obj->event_enabled = enable;
+}
+
+
+/*******************************************************************************
+* FreeRTOS static memory hooks (configSUPPORT_STATIC_ALLOCATION)
+*******************************************************************************/
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+    static StaticTask_t idle_tcb;
+    static StackType_t idle_stack[configMINIMAL_STACK_SIZE];
+
+    *ppxIdleTaskTCBBuffer = &idle_tcb;
+    *ppxIdleTaskStackBuffer = idle_stack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize)
+{
+    static StaticTask_t timer_tcb;
+    static StackType_t timer_stack[configTIMER_TASK_STACK_DEPTH];
+
+    *ppxTimerTaskTCBBuffer = &timer_tcb;
+    *ppxTimerTaskStackBuffer = timer_stack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+
+/* [] END OF FILE */
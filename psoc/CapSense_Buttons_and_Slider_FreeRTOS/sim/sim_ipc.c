@@ -0,0 +1,238 @@
+/******************************************************************************
+* File Name: sim_ipc.c
+*
+* Description: Host stand-in of the PDL IPC driver, and a check of
+*              the ipc_ring.c protocol with two threads standing in for the
+*              CM0+ and CM4 cores.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stdio.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "cybsp.h"
+#include "ipc_ring.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Events passed by the check */
+#define SIM_IPC_EVENTS              (200000u)
+
+/* Longest wait of the consumer for a doorbell before it reports a lost one */
+#define SIM_IPC_DOORBELL_TIMEOUT_S  (1)
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static IPC_STRUCT_Type sim_ipc_channels[SIM_IPC_CHANNELS];
+static IPC_INTR_STRUCT_Type sim_ipc_intrs[SIM_IPC_CHANNELS];
+static ipc_ring_t sim_ipc_ring;
+
+
+/*******************************************************************************
+* IPC driver. The lock is taken with an atomic exchange, like the read of the
+* ACQUIRE register, so both threads can use a channel at the same time.
+*******************************************************************************/
+IPC_STRUCT_Type *Cy_IPC_Drv_GetIpcBaseAddress(uint32_t ipcIndex)
+{
+    return &sim_ipc_channels[ipcIndex];
+}
+
+IPC_INTR_STRUCT_Type *Cy_IPC_Drv_GetIntrBaseAddr(uint32_t ipcIntrIndex)
+{
+    return &sim_ipc_intrs[ipcIntrIndex];
+}
+
+void Cy_IPC_Drv_WriteDataValue(IPC_STRUCT_Type *base, uintptr_t dataValue)
+{
+    base->data = dataValue;
+}
+
+uintptr_t Cy_IPC_Drv_ReadDataValue(IPC_STRUCT_Type const *base)
+{
+    return base->data;
+}
+
+cy_en_ipcdrv_status_t Cy_IPC_Drv_AcquireNotify(IPC_STRUCT_Type *base, uint32_t notifyEventIntr)
+{
+    uint32_t channel = (uint32_t)(base - sim_ipc_channels);
+
+    if (0u != __atomic_exchange_n(&base->locked, 1u, __ATOMIC_SEQ_CST))
+    {
+        return CY_IPC_DRV_ERROR;
+    }
+    for (uint32_t intr = 0u; intr < SIM_IPC_CHANNELS; intr++)
+    {
+        if (0u != (notifyEventIntr & (1u << intr)))
+        {
+            __atomic_or_fetch(&sim_ipc_intrs[intr].notify, 1u << channel, __ATOMIC_SEQ_CST);
+            if (0u != (sim_ipc_intrs[intr].notify_mask & (1u << channel)))
+            {
+                sim_irq_raise((IRQn_Type)(cpuss_interrupts_ipc_0_IRQn + (IRQn_Type)intr));
+            }
+        }
+    }
+    return CY_IPC_DRV_SUCCESS;
+}
+
+cy_en_ipcdrv_status_t Cy_IPC_Drv_LockRelease(IPC_STRUCT_Type *base, uint32_t releaseEventIntr)
+{
+    (void)releaseEventIntr;
+
+    if (0u == __atomic_exchange_n(&base->locked, 0u, __ATOMIC_SEQ_CST))
+    {
+        return CY_IPC_DRV_ERROR;
+    }
+    return CY_IPC_DRV_SUCCESS;
+}
+
+void Cy_IPC_Drv_SetInterruptMask(IPC_INTR_STRUCT_Type *base, uint32_t ipcReleaseMask,
+                                 uint32_t ipcNotifyMask)
+{
+    (void)ipcReleaseMask;
+    base->notify_mask = ipcNotifyMask;
+}
+
+void Cy_IPC_Drv_ClearInterrupt(IPC_INTR_STRUCT_Type *base, uint32_t ipcReleaseMask,
+                               uint32_t ipcNotifyMask)
+{
+    (void)ipcReleaseMask;
+    __atomic_and_fetch(&base->notify, ~ipcNotifyMask, __ATOMIC_SEQ_CST);
+}
+
+uint32_t Cy_IPC_Drv_GetInterruptStatusMasked(IPC_INTR_STRUCT_Type const *base)
+{
+    /* Notify events are in the upper half-word, as on the target */
+    return (base->notify & base->notify_mask) << 16u;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ipc_producer
+********************************************************************************
+* Summary:
+*  Producer core: pushes a numbered sequence of events, retrying while the
+*  ring is full.
+*
+*******************************************************************************/
+static void *sim_ipc_producer(void *arg)
+{
+    ipc_ring_t *ring = ipc_ring_attach();
+    uint32_t item[2];
+
+    (void)arg;
+    CY_ASSERT(NULL != ring);
+
+    for (uint32_t seq = 0u; seq < SIM_IPC_EVENTS; seq++)
+    {
+        item[0] = seq;
+        item[1] = ~seq;
+        while (!ipc_ring_push(ring, item))
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ipc_wait_doorbell
+********************************************************************************
+* Summary:
+*  Consumer core asleep: waits for the notify event as the interrupt would.
+*
+* Return:
+*  false if no doorbell arrived within SIM_IPC_DOORBELL_TIMEOUT_S
+*
+*******************************************************************************/
+static bool sim_ipc_wait_doorbell(void)
+{
+    IPC_INTR_STRUCT_Type *intr = Cy_IPC_Drv_GetIntrBaseAddr(IPC_RING_INTR);
+    time_t deadline = time(NULL) + SIM_IPC_DOORBELL_TIMEOUT_S + 1;
+
+    while (0u == Cy_IPC_Drv_GetInterruptStatusMasked(intr))
+    {
+        if (time(NULL) > deadline)
+        {
+            return false;
+        }
+        sched_yield();
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ipc_check
+********************************************************************************
+* Summary:
+*  Passes SIM_IPC_EVENTS events from a producer thread to this thread and
+*  halts the simulation if one is lost, duplicated, reordered or torn, or if
+*  the consumer sleeps through a doorbell. Leaves the IPC channel as found.
+*
+*******************************************************************************/
+void sim_ipc_check(void)
+{
+    IPC_INTR_STRUCT_Type *intr = Cy_IPC_Drv_GetIntrBaseAddr(IPC_RING_INTR);
+    uint32_t items[IPC_RING_SIZE][2];
+    uint32_t expected = 0u;
+    uint32_t count;
+    pthread_t producer;
+
+    ipc_ring_init(&sim_ipc_ring, sizeof(items[0]));
+    Cy_IPC_Drv_SetInterruptMask(intr, CY_IPC_NO_NOTIFICATION, 1u << IPC_RING_CHANNEL);
+    pthread_create(&producer, NULL, sim_ipc_producer, NULL);
+
+    while (expected < SIM_IPC_EVENTS)
+    {
+        count = ipc_ring_pop_batch(&sim_ipc_ring, items, IPC_RING_SIZE);
+        for (uint32_t i = 0u; i < count; i++, expected++)
+        {
+            if ((items[i][0] != expected) || (items[i][1] != ~expected))
+            {
+                printf("ipc: check failed: event %lu read as %lu/%08lx\n",
+                       (unsigned long)expected, (unsigned long)items[i][0],
+                       (unsigned long)items[i][1]);
+                CY_ASSERT(0u);
+            }
+        }
+        if ((0u == count) && ipc_ring_arm(&sim_ipc_ring))
+        {
+            if (!sim_ipc_wait_doorbell())
+            {
+                printf("ipc: check failed: lost doorbell at event %lu\n",
+                       (unsigned long)expected);
+                CY_ASSERT(0u);
+            }
+            ipc_ring_doorbell_ack(&sim_ipc_ring);
+        }
+    }
+    pthread_join(producer, NULL);
+
+    printf("ipc: two-thread check passed (%lu events, %lu doorbells, %lu full)\n",
+           (unsigned long)sim_ipc_ring.stats.pushed,
+           (unsigned long)sim_ipc_ring.stats.doorbells,
+           (unsigned long)sim_ipc_ring.stats.dropped);
+
+    /* A doorbell raised after the last event may still be pending */
+    Cy_IPC_Drv_ClearInterrupt(intr, CY_IPC_NO_NOTIFICATION, 1u << IPC_RING_CHANNEL);
+    (void)Cy_IPC_Drv_LockRelease(Cy_IPC_Drv_GetIpcBaseAddress(IPC_RING_CHANNEL),
+                                 CY_IPC_NO_NOTIFICATION);
+    Cy_IPC_Drv_SetInterruptMask(intr, CY_IPC_NO_NOTIFICATION, 0u);
+    Cy_IPC_Drv_WriteDataValue(Cy_IPC_Drv_GetIpcBaseAddress(IPC_RING_CHANNEL), 0u);
+    NVIC_ClearPendingIRQ(IPC_RING_IRQN);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,148 @@
+/******************************************************************************
+* File Name: sim_planner.c
+*
+* Description: Check of the scan planner. Replays scripted touch
+*              sequences through scan_planner.c and verifies its guarantees:
+*
+*              - every widget is scanned in every frame while none is hot,
+*              - a hot widget is scanned in every frame,
+*              - each cold widget is scanned at least once every
+*                ceil(cold widgets / SCAN_PLANNER_COLD_PER_FRAME) frames,
+*              - a touch on a cold widget makes it hot by the frame after
+*                its next scan,
+*              - all widgets are scanned again SCAN_PLANNER_HOLD_FRAMES
+*                frames after the last touch.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stdio.h>
+#include "cybsp.h"
+#include "scan_planner.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define SIM_PLANNER_ALL             ((uint32_t)((1uLL << CY_CAPSENSE_WIDGET_COUNT) - 1u))
+#define SIM_PLANNER_SLIDER          (1uL << CY_CAPSENSE_LINEARSLIDER0_WDGT_ID)
+#define SIM_PLANNER_BUTTON0         (1uL << CY_CAPSENSE_BUTTON0_WDGT_ID)
+#define SIM_PLANNER_COLD_PERIOD     (((CY_CAPSENSE_WIDGET_COUNT - 1u) + SCAN_PLANNER_COLD_PER_FRAME - 1u) / \
+                                     SCAN_PLANNER_COLD_PER_FRAME)
+
+#define SIM_PLANNER_EXPECT(cond, ...) \
+    do { if (!(cond)) { printf("planner: check failed: " __VA_ARGS__); printf("\n"); CY_ASSERT(0u); } } while(0)
+
+
+/*******************************************************************************
+* Function Name: sim_planner_frame
+********************************************************************************
+* Summary:
+*  Runs one frame through the planner.
+*
+* Parameters:
+*  uint32_t touched : Widgets that report a touch when scanned
+*
+* Return:
+*  Widgets scanned in the frame
+*
+*******************************************************************************/
+static uint32_t sim_planner_frame(uint32_t touched)
+{
+    uint32_t scanned = 0u;
+    uint32_t widget;
+
+    scan_planner_begin_frame();
+    while (SCAN_PLANNER_DONE != (widget = scan_planner_next()))
+    {
+        SIM_PLANNER_EXPECT(0u == (scanned & (1uL << widget)), "widget %lu planned twice",
+                           (unsigned long)widget);
+        scanned |= 1uL << widget;
+        scan_planner_widget_done(widget, 0u != (touched & (1uL << widget)));
+    }
+    scan_planner_end_frame();
+    return scanned;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_planner_check
+********************************************************************************
+* Summary:
+*  Runs the scripted sequences and halts the simulation on the first broken
+*  guarantee. Leaves the planner reset.
+*
+*******************************************************************************/
+void sim_planner_check(void)
+{
+    uint32_t gap[CY_CAPSENSE_WIDGET_COUNT] = {0u};
+    uint32_t scanned;
+    uint32_t frame;
+
+    scan_planner_init();
+
+    /* Idle: full frames */
+    for (frame = 0u; frame < 4u; frame++)
+    {
+        scanned = sim_planner_frame(0u);
+        SIM_PLANNER_EXPECT(SIM_PLANNER_ALL == scanned, "idle frame scanned 0x%lx",
+                           (unsigned long)scanned);
+    }
+
+    /* Slider dragged: slider every frame, cold widgets round-robin */
+    (void)sim_planner_frame(SIM_PLANNER_SLIDER);
+    for (frame = 0u; frame < (8u * SIM_PLANNER_COLD_PERIOD); frame++)
+    {
+        scanned = sim_planner_frame(SIM_PLANNER_SLIDER);
+        SIM_PLANNER_EXPECT(0u != (scanned & SIM_PLANNER_SLIDER), "hot slider skipped");
+        SIM_PLANNER_EXPECT((0u == SCAN_PLANNER_COLD_PER_FRAME) || (SIM_PLANNER_SLIDER != scanned),
+                           "no cold widget scanned");
+        SIM_PLANNER_EXPECT((SCAN_PLANNER_COLD_PER_FRAME >= (CY_CAPSENSE_WIDGET_COUNT - 1u)) ||
+                           (SIM_PLANNER_ALL != scanned), "cold widgets scanned every frame");
+
+        for (uint32_t widget = 0u; widget < CY_CAPSENSE_WIDGET_COUNT; widget++)
+        {
+            gap[widget] = (0u != (scanned & (1uL << widget))) ? 0u : (gap[widget] + 1u);
+            SIM_PLANNER_EXPECT(gap[widget] < SIM_PLANNER_COLD_PERIOD,
+                               "widget %lu not scanned for %lu frames", (unsigned long)widget,
+                               (unsigned long)gap[widget]);
+        }
+    }
+
+    /* Touch on a cold button: hot from the frame after its next scan */
+    for (frame = 0u; frame <= SIM_PLANNER_COLD_PERIOD; frame++)
+    {
+        scanned = sim_planner_frame(SIM_PLANNER_SLIDER | SIM_PLANNER_BUTTON0);
+        if (0u != (scanned & SIM_PLANNER_BUTTON0))
+        {
+            break;
+        }
+    }
+    SIM_PLANNER_EXPECT(frame < SIM_PLANNER_COLD_PERIOD, "touched button seen after %lu frames",
+                       (unsigned long)frame);
+    for (frame = 0u; frame < 4u; frame++)
+    {
+        scanned = sim_planner_frame(SIM_PLANNER_SLIDER | SIM_PLANNER_BUTTON0);
+        SIM_PLANNER_EXPECT(0u != (scanned & SIM_PLANNER_BUTTON0), "touched button not promoted");
+    }
+
+    /* Release: full frames once the hold time has passed */
+    for (frame = 0u; frame <= SCAN_PLANNER_HOLD_FRAMES; frame++)
+    {
+        (void)sim_planner_frame(0u);
+    }
+    scanned = sim_planner_frame(0u);
+    SIM_PLANNER_EXPECT(SIM_PLANNER_ALL == scanned, "no full frame after release, scanned 0x%lx",
+                       (unsigned long)scanned);
+
+    scan_planner_init();
+    printf("planner: check passed (cold period %lu frames)\n", (unsigned long)SIM_PLANNER_COLD_PERIOD);
+}
+
+
+/* [] END OF FILE */
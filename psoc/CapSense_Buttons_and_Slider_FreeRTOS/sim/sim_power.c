@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: sim_power.c
+*
+* Description: Host simulation of the low-power idle. The POSIX port has no
+*              tickless idle, so the idle hook runs the decision of
+*              power_mgr.c as a dry run once per idle window, and the
+*              decision rules are checked against a table by make check.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stdio.h>
+#include "cybsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "power_mgr.h"
+#include "scan_scheduler.h"
+
+
+/*******************************************************************************
+* Data structure
+*******************************************************************************/
+typedef struct
+{
+    uint32_t idle_us;
+    bool busy;
+    power_mode_t expected;
+} sim_power_case_t;
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+static const sim_power_case_t sim_power_cases[] =
+{
+    { 0u,                                   false,  POWER_MODE_ACTIVE },
+    { POWER_SLEEP_MIN_US - 1u,              false,  POWER_MODE_ACTIVE },
+    { POWER_SLEEP_MIN_US,                   false,  POWER_MODE_SLEEP },
+    { POWER_DEEPSLEEP_MIN_US - 1u,          false,  POWER_MODE_SLEEP },
+    { POWER_DEEPSLEEP_MIN_US,               false,  POWER_MODE_DEEPSLEEP },
+    { POWER_SLEEP_MIN_US - 1u,              true,   POWER_MODE_ACTIVE },
+    { POWER_DEEPSLEEP_MIN_US,               true,   POWER_MODE_SLEEP },
+    /* Idle scanning must always reach Deep Sleep between scans */
+    { SCAN_IDLE_INTERVAL_MS * 1000u,        false,  POWER_MODE_DEEPSLEEP },
+    /* A scan or I2C transaction in progress must never be cut by Deep Sleep */
+    { SCAN_IDLE_INTERVAL_MS * 1000u,        true,   POWER_MODE_SLEEP },
+};
+
+
+/*******************************************************************************
+* Function Name: sim_power_check
+********************************************************************************
+* Summary:
+*  Runs the decision table through power_mgr_decide() and halts the
+*  simulation on the first mismatch.
+*
+*******************************************************************************/
+void sim_power_check(void)
+{
+    static const char *const mode_names[] = { "active", "sleep", "deep_sleep" };
+    uint32_t count = sizeof(sim_power_cases) / sizeof(sim_power_cases[0]);
+
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        const sim_power_case_t *test = &sim_power_cases[i];
+        power_mode_t mode = power_mgr_decide(test->idle_us, test->busy);
+
+        if (mode != test->expected)
+        {
+            printf("power: decision check failed: idle=%lu us busy=%d -> %s, expected %s\n",
+                   (unsigned long)test->idle_us, (int)test->busy,
+                   mode_names[mode], mode_names[test->expected]);
+            CY_ASSERT(0u);
+        }
+    }
+    printf("power: decision check passed (%lu cases)\n", (unsigned long)count);
+}
+
+
+/*******************************************************************************
+* Function Name: vApplicationIdleHook
+*******************************************************************************/
+void vApplicationIdleHook(void)
+{
+#if APP_LOW_POWER
+    power_mgr_dry_run();
+#endif
+}
+
+
+/* [] END OF FILE */
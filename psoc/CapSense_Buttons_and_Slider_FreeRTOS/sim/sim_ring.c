@@ -0,0 +1,345 @@
+/******************************************************************************
+* File Name: sim_ring.c
+*
+* Description: Check of the event_ring.c protocol. A producer thread pushes
+*              millions of events in task context into a small ring that a
+*              consumer thread drains in batches, while a signal standing in
+*              for an interrupt preempts the producer and pushes from
+*              interrupt context. The critical sections of the SIM_CHECK
+*              build mask that signal, as taskENTER_CRITICAL() masks
+*              interrupts on the target, so an interrupt raised during a
+*              task-context push is taken when the push leaves its critical
+*              section.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <stdio.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include "cybsp.h"
+#include "event_ring.h"
+
+#if SIM_CHECK
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Events pushed in task context by the check */
+#define SIM_RING_EVENTS             (2000000u)
+
+/* Ring size, small so that the producer regularly finds it full */
+#define SIM_RING_SIZE               (64u)
+
+/* Largest batch drained by the consumer */
+#define SIM_RING_BATCH              (16u)
+
+/* Signal delivered to the producer thread as its interrupt */
+#define SIM_RING_IRQ_SIGNAL         (SIGUSR1)
+
+/* Interval of the interrupt, in ns */
+#define SIM_RING_IRQ_PERIOD_NS      (2000L)
+
+/* Payload derived from the source and sequence number, to detect torn events */
+#define SIM_RING_PAYLOAD(isr, seq)  (((uint32_t)(seq) * 2654435761u) ^ ((isr) ? 0xA5A5A5A5u : 0u))
+
+
+/*******************************************************************************
+* Data structure
+*******************************************************************************/
+typedef struct
+{
+    uint32_t seq;               /* Per source, from 1 */
+    uint32_t payload;
+    uint32_t from_isr;
+} sim_ring_event_t;
+
+/* Counts per source: [0] task context, [1] interrupt context */
+typedef struct
+{
+    uint32_t stored[2];
+    uint32_t dropped[2];
+} sim_ring_count_t;
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+static event_ring_t sim_ring;
+static event_ring_stats_t sim_ring_stats;
+static sim_ring_event_t sim_ring_storage[SIM_RING_SIZE];
+static sim_ring_count_t sim_ring_produced;
+static pthread_t sim_ring_producer_thread;
+static volatile bool sim_ring_task_done;
+static volatile bool sim_ring_irq_done;
+
+/* Written by the interrupt handler only, on the producer thread */
+static volatile uint32_t sim_ring_isr_seq;
+
+/* Critical sections of the producer, and interrupts they held off */
+static __thread uint32_t sim_ring_critical_nesting;
+static volatile uint32_t sim_ring_critical_calls;
+static volatile uint32_t sim_ring_deferred;
+
+
+/*******************************************************************************
+* Function Name: __wrap_vPortEnterCritical, __wrap_vPortExitCritical
+********************************************************************************
+* Summary:
+*  Critical sections of the SIM_CHECK build, linked in with --wrap: they mask
+*  the interrupt signal of the calling thread around the critical section of
+*  the port. On exit, an interrupt raised during the critical section is
+*  taken as soon as the signal is unmasked, and counted as deferred.
+*
+*******************************************************************************/
+void __real_vPortEnterCritical(void);
+void __real_vPortExitCritical(void);
+
+void __wrap_vPortEnterCritical(void)
+{
+    sigset_t mask;
+
+    if (0u == sim_ring_critical_nesting++)
+    {
+        sigemptyset(&mask);
+        sigaddset(&mask, SIM_RING_IRQ_SIGNAL);
+        pthread_sigmask(SIG_BLOCK, &mask, NULL);
+    }
+    __real_vPortEnterCritical();
+}
+
+void __wrap_vPortExitCritical(void)
+{
+    sigset_t mask;
+    uint32_t isr_seq;
+
+    __real_vPortExitCritical();
+    if (0u == --sim_ring_critical_nesting)
+    {
+        if (pthread_equal(pthread_self(), sim_ring_producer_thread))
+        {
+            sim_ring_critical_calls++;
+        }
+        isr_seq = sim_ring_isr_seq;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIM_RING_IRQ_SIGNAL);
+        pthread_sigmask(SIG_UNBLOCK, &mask, NULL);
+        if (isr_seq != sim_ring_isr_seq)
+        {
+            sim_ring_deferred++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ring_isr
+********************************************************************************
+* Summary:
+*  Interrupt handler of the check: pushes the next interrupt-context event.
+*
+*******************************************************************************/
+static void sim_ring_isr(int signal)
+{
+    sim_ring_event_t event;
+    BaseType_t woken = pdFALSE;
+
+    (void)signal;
+
+    event.seq = ++sim_ring_isr_seq;
+    event.payload = SIM_RING_PAYLOAD(1u, event.seq);
+    event.from_isr = 1u;
+    if (event_ring_push_from_isr(&sim_ring, &event, &woken))
+    {
+        sim_ring_produced.stored[1]++;
+    }
+    else
+    {
+        sim_ring_produced.dropped[1]++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ring_irq
+********************************************************************************
+* Summary:
+*  Raises the interrupt of the producer thread every SIM_RING_IRQ_PERIOD_NS
+*  until the producer has pushed all its events.
+*
+*******************************************************************************/
+static void *sim_ring_irq(void *arg)
+{
+    const struct timespec period = { 0, SIM_RING_IRQ_PERIOD_NS };
+
+    (void)arg;
+
+    while (!sim_ring_task_done)
+    {
+        pthread_kill(sim_ring_producer_thread, SIM_RING_IRQ_SIGNAL);
+        nanosleep(&period, NULL);
+    }
+    sim_ring_irq_done = true;
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ring_producer
+********************************************************************************
+* Summary:
+*  Pushes a numbered sequence of events in task context without waiting for
+*  the consumer, while the interrupt preempts it at any point. Masks the
+*  interrupt for good once the interrupt thread has stopped.
+*
+*******************************************************************************/
+static void *sim_ring_producer(void *arg)
+{
+    sim_ring_event_t event;
+    sigset_t mask;
+    pthread_t irq;
+
+    (void)arg;
+
+    pthread_create(&irq, NULL, sim_ring_irq, NULL);
+    for (uint32_t seq = 1u; seq <= SIM_RING_EVENTS; seq++)
+    {
+        event.seq = seq;
+        event.payload = SIM_RING_PAYLOAD(0u, seq);
+        event.from_isr = 0u;
+
+        if (event_ring_push(&sim_ring, &event))
+        {
+            sim_ring_produced.stored[0]++;
+        }
+        else
+        {
+            sim_ring_produced.dropped[0]++;
+        }
+        if (0u == (seq & 0xFFu))
+        {
+            sched_yield();
+        }
+    }
+
+    sim_ring_task_done = true;
+    pthread_join(irq, NULL);
+    sigemptyset(&mask);
+    sigaddset(&mask, SIM_RING_IRQ_SIGNAL);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ring_drain
+********************************************************************************
+* Summary:
+*  Pops the pending events in batches and halts the simulation if an event is
+*  torn or out of order. Dropped events leave gaps in the sequence of their
+*  source, but the events that were stored must arrive in the order each
+*  source pushed them.
+*
+*******************************************************************************/
+static void sim_ring_drain(uint32_t last_seq[2], sim_ring_count_t *popped)
+{
+    sim_ring_event_t batch[SIM_RING_BATCH];
+    uint32_t count;
+
+    while (0u != (count = event_ring_pop_batch(&sim_ring, batch, SIM_RING_BATCH)))
+    {
+        for (uint32_t i = 0u; i < count; i++)
+        {
+            const sim_ring_event_t *event = &batch[i];
+            uint32_t source = (0u != event->from_isr) ? 1u : 0u;
+
+            if ((event->from_isr > 1u) || (event->seq <= last_seq[source]) ||
+                (event->payload != SIM_RING_PAYLOAD(source, event->seq)))
+            {
+                printf("ring: check failed: event %lu after %lu read as %08lx/%lu\n",
+                       (unsigned long)event->seq, (unsigned long)last_seq[source],
+                       (unsigned long)event->payload, (unsigned long)event->from_isr);
+                CY_ASSERT(0u);
+            }
+            last_seq[source] = event->seq;
+            popped->stored[source]++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ring_check
+********************************************************************************
+* Summary:
+*  Pushes SIM_RING_EVENTS task-context events and the interrupt-context
+*  events of the preempting signal, and drains them in this thread. Halts the
+*  simulation if an event is torn or reordered, if popped and dropped events
+*  do not add up to the events pushed, as counted both by the producers and
+*  by the ring, or if the critical sections of the push were not masked.
+*
+*******************************************************************************/
+void sim_ring_check(void)
+{
+    sim_ring_count_t popped = { 0u };
+    uint32_t last_seq[2] = { 0u, 0u };
+    struct sigaction action = { 0 };
+    uint32_t pushed;
+
+    event_ring_init(&sim_ring, sim_ring_storage, sizeof(sim_ring_event_t),
+                    SIM_RING_SIZE, &sim_ring_stats);
+    sim_ring_produced = (sim_ring_count_t){ 0u };
+    sim_ring_task_done = false;
+    sim_ring_irq_done = false;
+
+    action.sa_handler = sim_ring_isr;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIM_RING_IRQ_SIGNAL, &action, NULL);
+    pthread_create(&sim_ring_producer_thread, NULL, sim_ring_producer, NULL);
+
+    while (!sim_ring_irq_done)
+    {
+        sim_ring_drain(last_seq, &popped);
+        sched_yield();
+    }
+    pthread_join(sim_ring_producer_thread, NULL);
+    sim_ring_drain(last_seq, &popped);
+
+    pushed = SIM_RING_EVENTS + sim_ring_isr_seq;
+    if ((popped.stored[0] != sim_ring_produced.stored[0]) ||
+        (popped.stored[1] != sim_ring_produced.stored[1]) ||
+        (sim_ring_stats.pushed != (popped.stored[0] + popped.stored[1])) ||
+        (sim_ring_stats.dropped != (sim_ring_produced.dropped[0] + sim_ring_produced.dropped[1])) ||
+        ((sim_ring_stats.pushed + sim_ring_stats.dropped) != pushed) ||
+        (sim_ring_stats.high_water > SIM_RING_SIZE) ||
+        (0u == sim_ring_isr_seq) || (sim_ring_critical_calls < SIM_RING_EVENTS))
+    {
+        printf("ring: check failed: pushed=%lu popped=%lu+%lu (of %lu+%lu) dropped=%lu of %lu events, "
+               "critical sections=%lu\n",
+               (unsigned long)sim_ring_stats.pushed, (unsigned long)popped.stored[0],
+               (unsigned long)popped.stored[1], (unsigned long)sim_ring_produced.stored[0],
+               (unsigned long)sim_ring_produced.stored[1], (unsigned long)sim_ring_stats.dropped,
+               (unsigned long)pushed, (unsigned long)sim_ring_critical_calls);
+        CY_ASSERT(0u);
+    }
+
+    printf("ring: preemption check passed (%lu task + %lu interrupt events; popped=%lu+%lu "
+           "dropped=%lu deferred interrupts=%lu batches=%lu high_water=%lu)\n",
+           (unsigned long)SIM_RING_EVENTS, (unsigned long)sim_ring_isr_seq,
+           (unsigned long)popped.stored[0], (unsigned long)popped.stored[1],
+           (unsigned long)sim_ring_stats.dropped, (unsigned long)sim_ring_deferred,
+           (unsigned long)sim_ring_stats.batches, (unsigned long)sim_ring_stats.high_water);
+}
+
+#endif /* SIM_CHECK */
+
+
+/* [] END OF FILE */
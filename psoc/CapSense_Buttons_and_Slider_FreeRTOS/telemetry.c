@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name: telemetry.c
+*
+* Description: Per-scan sensor telemetry for field diagnostics. After each
+*              processed scan the raw counts, baselines, diff counts and the
+*              widget touch state are written straight into the next slot of
+*              a record ring inside the diagnostics map, so the EzI2C slave
+*              serves them to the host without any staging copy. While the
+*              firmware fills one slot, the host reads the completed ones.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "telemetry.h"
+
+#if APP_TELEMETRY
+
+#include "cybsp.h"
+#include "cycle_counter.h"
+#include "diag_i2c.h"
+
+
+/*******************************************************************************
+* Function Name: telemetry_init
+********************************************************************************
+* Summary:
+*  Publishes the layout of the ring. All records start out incomplete.
+*
+*******************************************************************************/
+void telemetry_init(void)
+{
+    telemetry_ring_t *ring = &diag_i2c_map.telemetry;
+
+    cycle_counter_init();
+    ring->records = TELEMETRY_RECORDS;
+    ring->record_size = sizeof(telemetry_record_t);
+    ring->timestamp_hz = CYCLE_COUNTER_HZ;
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_capture
+********************************************************************************
+* Summary:
+*  Writes the result of the latest scan into the next record. Called by
+*  task_capsense after the widgets are processed.
+*
+* Parameters:
+*  const cy_stc_capsense_context_t *context : CapSense context
+*
+*******************************************************************************/
+void telemetry_capture(const cy_stc_capsense_context_t *context)
+{
+    telemetry_ring_t *ring = &diag_i2c_map.telemetry;
+    uint32_t seq = ring->head + 1u;
+    volatile telemetry_record_t *record;
+    uint32_t touch = 0u;
+
+    /* 0 marks an incomplete record */
+    if (0u == seq)
+    {
+        seq = 1u;
+    }
+    record = &ring->record[seq % TELEMETRY_RECORDS];
+
+    record->seq_end = 0u;
+    __DMB();
+
+    for (uint32_t sns = 0u; sns < CY_CAPSENSE_SENSOR_COUNT; sns++)
+    {
+        const cy_stc_capsense_sensor_context_t *sns_context = &cy_capsense_tuner.sensorContext[sns];
+
+        record->raw[sns] = sns_context->raw;
+        record->baseline[sns] = sns_context->bsln;
+        record->diff[sns] = sns_context->diff;
+    }
+
+    for (uint32_t widget = 0u; (widget < CY_CAPSENSE_WIDGET_COUNT) && (widget < 32u); widget++)
+    {
+        if (0u != (context->ptrWdConfig[widget].ptrWdContext->status & CY_CAPSENSE_WD_ACTIVE_MASK))
+        {
+            touch |= 1uL << widget;
+        }
+    }
+    record->touch = touch;
+    record->timestamp = cycle_counter_get();
+
+    __DMB();
+    record->seq = seq;
+    record->seq_end = seq;
+    __DMB();
+    ring->head = seq;
+}
+
+#endif /* APP_TELEMETRY */
+
+
+/* [] END OF FILE */
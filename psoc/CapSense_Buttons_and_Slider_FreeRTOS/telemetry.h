@@ -0,0 +1,89 @@
+/******************************************************************************
+* File Name: telemetry.h
+*
+* Description: This file is the public interface of telemetry.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_TELEMETRY_H_
+#define SOURCE_TELEMETRY_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "app_config.h"
+#include "cycfg_capsense.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Records kept in the ring; the host has TELEMETRY_RECORDS - 1 scan periods
+ * to read the newest record before it is overwritten.
+ */
+#ifndef TELEMETRY_RECORDS
+#define TELEMETRY_RECORDS           (8u)
+#endif
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Sensor data of one scan. seq and seq_end hold the same non-zero sequence
+ * number when the record is complete. The firmware clears seq_end before it
+ * rewrites a record and sets seq before seq_end when done, so a host that
+ * reads the record front to back in one transfer and finds seq == seq_end
+ * has read it without tearing.
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t timestamp;         /* Cycle counter at the end of processing */
+    uint32_t touch;             /* Active widgets, bit n is widget ID n */
+    uint16_t raw[CY_CAPSENSE_SENSOR_COUNT];
+    uint16_t baseline[CY_CAPSENSE_SENSOR_COUNT];
+    uint16_t diff[CY_CAPSENSE_SENSOR_COUNT];
+    uint32_t seq_end;
+} telemetry_record_t;
+
+/* Ring published over EzI2C. head is the sequence number of the newest
+ * complete record, which is stored in record[head % TELEMETRY_RECORDS].
+ */
+typedef struct
+{
+    uint32_t head;
+    uint16_t records;           /* TELEMETRY_RECORDS */
+    uint16_t record_size;       /* sizeof(telemetry_record_t) */
+    uint32_t timestamp_hz;      /* Rate of the timestamp counter */
+    telemetry_record_t record[TELEMETRY_RECORDS];
+} telemetry_ring_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_TELEMETRY
+void telemetry_init(void);
+void telemetry_capture(const cy_stc_capsense_context_t *context);
+
+#define TELEMETRY_INIT()                telemetry_init()
+#define TELEMETRY_CAPTURE(context)      telemetry_capture(context)
+#else
+#define TELEMETRY_INIT()
+#define TELEMETRY_CAPTURE(context)
+#endif
+
+
+#endif /* SOURCE_TELEMETRY_H_ */
+
+
+/* [] END OF FILE */
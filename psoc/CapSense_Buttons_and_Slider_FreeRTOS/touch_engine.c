@@ -0,0 +1,137 @@
+/******************************************************************************
+* File Name: touch_engine.c
+*
+* Description: Table-driven touch processing for any number of widgets.
+*
+*              After each scan the active state of every widget is packed one
+*              bit per widget. XOR with the state of the previous scan gives
+*              the widgets that were pressed or released; only those, plus
+*              the active widgets that ask for continuous updates (sliders),
+*              are dispatched to the handler of their entry in a const action
+*              table. Set bits are visited lowest first with count-trailing-
+*              zeros, so the dispatch cost follows the number of changed
+*              widgets, not the size of the table.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <string.h>
+#include "touch_engine.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#if defined(__GNUC__) || defined(__clang__)
+#define TOUCH_ENGINE_CTZ(word)      ((uint32_t)__builtin_ctz(word))
+#else
+#define TOUCH_ENGINE_CTZ(word)      ((uint32_t)__CLZ(__RBIT(word)))
+#endif
+
+
+/*******************************************************************************
+* Function Name: touch_engine_init
+********************************************************************************
+* Summary:
+*  Builds the watched and continuous widget masks from the action table.
+*
+* Parameters:
+*  touch_engine_t *engine          : Engine to initialize
+*  const touch_action_t actions[]  : Action of each widget, by widget ID
+*
+*******************************************************************************/
+void touch_engine_init(touch_engine_t *engine,
+                       const touch_action_t actions[CY_CAPSENSE_WIDGET_COUNT])
+{
+    uint32_t widget;
+
+    memset(engine, 0, sizeof(*engine));
+    engine->actions = actions;
+
+    for (widget = 0u; widget < CY_CAPSENSE_WIDGET_COUNT; widget++)
+    {
+        uint32_t bit = 1uL << (widget & 31u);
+
+        if (NULL == actions[widget].handler)
+        {
+            continue;
+        }
+
+        engine->watched[widget >> 5u] |= bit;
+        if (0u != (actions[widget].flags & TOUCH_ACTION_CONTINUOUS))
+        {
+            engine->continuous[widget >> 5u] |= bit;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: touch_engine_process
+********************************************************************************
+* Summary:
+*  Dispatches the widget changes of the latest scan. Handlers are called in
+*  the order of their widget IDs.
+*
+* Parameters:
+*  touch_engine_t *engine                      : Engine
+*  const cy_stc_capsense_context_t *capsense_context : CapSense context
+*  void *context                               : Passed to the handlers
+*
+*******************************************************************************/
+void touch_engine_process(touch_engine_t *engine,
+                          const cy_stc_capsense_context_t *capsense_context,
+                          void *context)
+{
+    const cy_stc_capsense_widget_config_t *wd_config = capsense_context->ptrWdConfig;
+    uint32_t active[TOUCH_ENGINE_WORDS] = {0u};
+    uint32_t widget;
+    uint32_t word;
+
+    /* Pack the widget states */
+    for (widget = 0u; widget < CY_CAPSENSE_WIDGET_COUNT; widget++)
+    {
+        uint32_t is_active = (0u != (wd_config[widget].ptrWdContext->status &
+                                     CY_CAPSENSE_WD_ACTIVE_MASK)) ? 1u : 0u;
+
+        active[widget >> 5u] |= is_active << (widget & 31u);
+    }
+
+    for (word = 0u; word < TOUCH_ENGINE_WORDS; word++)
+    {
+        uint32_t changed = active[word] ^ engine->state[word];
+        uint32_t pending = (changed | (active[word] & engine->continuous[word])) &
+                           engine->watched[word];
+
+        engine->state[word] = active[word];
+
+        while (0u != pending)
+        {
+            uint32_t bit = TOUCH_ENGINE_CTZ(pending);
+            uint32_t mask = 1uL << bit;
+            touch_event_t event;
+
+            pending &= pending - 1u;
+            widget = (word << 5u) + bit;
+
+            if (0u == (changed & mask))
+            {
+                event = TOUCH_EVENT_MOVE;
+            }
+            else
+            {
+                event = (0u != (active[word] & mask)) ? TOUCH_EVENT_PRESS : TOUCH_EVENT_RELEASE;
+            }
+
+            engine->actions[widget].handler(widget, &engine->actions[widget], event, context);
+        }
+    }
+}
+
+
+/* [] END OF FILE */
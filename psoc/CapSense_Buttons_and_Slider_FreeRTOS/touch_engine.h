@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name: touch_engine.h
+*
+* Description: This file is the public interface of touch_engine.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_TOUCH_ENGINE_H_
+#define SOURCE_TOUCH_ENGINE_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "cycfg_capsense.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Widget states are packed one bit per widget */
+#define TOUCH_ENGINE_WORDS          ((CY_CAPSENSE_WIDGET_COUNT + 31u) / 32u)
+
+/* Action flags */
+#define TOUCH_ACTION_CONTINUOUS     (0x01u)     /* Also dispatch TOUCH_EVENT_MOVE
+                                                 * on every scan while active
+                                                 */
+
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+typedef enum
+{
+    TOUCH_EVENT_PRESS,
+    TOUCH_EVENT_RELEASE,
+    TOUCH_EVENT_MOVE            /* Still active, TOUCH_ACTION_CONTINUOUS only */
+} touch_event_t;
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+typedef struct touch_action touch_action_t;
+
+/* Called from process_touch() in the CapSense task */
+typedef void (*touch_handler_t)(uint32_t widget_id, const touch_action_t *action,
+                                touch_event_t event, void *context);
+
+/* Action of one widget. The action table is indexed by widget ID; widgets
+ * without a handler are not watched.
+ */
+struct touch_action
+{
+    touch_handler_t handler;
+    uint32_t flags;
+    uint32_t param;             /* Handler specific, e.g. an LED command */
+    void *object;               /* Handler specific, e.g. a slider filter */
+};
+
+typedef struct
+{
+    const touch_action_t *actions;
+    uint32_t watched[TOUCH_ENGINE_WORDS];
+    uint32_t continuous[TOUCH_ENGINE_WORDS];
+    uint32_t state[TOUCH_ENGINE_WORDS];     /* Active widgets of the last scan */
+} touch_engine_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void touch_engine_init(touch_engine_t *engine,
+                       const touch_action_t actions[CY_CAPSENSE_WIDGET_COUNT]);
+void touch_engine_process(touch_engine_t *engine,
+                          const cy_stc_capsense_context_t *capsense_context,
+                          void *context);
+
+
+#endif /* SOURCE_TOUCH_ENGINE_H_ */
+
+
+/* [] END OF FILE */
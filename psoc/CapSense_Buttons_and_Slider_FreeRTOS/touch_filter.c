@@ -0,0 +1,268 @@
+/******************************************************************************
+* File Name: touch_filter.c
+*
+* Description: Fixed-point filter between the CapSense slider position and
+*              the LED brightness. Each scan runs
+*
+*              raw position -> percent (Q8) -> median of three -> IIR
+*                -> hysteresis -> brightness
+*
+*              and tracks the speed of the finger, so that a lift-off can be
+*              classified as a swipe or a flick. The scaling from the slider
+*              resolution to percent is a precomputed reciprocal, so the
+*              per-scan path has no divides.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include <string.h>
+#include "touch_filter.h"
+#include "cycle_counter.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define TOUCH_FILTER_ONE_Q8         ((int32_t)1 << TOUCH_FILTER_Q)
+#define TOUCH_FILTER_FULL_Q8        (100 * TOUCH_FILTER_ONE_Q8)
+#define TOUCH_FILTER_HYSTERESIS_Q8  ((int32_t)TOUCH_FILTER_HYSTERESIS_PCT * TOUCH_FILTER_ONE_Q8)
+#define TOUCH_FILTER_FLICK_Q8       ((int32_t)TOUCH_FILTER_FLICK_PCT_PER_SCAN * TOUCH_FILTER_ONE_Q8)
+#define TOUCH_FILTER_SWIPE_Q8       ((int32_t)TOUCH_FILTER_SWIPE_MIN_PCT * TOUCH_FILTER_ONE_Q8)
+
+
+/*******************************************************************************
+* Function Name: touch_filter_init
+********************************************************************************
+* Summary:
+*  Resets the filter and precomputes the position scaling.
+*
+* Parameters:
+*  touch_filter_t *filter       : Filter to initialize
+*  uint16_t resolution          : Largest position the slider reports
+*  touch_filter_stats_t *stats  : Counters of the filter
+*
+*******************************************************************************/
+void touch_filter_init(touch_filter_t *filter, uint16_t resolution,
+                       touch_filter_stats_t *stats)
+{
+    memset(filter, 0, sizeof(*filter));
+    filter->recip_q16 = (uint32_t)(((uint64_t)TOUCH_FILTER_FULL_Q8 << 16) /
+                                   ((0u != resolution) ? resolution : 1u));
+    filter->stats = stats;
+    memset(stats, 0, sizeof(*stats));
+    cycle_counter_init();
+}
+
+
+/*******************************************************************************
+* Function Name: touch_filter_median3
+*******************************************************************************/
+static inline int32_t touch_filter_median3(int32_t a, int32_t b, int32_t c)
+{
+    int32_t lo = (a < b) ? a : b;
+    int32_t hi = (a < b) ? b : a;
+
+    return (c < lo) ? lo : ((c > hi) ? hi : c);
+}
+
+
+/*******************************************************************************
+* Function Name: touch_filter_gesture
+********************************************************************************
+* Summary:
+*  Classifies a touch that has just been lifted. A flick ends at speed, a
+*  swipe covers a long distance in a short time.
+*
+*******************************************************************************/
+static touch_gesture_t touch_filter_gesture(const touch_filter_t *filter)
+{
+    int32_t travel = filter->state_q8 - filter->start_q8;
+
+    if (filter->velocity_q8 >= TOUCH_FILTER_FLICK_Q8)
+    {
+        return TOUCH_GESTURE_FLICK_UP;
+    }
+    if (filter->velocity_q8 <= -TOUCH_FILTER_FLICK_Q8)
+    {
+        return TOUCH_GESTURE_FLICK_DOWN;
+    }
+    if (filter->samples <= TOUCH_FILTER_SWIPE_MAX_SCANS)
+    {
+        if (travel >= TOUCH_FILTER_SWIPE_Q8)
+        {
+            return TOUCH_GESTURE_SWIPE_UP;
+        }
+        if (travel <= -TOUCH_FILTER_SWIPE_Q8)
+        {
+            return TOUCH_GESTURE_SWIPE_DOWN;
+        }
+    }
+    return TOUCH_GESTURE_NONE;
+}
+
+
+/*******************************************************************************
+* Function Name: touch_filter_release
+********************************************************************************
+* Summary:
+*  Ends a touch. A flick moves the brightness to the end of the slider in
+*  its direction.
+*
+* Return:
+*  true if the brightness changed
+*
+*******************************************************************************/
+static bool touch_filter_release(touch_filter_t *filter, touch_filter_output_t *output)
+{
+    touch_gesture_t gesture = touch_filter_gesture(filter);
+
+    filter->samples = 0u;
+    output->gesture = gesture;
+    if (TOUCH_GESTURE_NONE == gesture)
+    {
+        return false;
+    }
+
+    filter->stats->last_gesture = (uint32_t)gesture;
+    if ((TOUCH_GESTURE_SWIPE_UP == gesture) || (TOUCH_GESTURE_SWIPE_DOWN == gesture))
+    {
+        filter->stats->swipes++;
+        return false;
+    }
+
+    filter->stats->flicks++;
+    filter->output_q8 = (TOUCH_GESTURE_FLICK_UP == gesture) ? TOUCH_FILTER_FULL_Q8 : 0;
+    output->brightness = (uint32_t)filter->output_q8 >> TOUCH_FILTER_Q;
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: touch_filter_step
+********************************************************************************
+* Summary:
+*  Filters one touched sample.
+*
+* Return:
+*  true if the brightness changed
+*
+*******************************************************************************/
+static bool touch_filter_step(touch_filter_t *filter, uint16_t position,
+                              touch_filter_output_t *output)
+{
+    int32_t raw_q8 = (int32_t)(((uint64_t)position * filter->recip_q16) >> 16);
+    int32_t in_q8 = raw_q8;
+    int32_t delta;
+
+#if TOUCH_FILTER_MEDIAN
+    if (filter->samples >= 2u)
+    {
+        in_q8 = touch_filter_median3(filter->raw_q8[0], filter->raw_q8[1], raw_q8);
+    }
+    filter->raw_q8[0] = filter->raw_q8[1];
+    filter->raw_q8[1] = raw_q8;
+#endif
+
+    if (0u == filter->samples)
+    {
+        /* Start from the touch-down position, not from the previous touch */
+        filter->state_q8 = in_q8;
+        filter->start_q8 = in_q8;
+        filter->velocity_q8 = 0;
+    }
+    else
+    {
+        int32_t prev_q8 = filter->state_q8;
+
+        filter->state_q8 += (in_q8 - filter->state_q8) >> TOUCH_FILTER_IIR_SHIFT;
+        filter->velocity_q8 += ((filter->state_q8 - prev_q8) - filter->velocity_q8) >> 1;
+    }
+    filter->samples++;
+
+    delta = filter->state_q8 - filter->output_q8;
+    if (filter->reported && (delta < TOUCH_FILTER_HYSTERESIS_Q8) &&
+        (delta > -TOUCH_FILTER_HYSTERESIS_Q8))
+    {
+        return false;
+    }
+
+    filter->reported = true;
+    filter->output_q8 = filter->state_q8;
+    output->brightness = (uint32_t)(filter->state_q8 + (TOUCH_FILTER_ONE_Q8 / 2)) >> TOUCH_FILTER_Q;
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: touch_filter_update
+********************************************************************************
+* Summary:
+*  Runs the filter for one scan.
+*
+* Parameters:
+*  touch_filter_t *filter         : Filter of the slider
+*  bool touched                   : The slider reports a touch
+*  uint16_t position              : Slider position, ignored if not touched
+*  touch_filter_output_t *output  : Receives the brightness and gesture
+*
+* Return:
+*  true if output->brightness holds a new brightness for the LED
+*
+*******************************************************************************/
+bool touch_filter_update(touch_filter_t *filter, bool touched, uint16_t position,
+                         touch_filter_output_t *output)
+{
+    touch_filter_stats_t *stats = filter->stats;
+    uint32_t start = cycle_counter_get();
+    uint32_t cycles;
+    bool changed = false;
+
+    output->gesture = TOUCH_GESTURE_NONE;
+    if (touched)
+    {
+        changed = touch_filter_step(filter, position, output);
+    }
+    else if (0u != filter->samples)
+    {
+        changed = touch_filter_release(filter, output);
+    }
+
+    cycles = cycle_counter_get() - start;
+    stats->samples++;
+    filter->cycles_sum += cycles;
+    if (cycles > stats->cycles_max)
+    {
+        stats->cycles_max = cycles;
+    }
+    if (changed)
+    {
+        stats->reports++;
+    }
+    return changed;
+}
+
+
+/*******************************************************************************
+* Function Name: touch_filter_publish
+********************************************************************************
+* Summary:
+*  Updates the average cost in the filter statistics. touch_filter_update()
+*  only accumulates the cycles, so that the per-scan path has no divides;
+*  call this function whenever the statistics are about to be read.
+*
+*******************************************************************************/
+void touch_filter_publish(touch_filter_t *filter)
+{
+    touch_filter_stats_t *stats = filter->stats;
+
+    stats->cycles_avg = (0u != stats->samples) ?
+                        (uint32_t)(filter->cycles_sum / stats->samples) : 0u;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,131 @@
+/******************************************************************************
+* File Name: touch_filter.h
+*
+* Description: This file is the public interface of touch_filter.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_TOUCH_FILTER_H_
+#define SOURCE_TOUCH_FILTER_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Median-of-three prefilter against single-scan spikes, 0 to disable */
+#ifndef TOUCH_FILTER_MEDIAN
+#define TOUCH_FILTER_MEDIAN             (1u)
+#endif
+
+/* IIR smoothing: each scan moves the output 1/2^SHIFT of the way to the
+ * input; 0 disables smoothing.
+ */
+#ifndef TOUCH_FILTER_IIR_SHIFT
+#define TOUCH_FILTER_IIR_SHIFT          (2u)
+#endif
+
+/* Brightness change in percent required before a new value is reported */
+#ifndef TOUCH_FILTER_HYSTERESIS_PCT
+#define TOUCH_FILTER_HYSTERESIS_PCT     (2u)
+#endif
+
+/* Lift-off speed, in percent per scan, that makes a flick */
+#ifndef TOUCH_FILTER_FLICK_PCT_PER_SCAN
+#define TOUCH_FILTER_FLICK_PCT_PER_SCAN (4u)
+#endif
+
+/* Travel in percent, within TOUCH_FILTER_SWIPE_MAX_SCANS, that makes a swipe */
+#ifndef TOUCH_FILTER_SWIPE_MIN_PCT
+#define TOUCH_FILTER_SWIPE_MIN_PCT      (40u)
+#endif
+
+#ifndef TOUCH_FILTER_SWIPE_MAX_SCANS
+#define TOUCH_FILTER_SWIPE_MAX_SCANS    (100u)
+#endif
+
+/* Positions are handled as percent of the slider length in Q8 */
+#define TOUCH_FILTER_Q                  (8u)
+
+
+/*******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+typedef enum
+{
+    TOUCH_GESTURE_NONE,
+    TOUCH_GESTURE_SWIPE_UP,     /* Towards the end of the slider */
+    TOUCH_GESTURE_SWIPE_DOWN,
+    TOUCH_GESTURE_FLICK_UP,
+    TOUCH_GESTURE_FLICK_DOWN
+} touch_gesture_t;
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Filter statistics, published in the diagnostics map */
+typedef struct
+{
+    uint32_t samples;           /* Scans filtered */
+    uint32_t reports;           /* Brightness changes passed to the LED */
+    uint32_t cycles_avg;        /* Cost of touch_filter_update(), refreshed by
+                                 * touch_filter_publish() */
+    uint32_t cycles_max;
+    uint32_t swipes;
+    uint32_t flicks;
+    uint32_t last_gesture;      /* touch_gesture_t */
+} touch_filter_stats_t;
+
+/* State of one slider. recip_q16 scales a raw position to percent in Q8 with
+ * one multiplication; it is the only value derived with a divide.
+ */
+typedef struct
+{
+    uint32_t recip_q16;
+    int32_t raw_q8[2];          /* Previous two samples of the median */
+    int32_t state_q8;           /* Smoothed position */
+    int32_t velocity_q8;        /* Smoothed speed, per scan */
+    int32_t output_q8;          /* Last reported position */
+    int32_t start_q8;           /* Position at touch-down */
+    uint32_t samples;           /* Scans since touch-down */
+    bool reported;
+    uint64_t cycles_sum;
+    touch_filter_stats_t *stats;
+} touch_filter_t;
+
+/* Result of one scan */
+typedef struct
+{
+    uint32_t brightness;        /* Percent, valid when update returns true */
+    touch_gesture_t gesture;    /* Gesture completed by this scan */
+} touch_filter_output_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void touch_filter_init(touch_filter_t *filter, uint16_t resolution,
+                       touch_filter_stats_t *stats);
+bool touch_filter_update(touch_filter_t *filter, bool touched, uint16_t position,
+                         touch_filter_output_t *output);
+void touch_filter_publish(touch_filter_t *filter);
+
+
+#endif /* SOURCE_TOUCH_FILTER_H_ */
+
+
+/* [] END OF FILE */
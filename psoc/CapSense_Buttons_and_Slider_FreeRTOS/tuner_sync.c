@@ -0,0 +1,307 @@
+/******************************************************************************
+* File Name: tuner_sync.c
+*
+* Description: CapSense Tuner synchronization at TUNER_SYNC_HZ in a task of
+*              its own, instead of Cy_CapSense_RunTuner() after every frame.
+*
+*              The EzI2C slave of the Tuner serves tuner_sync_host_view, a
+*              copy of cy_capsense_tuner, rather than the live data the
+*              middleware works on. The two tasks exchange data through a
+*              transfer buffer that only one of them owns at a time, so
+*              neither waits for the other:
+*
+*              - task_tuner, while it owns the buffer, refreshes the view
+*                from the snapshot in the buffer and moves the bytes the
+*                host has written to the view into the buffer, marking them
+*                in a map. It then hands the buffer to task_capsense.
+*              - task_capsense, at the end of the next frame, applies the
+*                marked bytes to the live data, runs Cy_CapSense_RunTuner()
+*                to act on Tuner commands, copies the live data into the
+*                buffer and hands it back.
+*
+*              The view therefore always holds the data of one complete
+*              frame, host writes reach the live data only between frames,
+*              and a frame never waits for the host or for task_tuner. The
+*              view is compared in chunks of TUNER_SYNC_CHUNK_BYTES with
+*              only the EzI2C interrupt masked. While the Tuner has
+*              suspended scanning, the middleware keeps calling the receive
+*              callback, which applies the host's writes directly, so the
+*              resume command is seen.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/******************************************************************************
+* Header files includes
+******************************************************************************/
+#include "tuner_sync.h"
+
+#if APP_TUNER_SYNC
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cycle_counter.h"
+#include "diag_i2c.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define TUNER_SYNC_SIZE             (sizeof(cy_stc_capsense_tuner_t))
+#define TUNER_SYNC_DIRTY_WORDS      ((TUNER_SYNC_SIZE + 31u) / 32u)
+
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+/* Buffer of the Tuner's EzI2C slave */
+cy_stc_capsense_tuner_t tuner_sync_host_view;
+
+/* The view as last refreshed; a byte that differs from the view was written
+ * by the host.
+ */
+static cy_stc_capsense_tuner_t tuner_sync_published;
+
+/* Snapshot of the live data from task_capsense, and the host's writes to it
+ * from task_tuner, with a bit set in tuner_sync_dirty for each written byte
+ */
+static cy_stc_capsense_tuner_t tuner_sync_transfer;
+static uint32_t tuner_sync_dirty[TUNER_SYNC_DIRTY_WORDS];
+
+/* Owner of the transfer buffer: task_capsense while true, task_tuner while
+ * false. Each task only ever flips it to hand the buffer over.
+ */
+static volatile bool tuner_sync_requested;
+
+/* Interrupt of the EzI2C slave that writes the view */
+static IRQn_Type tuner_sync_irqn;
+
+/* Calls of the receive callback by the current Cy_CapSense_RunTuner() */
+static uint32_t tuner_sync_receive_calls;
+
+
+/*******************************************************************************
+* Function Name: tuner_sync_refresh_view
+********************************************************************************
+* Summary:
+*  Refreshes the host view from a copy of the CapSense data, except for the
+*  bytes the host has written since the previous refresh. Those are copied
+*  into the source instead and are refreshed on the next call. The view is
+*  processed in chunks with the EzI2C interrupt masked, so that no host write
+*  falls between the comparison and the refresh of a byte.
+*
+* Parameters:
+*  uint8_t *source   : Copy the view is refreshed from; receives the bytes
+*                      written by the host
+*  uint32_t *dirty   : Map in which the written bytes are marked, or NULL
+*
+* Return:
+*  Number of bytes written by the host
+*
+*******************************************************************************/
+static uint32_t tuner_sync_refresh_view(uint8_t *source, uint32_t *dirty)
+{
+    uint8_t *view = (uint8_t *)&tuner_sync_host_view;
+    uint8_t *published = (uint8_t *)&tuner_sync_published;
+    uint32_t host_bytes = 0u;
+    uint32_t end;
+
+    for (uint32_t chunk = 0u; chunk < TUNER_SYNC_SIZE; chunk = end)
+    {
+        end = chunk + TUNER_SYNC_CHUNK_BYTES;
+        if (end > TUNER_SYNC_SIZE)
+        {
+            end = TUNER_SYNC_SIZE;
+        }
+
+        NVIC_DisableIRQ(tuner_sync_irqn);
+        for (uint32_t i = chunk; i < end; i++)
+        {
+            if (view[i] != published[i])
+            {
+                source[i] = view[i];
+                published[i] = view[i];
+                if (NULL != dirty)
+                {
+                    dirty[i / 32u] |= 1uL << (i % 32u);
+                }
+                host_bytes++;
+            }
+            else
+            {
+                view[i] = source[i];
+                published[i] = source[i];
+            }
+        }
+        NVIC_EnableIRQ(tuner_sync_irqn);
+    }
+    return host_bytes;
+}
+
+
+/*******************************************************************************
+* Function Name: tuner_sync_receive
+********************************************************************************
+* Summary:
+*  Tuner receive callback of the middleware, called on every pass of
+*  Cy_CapSense_RunTuner(). The host writes straight into the view, so there
+*  is no command packet to hand over. The first pass finds the host's writes
+*  already applied by tuner_sync_frame(); further passes only happen while
+*  the Tuner has suspended scanning, and apply the writes directly once per
+*  sync period.
+*
+*******************************************************************************/
+static void tuner_sync_receive(uint8_t **commandPacket, uint8_t **tunerPacket,
+                               cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    *commandPacket = NULL;
+    *tunerPacket = NULL;
+    if (0u != tuner_sync_receive_calls++)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1000u / TUNER_SYNC_HZ));
+        diag_i2c_map.tuner_sync.host_bytes +=
+            tuner_sync_refresh_view((uint8_t *)&cy_capsense_tuner, NULL);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: tuner_sync_init
+********************************************************************************
+* Summary:
+*  Publishes the synchronization rate. Called before the scheduler starts.
+*
+*******************************************************************************/
+void tuner_sync_init(void)
+{
+    diag_i2c_map.tuner_sync.rate_hz = TUNER_SYNC_HZ;
+}
+
+
+/*******************************************************************************
+* Function Name: tuner_sync_start
+********************************************************************************
+* Summary:
+*  Publishes the initialized CapSense data and hooks the tuner into the
+*  middleware. Called by task_capsense after Cy_CapSense_Init().
+*
+* Parameters:
+*  IRQn_Type ezi2c_irqn : Interrupt of the EzI2C slave serving the view
+*
+*******************************************************************************/
+void tuner_sync_start(IRQn_Type ezi2c_irqn)
+{
+    tuner_sync_irqn = ezi2c_irqn;
+    cy_capsense_context.ptrInternalContext->ptrTunerReceiveCallback = tuner_sync_receive;
+
+    NVIC_DisableIRQ(tuner_sync_irqn);
+    memcpy(&tuner_sync_host_view, &cy_capsense_tuner, TUNER_SYNC_SIZE);
+    memcpy(&tuner_sync_published, &cy_capsense_tuner, TUNER_SYNC_SIZE);
+    NVIC_EnableIRQ(tuner_sync_irqn);
+    memcpy(&tuner_sync_transfer, &cy_capsense_tuner, TUNER_SYNC_SIZE);
+}
+
+
+/*******************************************************************************
+* Function Name: tuner_sync_frame
+********************************************************************************
+* Summary:
+*  Serves a pending synchronization between two frames: applies the host's
+*  writes to the live data, runs the Tuner and takes a snapshot for the
+*  view. Called by task_capsense at the end of every frame; returns at once
+*  if task_tuner has not requested a synchronization.
+*
+*******************************************************************************/
+void tuner_sync_frame(void)
+{
+    tuner_sync_stats_t *stats = &diag_i2c_map.tuner_sync;
+    const uint8_t *transfer = (const uint8_t *)&tuner_sync_transfer;
+    uint8_t *live = (uint8_t *)&cy_capsense_tuner;
+    uint32_t start;
+    uint32_t sync_us;
+    uint32_t bits;
+
+    if (!tuner_sync_requested)
+    {
+        return;
+    }
+    __DMB();
+    start = cycle_counter_get();
+
+    for (uint32_t word = 0u; word < TUNER_SYNC_DIRTY_WORDS; word++)
+    {
+        bits = tuner_sync_dirty[word];
+        tuner_sync_dirty[word] = 0u;
+        for (uint32_t bit = 0u; 0u != bits; bit++, bits >>= 1u)
+        {
+            if (0u != (bits & 1u))
+            {
+                live[(word * 32u) + bit] = transfer[(word * 32u) + bit];
+            }
+        }
+    }
+
+    /* Establishes synchronized operation between the CapSense
+     * middleware and the CapSense Tuner tool.
+     */
+    tuner_sync_receive_calls = 0u;
+    Cy_CapSense_RunTuner(&cy_capsense_context);
+
+    memcpy(&tuner_sync_transfer, live, TUNER_SYNC_SIZE);
+    __DMB();
+    tuner_sync_requested = false;
+
+    sync_us = cycle_counter_to_us(cycle_counter_get() - start);
+    stats->syncs++;
+    if (sync_us > stats->sync_us_max)
+    {
+        stats->sync_us_max = sync_us;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: task_tuner
+********************************************************************************
+* Summary:
+*  Low-priority task that synchronizes with the Tuner at TUNER_SYNC_HZ.
+*
+* Parameters:
+*  void *param : Task parameter defined during task creation (unused)
+*
+*******************************************************************************/
+void task_tuner(void *param)
+{
+    tuner_sync_stats_t *stats = &diag_i2c_map.tuner_sync;
+    TickType_t wake = xTaskGetTickCount();
+
+    (void)param;
+
+    for (;;)
+    {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(1000u / TUNER_SYNC_HZ));
+
+        /* No frame has completed since the previous request */
+        if (tuner_sync_requested)
+        {
+            stats->late_syncs++;
+            continue;
+        }
+        __DMB();
+
+        stats->host_bytes += tuner_sync_refresh_view((uint8_t *)&tuner_sync_transfer,
+                                                     tuner_sync_dirty);
+        __DMB();
+        tuner_sync_requested = true;
+    }
+}
+
+#endif /* APP_TUNER_SYNC */
+
+
+/* [] END OF FILE */
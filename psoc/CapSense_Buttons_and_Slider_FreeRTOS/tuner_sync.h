@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name: tuner_sync.h
+*
+* Description: This file is the public interface of tuner_sync.c source
+*              file.
+*
+* Related Document: README.md
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+ *  Include guard
+ ******************************************************************************/
+#ifndef SOURCE_TUNER_SYNC_H_
+#define SOURCE_TUNER_SYNC_H_
+
+
+/*******************************************************************************
+ * Header file includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_config.h"
+#include "cybsp.h"
+#include "cycfg_capsense.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Rate at which the Tuner's view of the CapSense data is refreshed */
+#ifndef TUNER_SYNC_HZ
+#define TUNER_SYNC_HZ               (16u)
+#endif
+
+/* Bytes of the host view compared and refreshed per masking of the EzI2C
+ * interrupt; bounds the time a host transfer is stalled.
+ */
+#ifndef TUNER_SYNC_CHUNK_BYTES
+#define TUNER_SYNC_CHUNK_BYTES      (64u)
+#endif
+
+
+/*******************************************************************************
+ * Data structure
+ ******************************************************************************/
+/* Tuner synchronization counters, published in the diagnostics map */
+typedef struct
+{
+    uint32_t rate_hz;               /* TUNER_SYNC_HZ, 0 if disabled */
+    uint32_t syncs;
+    uint32_t host_bytes;            /* Bytes written by the host and applied */
+    uint32_t late_syncs;            /* Periods skipped because no frame had
+                                     * served the previous request yet */
+    uint32_t sync_us_max;           /* Longest exchange between two frames */
+} tuner_sync_stats_t;
+
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+#if APP_TUNER_SYNC
+extern cy_stc_capsense_tuner_t tuner_sync_host_view;
+
+void tuner_sync_init(void);
+void tuner_sync_start(IRQn_Type ezi2c_irqn);
+void tuner_sync_frame(void);
+void task_tuner(void *param);
+
+/* RAM of the host view, the copy it is compared against, the buffer handed
+ * between the tasks and its map of bytes written by the host
+ */
+#define TUNER_SYNC_RAM_BYTES        ((3u * sizeof(cy_stc_capsense_tuner_t)) + \
+                                     (((sizeof(cy_stc_capsense_tuner_t) + 31u) / 32u) * 4u))
+
+#define TUNER_SYNC_INIT()           tuner_sync_init()
+#define TUNER_SYNC_START(irqn)      tuner_sync_start(irqn)
+#define TUNER_SYNC_BUFFER()         (&tuner_sync_host_view)
+#define TUNER_SYNC_FRAME()          tuner_sync_frame()
+#else
+#define TUNER_SYNC_RAM_BYTES        (0u)
+
+#define TUNER_SYNC_INIT()
+#define TUNER_SYNC_START(irqn)
+#define TUNER_SYNC_BUFFER()         (&cy_capsense_tuner)
+#define TUNER_SYNC_FRAME()
+#endif
+
+
+#endif /* SOURCE_TUNER_SYNC_H_ */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,274 @@
+"""Rolling aggregates of the ingested samples, per metric of ingest.METRICS.
+
+Every sample is folded into one bucket per resolution (1 minute, 1 hour,
+1 day). A bucket holds count, mean, the sum of squared deviations from the
+mean (M2), min and max, so adding a sample or merging two buckets is O(1)
+and the variance stays exact without keeping the samples (Welford / Chan
+et al.). Samples of a batch are grouped per bucket with numpy first, so a
+batch costs one merge per bucket it touches, not per sample.
+
+A query over [start, end) is answered from buckets only: whole days in the
+middle, whole hours and minutes at the edges. Its cost depends on the
+length of the range, not on the number of samples behind it.
+
+Minute and hour buckets are kept for a limited time (RETENTION). Edges of a
+range older than that are covered by the enclosing coarser bucket, so the
+span actually covered is returned with every result.
+
+The aggregates follow the ingest log directory rather than the requests of
+one process: follow() reads the blocks appended since its last call to any
+segment, so every gunicorn worker sees the samples all workers ingested,
+and a restarted worker rebuilds its aggregates from the log. follow_every()
+runs it from a background thread, off the path of the ingest requests.
+"""
+import os
+import threading
+import time
+
+import numpy as np
+
+import ingest
+
+MINUTE = 60 * 1000000
+HOUR = 60 * MINUTE
+DAY = 24 * HOUR
+
+# Bucket width -> how long its buckets are kept (None: forever)
+RESOLUTIONS = (MINUTE, HOUR, DAY)
+RETENTION = {MINUTE: 2 * DAY, HOUR: 400 * DAY, DAY: None}
+
+# Bucket fields: count, mean, M2, min, max
+COUNT, MEAN, M2, MIN, MAX = range(5)
+
+
+def merge(into, other):
+    """Fold the bucket other into the bucket into (both lists of fields)."""
+    count = into[COUNT] + other[COUNT]
+    delta = other[MEAN] - into[MEAN]
+    into[MEAN] += delta * other[COUNT] / count
+    into[M2] += other[M2] + delta * delta * into[COUNT] * other[COUNT] / count
+    into[COUNT] = count
+    into[MIN] = min(into[MIN], other[MIN])
+    into[MAX] = max(into[MAX], other[MAX])
+
+
+def summary(bucket, start, end):
+    count = bucket[COUNT] if bucket else 0
+    return {
+        'start': start,
+        'end': end,
+        'count': count,
+        'mean': bucket[MEAN] if count else None,
+        # Sample variance, as pandas computes it
+        'variance': bucket[M2] / (count - 1) if count > 1 else None,
+        'min': bucket[MIN] if count else None,
+        'max': bucket[MAX] if count else None,
+    }
+
+
+class Rollup:
+    def __init__(self):
+        self._lock = threading.Lock()
+        # Resolution -> metric -> bucket number (start // width) -> fields.
+        # Numbers, not start times: those are multiples of the width, whose
+        # equal low bits make dict lookups collide more often
+        self._buckets = {width: [{} for _ in ingest.METRICS] for width in RESOLUTIONS}
+        # Resolution -> start of the oldest bucket still kept
+        self._kept_from = {width: None for width in RESOLUTIONS}
+        self._oldest = None
+        self._newest = None
+        self._offsets = {}
+        self._follow_lock = threading.Lock()
+        self._follower_pid = None
+
+    def add(self, timestamps, metrics, values):
+        """Fold samples given as columns (any buffer of int64 timestamps,
+        uint16 metrics and float64 values) into the buckets. NaN values
+        are skipped."""
+        timestamps = np.asarray(timestamps, dtype=np.int64)
+        metrics = np.asarray(metrics, dtype=np.int64)
+        values = np.asarray(values, dtype=np.float64)
+        present = ~np.isnan(values)
+        if not present.all():
+            timestamps, metrics, values = timestamps[present], metrics[present], values[present]
+        if not len(values):
+            return
+
+        groups = {width: self._group(timestamps, metrics, values, width) for width in RESOLUTIONS}
+        with self._lock:
+            oldest, newest = int(timestamps.min()), int(timestamps.max())
+            if self._oldest is None or oldest < self._oldest:
+                self._oldest = oldest
+            if self._newest is None or newest > self._newest:
+                self._newest = newest
+            for width in RESOLUTIONS:
+                kept_from = self._kept_from[width]
+                buckets = self._buckets[width]
+                created = False
+                for metric, start, bucket in groups[width]:
+                    if kept_from is not None and start < kept_from:
+                        continue  # Late sample, older than this resolution keeps
+                    existing = buckets[metric].get(start // width)
+                    if existing is None:
+                        buckets[metric][start // width] = bucket
+                        created = True
+                    else:
+                        merge(existing, bucket)
+                if created:
+                    self._prune(width)
+
+    @staticmethod
+    def _group(timestamps, metrics, values, width):
+        """Aggregates samples per (metric, bucket): [(metric, start, fields)]."""
+        keys = (timestamps // width) * len(ingest.METRICS) + metrics
+        order = np.argsort(keys, kind='stable')
+        keys, values = keys[order], values[order]
+        firsts = np.flatnonzero(np.r_[True, keys[1:] != keys[:-1]])
+        counts = np.diff(np.r_[firsts, len(keys)])
+        means = np.add.reduceat(values, firsts) / counts
+        m2s = np.add.reduceat((values - np.repeat(means, counts)) ** 2, firsts)
+        mins = np.minimum.reduceat(values, firsts)
+        maxs = np.maximum.reduceat(values, firsts)
+        group_keys = keys[firsts]
+        starts = group_keys // len(ingest.METRICS) * width
+        group_metrics = group_keys % len(ingest.METRICS)
+        return [(int(metric), int(start), [int(count), float(mean), float(m2), float(low), float(high)])
+                for metric, start, count, mean, m2, low, high
+                in zip(group_metrics, starts, counts, means, m2s, mins, maxs)]
+
+    def _prune(self, width):
+        if RETENTION[width] is None:
+            return
+        kept_from = (self._newest - RETENTION[width]) // width * width
+        if self._kept_from[width] is not None and kept_from <= self._kept_from[width]:
+            return
+        previous, self._kept_from[width] = self._kept_from[width], kept_from
+        for buckets in self._buckets[width]:
+            if previous is not None and (kept_from - previous) // width < len(buckets):
+                # Only the buckets that just fell out: O(1) per bucket
+                for number in range(previous // width, kept_from // width):
+                    buckets.pop(number, None)
+            else:
+                for number in [number for number in buckets if number < kept_from // width]:
+                    del buckets[number]
+
+    def follow(self, directory):
+        """Add the blocks appended to the segments of directory since the
+        last call. Returns the number of samples added; returns 0 at once if
+        another thread is already catching up."""
+        if not self._follow_lock.acquire(blocking=False):
+            return 0
+        try:
+            added = 0
+            try:
+                names = sorted(name for name in os.listdir(directory) if name.endswith('.log'))
+            except FileNotFoundError:
+                return 0
+            for name in names:
+                path = os.path.join(directory, name)
+                offset = self._offsets.get(name, 0)
+                if os.path.getsize(path) <= offset:
+                    continue
+                with open(path, 'rb') as file:
+                    file.seek(offset)
+                    data = file.read()
+                end = 0
+                for block, end in ingest.read_blocks(data):
+                    self.add(block['timestamps'], block['metrics'], block['values'])
+                    added += len(block['values'])
+                # A partly written block is read again next time
+                self._offsets[name] = offset + end
+            return added
+        finally:
+            self._follow_lock.release()
+
+    def follow_every(self, directory, interval):
+        """Keep following directory from a daemon thread, every interval
+        seconds. The thread is started by the first call in each process:
+        with gunicorn --preload the app is created before the workers fork,
+        and threads do not survive a fork."""
+        with self._lock:
+            if self._follower_pid == os.getpid():
+                return
+            self._follower_pid = os.getpid()
+
+        def run():
+            while True:
+                self.follow(directory)
+                time.sleep(interval)
+
+        threading.Thread(target=run, name='rollup-follower', daemon=True).start()
+
+    def _plan(self, start, end):
+        """Buckets covering [start, end): [(width, bucket start)]. Whole
+        coarse buckets in the middle, finer ones at the edges; an edge
+        older than the finer resolution keeps is covered by the enclosing
+        coarse bucket. The range is first cut to the days that hold
+        samples, so the plan stays as long as the history at most, whatever
+        range a client asks for."""
+        plan = []
+        with self._lock:
+            if self._newest is None:
+                return plan
+            kept_from = dict(self._kept_from)
+            start = max(start, self._oldest // DAY * DAY)
+            end = min(end, (self._newest // DAY + 1) * DAY)
+
+        def cover(low, high, level):
+            width = RESOLUTIONS[level]
+            if level == 0:
+                plan.extend((width, bucket) for bucket in
+                            range(low // width * width, high, width))
+                return
+            first = -(-low // width) * width
+            last = high // width * width
+            finer_kept_from = kept_from[RESOLUTIONS[level - 1]]
+            if first >= last:
+                first = last = low  # No whole bucket: all of it is edge
+            for edge_low, edge_high in ((low, first), (last, high)):
+                if edge_low >= edge_high:
+                    continue
+                if finer_kept_from is not None and edge_low < finer_kept_from:
+                    plan.append((width, edge_low // width * width))
+                else:
+                    cover(edge_low, edge_high, level - 1)
+            plan.extend((width, bucket) for bucket in range(first, last, width))
+
+        if start < end:
+            cover(start, end, len(RESOLUTIONS) - 1)
+        return sorted(set(plan), key=lambda item: item[1])
+
+    def query(self, metric, start, end):
+        """Aggregates of metric (name or index) over [start, end), times in
+        microseconds since the epoch: a dict of count, mean, variance, min,
+        max and the start and end actually covered."""
+        metric = ingest.METRIC_IDS[metric] if isinstance(metric, str) else metric
+        plan = self._plan(start, end)
+        total = None
+        with self._lock:
+            for width, bucket_start in plan:
+                bucket = self._buckets[width][metric].get(bucket_start // width)
+                if bucket is None:
+                    continue
+                if total is None:
+                    total = list(bucket)
+                else:
+                    merge(total, bucket)
+        if not plan:
+            return summary(None, start, end)
+        return summary(total, min(start, plan[0][1]),
+                       max(end, max(bucket + width for width, bucket in plan)))
+
+    def series(self, metric, width, start, end):
+        """Aggregates of metric per bucket of the given width in [start,
+        end), oldest first; buckets without samples are left out."""
+        metric = ingest.METRIC_IDS[metric] if isinstance(metric, str) else metric
+        with self._lock:
+            buckets = self._buckets[width][metric]
+            first, last = start // width, -(-end // width)
+            if last - first < len(buckets):
+                numbers = [number for number in range(first, last) if number in buckets]
+            else:
+                numbers = sorted(number for number in buckets if first <= number < last)
+            return [summary(buckets[number], number * width, (number + 1) * width)
+                    for number in numbers]